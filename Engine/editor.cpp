@@ -1,10 +1,12 @@
 #include "Engine/editor.hpp"
+#include "Engine/util/profiler.hpp"
 
 Editor::Editor(SDL_Window* w, GameMain* g, float& width)
     : window(w), game(g), editorWidth(width), viewportTexture(0), viewportTexW(0), viewportTexH(0),
       viewportHovered(false), viewportMouseU(0.0f), viewportMouseV(0.0f), viewportMouseDown(false),
       currentProjectPath(""), selectedFile(""), objectCount(0), renaming(false),
-      showBuildWindow(false), sceneFiles(), sceneSel(), buildMessage(), invokeCMakeBuild(true), selectedFolder()
+      showBuildWindow(false), sceneFiles(), sceneSel(), buildMessage(), invokeCMakeBuild(true), showProfiler(false), showRenderStats(false), selectedFolder(),
+      lastAutosaveTicks(0)
 {
     // initialize arrays
     pos[0]=pos[1]=pos[2]=0.0f;
@@ -44,6 +46,8 @@ void Editor::Update() {
 
     ImGui::End();
 
+    Autosave();
+
     ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
     ImGui::Begin("Viewport", NULL, ImGuiWindowFlags_NoCollapse);
     ImGui::PopStyleVar();
@@ -102,6 +106,17 @@ void Editor::Update() {
             glShaderType = 1;
             std::cerr << "[Editor] Shader mode switched to: UNLIT" << std::endl;
         }
+
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(150.0f);
+        Shadow::Quality& quality = game->scene->shadowQuality;
+        if (ImGui::BeginCombo("shadows", Shadow::qualityName(quality))) {
+            for (int q = Shadow::HARD; q <= Shadow::POISSON_ROTATED; ++q) {
+                if (ImGui::Selectable(Shadow::qualityName((Shadow::Quality)q), q == quality))
+                    quality = (Shadow::Quality)q;
+            }
+            ImGui::EndCombo();
+        }
     }
     ImGui::EndChild();
 
@@ -161,6 +176,9 @@ void Editor::MainMenu() {
             }
             if (ImGui::MenuItem("Save Scene")) SaveScene();
             if (ImGui::MenuItem("Load Scene")) LoadScene();
+            if (ImGui::MenuItem("Recover Autosave", NULL, false, !currentProjectPath.empty())) {
+                game->scene->recoverAutosave(currentProjectPath + "/scene.gscene.autosave");
+            }
 
             // Build entry
             if (ImGui::MenuItem("Build")) {
@@ -169,9 +187,19 @@ void Editor::MainMenu() {
 
             ImGui::EndMenu();
         }
+        if (ImGui::BeginMenu("View")) {
+            ImGui::MenuItem("Profiler", NULL, &showProfiler);
+            ImGui::MenuItem("Render Stats", NULL, &showRenderStats);
+            ImGui::EndMenu();
+        }
+
+        if (game->scene->isSaving()) ImGui::TextDisabled("Saving...");
     }
     ImGui::EndMainMenuBar();
 
+    if (showProfiler) Profiler::drawWindow(&showProfiler);
+    if (showRenderStats) RenderStats::drawWindow(&showRenderStats);
+
     if (showBuildWindow) {
         ImGui::SetNextWindowSize(ImVec2(520, 420), ImGuiCond_FirstUseEver);
         if (ImGui::Begin("Build Game", &showBuildWindow)) {
@@ -365,13 +393,16 @@ void Editor::EditorGUI() {
             rot[0]=obj->rotation.x; rot[1]=obj->rotation.y; rot[2]=obj->rotation.z;
             scale[0] = obj->scale.x; scale[1] = obj->scale.y; scale[2] = obj->scale.z;
 
-            ImGui::InputFloat3("Position", pos, "%.2f");
-            ImGui::InputFloat3("Rotation", rot, "%.2f");
-            ImGui::InputFloat3("Scale", scale, "%.2f");
+            bool edited = false;
+            edited |= ImGui::InputFloat3("Position", pos, "%.2f");
+            edited |= ImGui::InputFloat3("Rotation", rot, "%.2f");
+            edited |= ImGui::InputFloat3("Scale", scale, "%.2f");
+            edited |= ImGui::Checkbox("Static", &obj->isStatic);
 
             obj->position = Vec3d(pos[0],pos[1],pos[2]);
             obj->rotation = Vec3d(rot[0],rot[1],rot[2]);
             obj->scale = Vec3d(scale[0],scale[1],scale[2]);
+            if (edited) obj->markDirty();
         }
 
         if (ImGui::CollapsingHeader("Texture", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -424,7 +455,7 @@ void Editor::SceneGUI() {
             strcpy(nameBuffer, obj->name.c_str());
             if (ImGui::InputText("##rename", nameBuffer, IM_ARRAYSIZE(nameBuffer),
                                  ImGuiInputTextFlags_EnterReturnsTrue)) {
-                obj->name = std::string(nameBuffer);
+                game->scene->renameObject(obj, nameBuffer);
                 renaming = false;
             }
         } else {
@@ -598,7 +629,16 @@ void Editor::ProjectGUI() {
 
 
 void Editor::SaveScene() { 
-    game->scene->saveScene(currentProjectPath+"/scene.gscene");
+    game->scene->saveSceneAsync(currentProjectPath+"/scene.gscene");
+}
+
+// Only the snapshot is taken here; the journal is diffed and written on the saver thread.
+void Editor::Autosave() {
+    if (currentProjectPath.empty()) return;
+    Uint32 now = SDL_GetTicks();
+    if (now - lastAutosaveTicks < AUTOSAVE_INTERVAL_MS) return;
+    lastAutosaveTicks = now;
+    game->scene->autosaveScene(currentProjectPath + "/scene.gscene.autosave");
 }
 void Editor::LoadScene() {
     game->scene->loadScene(currentProjectPath+"/scene.gscene");
@@ -0,0 +1,203 @@
+#include "Engine/gizmos/debugDraw.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+struct DebugVertex {
+    float pos[3];
+    float color[3];
+};
+
+struct DebugPoint {
+    DebugVertex v;
+    float size;
+};
+
+struct DebugDrawState {
+    std::vector<DebugVertex> triangles;
+    std::vector<DebugVertex> lines;
+    std::vector<DebugPoint> points;
+    std::vector<DebugVertex> pointVerts; // points sorted by size, rebuilt in flush()
+
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    size_t capacity = 0; // bytes allocated for vbo
+};
+
+DebugDrawState& state() {
+    static DebugDrawState s;
+    return s;
+}
+
+DebugVertex makeVertex(const Vec3d& p, const Vec3d& color) {
+    DebugVertex v;
+    v.pos[0] = (float)p.x;     v.pos[1] = (float)p.y;     v.pos[2] = (float)p.z;
+    v.color[0] = (float)color.x; v.color[1] = (float)color.y; v.color[2] = (float)color.z;
+    return v;
+}
+
+// Any unit vector perpendicular to dir.
+Vec3d perpendicular(const Vec3d& dir) {
+    Vec3d up(0, 1, 0);
+    if (fabs(dir.dot(up)) > 0.99f) up = Vec3d(1, 0, 0);
+    return dir.cross(up).normalized();
+}
+
+bool smallerPoint(const DebugPoint& a, const DebugPoint& b) { return a.size < b.size; }
+
+} // namespace
+
+void DebugDraw::init() {
+    DebugDrawState& s = state();
+    if (s.vao != 0) return;
+
+    glGenVertexArrays(1, &s.vao);
+    glGenBuffers(1, &s.vbo);
+    glBindVertexArray(s.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, s.vbo);
+    // attribute locations are fixed by Shaderc (aPos = 0, aColor = 1)
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, pos));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, color));
+    glBindVertexArray(0);
+}
+
+void DebugDraw::shutdown() {
+    DebugDrawState& s = state();
+    if (s.vbo) glDeleteBuffers(1, &s.vbo);
+    if (s.vao) glDeleteVertexArrays(1, &s.vao);
+    s.vao = s.vbo = 0;
+    s.capacity = 0;
+    clear();
+}
+
+void DebugDraw::line(const Vec3d& a, const Vec3d& b, const Vec3d& color) {
+    DebugDrawState& s = state();
+    s.lines.push_back(makeVertex(a, color));
+    s.lines.push_back(makeVertex(b, color));
+}
+
+void DebugDraw::arrow(const Vec3d& from, const Vec3d& to, const Vec3d& color, float headSize) {
+    line(from, to, color);
+
+    Vec3d delta = to - from;
+    float len = delta.length();
+    if (len <= 0.0f) return;
+    Vec3d dir = delta * (1.0f / len);
+    Vec3d side = perpendicular(dir);
+    Vec3d up = side.cross(dir).normalized();
+
+    float head = std::min(headSize, len);
+    Vec3d base = to - dir * head;
+    float r = head * 0.5f;
+    line(to, base + side * r, color);
+    line(to, base - side * r, color);
+    line(to, base + up * r, color);
+    line(to, base - up * r, color);
+}
+
+void DebugDraw::billboard(const Vec3d& start, const Vec3d& end, float thickness, const Vec3d& color) {
+    Vec3d axis = (end - start).normalized();
+    Vec3d offset = perpendicular(axis) * (thickness * 0.5f);
+
+    Vec3d v0 = start - offset;
+    Vec3d v1 = start + offset;
+    Vec3d v2 = end + offset;
+    Vec3d v3 = end - offset;
+
+    DebugDrawState& s = state();
+    s.triangles.push_back(makeVertex(v0, color));
+    s.triangles.push_back(makeVertex(v1, color));
+    s.triangles.push_back(makeVertex(v2, color));
+    s.triangles.push_back(makeVertex(v2, color));
+    s.triangles.push_back(makeVertex(v3, color));
+    s.triangles.push_back(makeVertex(v0, color));
+}
+
+void DebugDraw::point(const Vec3d& p, const Vec3d& color, float size) {
+    DebugPoint pt;
+    pt.v = makeVertex(p, color);
+    pt.size = size;
+    state().points.push_back(pt);
+}
+
+void DebugDraw::wireBox(const Vec3d& min, const Vec3d& max, const Vec3d& color) {
+    Vec3d c[8] = {
+        Vec3d(min.x, min.y, min.z), Vec3d(max.x, min.y, min.z),
+        Vec3d(max.x, max.y, min.z), Vec3d(min.x, max.y, min.z),
+        Vec3d(min.x, min.y, max.z), Vec3d(max.x, min.y, max.z),
+        Vec3d(max.x, max.y, max.z), Vec3d(min.x, max.y, max.z)
+    };
+    for (int i = 0; i < 4; ++i) {
+        line(c[i], c[(i + 1) % 4], color);         // bottom face
+        line(c[i + 4], c[(i + 1) % 4 + 4], color); // top face
+        line(c[i], c[i + 4], color);               // verticals
+    }
+}
+
+void DebugDraw::clear() {
+    DebugDrawState& s = state();
+    s.triangles.clear();
+    s.lines.clear();
+    s.points.clear();
+}
+
+size_t DebugDraw::queuedVertices() {
+    DebugDrawState& s = state();
+    return s.triangles.size() + s.lines.size() + s.points.size();
+}
+
+void DebugDraw::flush(GLuint shaderProgram, const Mat4& view, const Mat4& projection) {
+    DebugDrawState& s = state();
+    if (queuedVertices() == 0) return;
+    init();
+
+    // points are grouped by size so each distinct glPointSize is one draw
+    std::sort(s.points.begin(), s.points.end(), smallerPoint);
+    s.pointVerts.clear();
+    for (size_t i = 0; i < s.points.size(); ++i) s.pointVerts.push_back(s.points[i].v);
+
+    const size_t triBytes = s.triangles.size() * sizeof(DebugVertex);
+    const size_t lineBytes = s.lines.size() * sizeof(DebugVertex);
+    const size_t pointBytes = s.pointVerts.size() * sizeof(DebugVertex);
+    const size_t needed = triBytes + lineBytes + pointBytes;
+
+    glBindVertexArray(s.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, s.vbo);
+    // Re-specifying the store every frame orphans last frame's data instead of waiting on it.
+    if (needed > s.capacity) s.capacity = std::max(needed, s.capacity * 2);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)s.capacity, NULL, GL_STREAM_DRAW);
+    if (triBytes) glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)triBytes, &s.triangles[0]);
+    if (lineBytes) glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)triBytes, (GLsizeiptr)lineBytes, &s.lines[0]);
+    if (pointBytes) glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(triBytes + lineBytes), (GLsizeiptr)pointBytes, &s.pointVerts[0]);
+
+    // vertices are already in world space
+    Mat4 identity(1.0f);
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, identity.value_ptr());
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, view.value_ptr());
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projection.value_ptr());
+    glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), 0);
+    glUniform1i(glGetUniformLocation(shaderProgram, "useOverrideColor"), 0);
+
+    GLint first = 0;
+    if (!s.triangles.empty()) glDrawArrays(GL_TRIANGLES, first, (GLsizei)s.triangles.size());
+    first += (GLint)s.triangles.size();
+    if (!s.lines.empty()) glDrawArrays(GL_LINES, first, (GLsizei)s.lines.size());
+    first += (GLint)s.lines.size();
+
+    for (size_t i = 0; i < s.points.size();) {
+        size_t run = i + 1;
+        while (run < s.points.size() && s.points[run].size == s.points[i].size) ++run;
+        glPointSize(s.points[i].size);
+        glDrawArrays(GL_POINTS, first + (GLint)i, (GLsizei)(run - i));
+        i = run;
+    }
+    if (!s.points.empty()) glPointSize(1.0f);
+
+    glBindVertexArray(0);
+    clear();
+}
@@ -14,6 +14,10 @@ EditorInput::EditorInput(SDL_Window* window) {
     speed = 5.f;
     sensitivity = 0.1f;
 
+    prevViewportMouseDown = false;
+    picker = NULL;
+    clickPending = false;
+
     // SDL_HideCursor();
     // SDL_SetWindowRelativeMouseMode(window, true);
 }
@@ -106,6 +110,24 @@ void EditorInput::handleViewportInput(Editor* editor, GameMain& game,
         }
     };
 
+    bool gpuPicking = picker && picker->ready();
+
+    // Results of earlier ID passes
+    while (gpuPicking && picker->poll(pickResult)) {
+        if (pickResult.purpose == IdPicker::CLICK && clickPending) {
+            clickPending = false;
+            game.scene->applyPick(pickResult.nearest(), clickRayOrigin, clickRayDir);
+        } else if (pickResult.purpose == IdPicker::HOVER) {
+            game.scene->setHovered(pickResult.nearest());
+        }
+    }
+
+    if (gpuPicking) {
+        if (!hovered) game.scene->setHovered(0);
+        else if (!editor->isViewportMouseDown() && (io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f))
+            picker->requestPoint(IdPicker::HOVER, u, v);
+    }
+
     if (hovered && editor->isViewportMouseDown() && !prevViewportMouseDown) {
         float ndcX = u * 2.0f - 1.0f;
         float ndcY = v * 2.0f - 1.0f;
@@ -114,26 +136,34 @@ void EditorInput::handleViewportInput(Editor* editor, GameMain& game,
         Vec3d farP  = ClipToWorldHelper::convert(invPV, ndcX, ndcY,  1.0f);
         Vec3d rayDir = (farP - nearP).normalized();
 
-        // Try gizmo axis pick first
-        GizmoAxis axis;
-        if (game.scene->pickGizmoAxis(nearP, rayDir, axis)) {
-            game.scene->grabbedAxis = axis;
-            game.scene->axisGrabbed = true;
+        if (gpuPicking) {
+            // resolved in a later frame, once the ID pass has been read back
+            picker->requestPoint(IdPicker::CLICK, u, v);
+            clickPending = true;
+            clickRayOrigin = nearP;
+            clickRayDir = rayDir;
         } else {
-            game.scene->axisGrabbed = false;
-            game.scene->grabbedAxisIndex = -1;
-            // Pick object
-            Object* picked = game.scene->pickObject(nearP, rayDir);
-            if (picked) {
-                game.scene->selectedObject = picked;
+            // Try gizmo axis pick first
+            GizmoAxis axis;
+            if (game.scene->pickGizmoAxis(nearP, rayDir, axis)) {
+                game.scene->grabbedAxis = axis;
+                game.scene->axisGrabbed = true;
             } else {
-                // pick light
-                int li = -1;
-                if (game.scene->pickLight(nearP, rayDir, li)) {
-                    game.scene->selectedLightIndex = li;
+                game.scene->axisGrabbed = false;
+                game.scene->grabbedAxisIndex = -1;
+                // Pick object
+                Object* picked = game.scene->pickObject(nearP, rayDir);
+                if (picked) {
+                    game.scene->selectedObject = picked;
                 } else {
-                    game.scene->selectedObject = nullptr;
-                    game.scene->selectedLightIndex = -1;
+                    // pick light
+                    int li = -1;
+                    if (game.scene->pickLight(nearP, rayDir, li)) {
+                        game.scene->selectedLightIndex = li;
+                    } else {
+                        game.scene->selectedObject = nullptr;
+                        game.scene->selectedLightIndex = -1;
+                    }
                 }
             }
         }
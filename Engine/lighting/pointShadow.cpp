@@ -0,0 +1,219 @@
+#include "Engine/lighting/pointShadow.hpp"
+#include "Engine/sceneManager.hpp"
+#include "Engine/math/simdMath.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// GL cube map face order: +X, -X, +Y, -Y, +Z, -Z
+const float FACE_DIRS[PointShadow::FACES][3] = {
+	{ 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+};
+const float FACE_UPS[PointShadow::FACES][3] = {
+	{ 0, -1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0, -1, 0 }, { 0, -1, 0 }
+};
+
+inline uint64_t mix(uint64_t h, uint64_t v) {
+	// FNV-1a over the 8 bytes of v
+	for (int i = 0; i < 8; ++i) {
+		h ^= (v >> (i * 8)) & 0xFF;
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+} // namespace
+
+float PointShadow::rangeFor(float intensity) {
+	return std::sqrt(std::max(intensity, 0.0f) / 0.01f);
+}
+
+PointShadow::PointShadow() {
+	SHADOW_SIZE = 512;
+	fbo = 0;
+	cubeTex[0] = cubeTex[1] = 0;
+	nearP = 0.05f;
+	invalidate();
+
+	glGenFramebuffers(1, &fbo);
+	createTexture(0);
+	glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X, cubeTex[0], 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (status != GL_FRAMEBUFFER_COMPLETE) {
+		std::cerr << "[PointShadow] FBO incomplete: " << status << std::endl;
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+PointShadow::~PointShadow() {
+	for (int m = 0; m < 2; ++m) {
+		if (cubeTex[m]) glDeleteTextures(1, &cubeTex[m]);
+	}
+	if (fbo) glDeleteFramebuffers(1, &fbo);
+}
+
+void PointShadow::createTexture(int map) {
+	glGenTextures(1, &cubeTex[map]);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, cubeTex[map]);
+	for (int f = 0; f < FACES; ++f) {
+		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + f, 0, GL_DEPTH_COMPONENT24,
+			SHADOW_SIZE, SHADOW_SIZE, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+	}
+	// The shader compares distances itself, so the map is read as plain depth values.
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+}
+
+void PointShadow::invalidate() {
+	front = 0;
+	hasFront = false;
+	building = false;
+	frontPos = buildPos = Vec3d(0.0f);
+	frontFar = buildFar = 0.0f;
+	for (int m = 0; m < 2; ++m) {
+		for (int f = 0; f < FACES; ++f) {
+			faceValid[m][f] = false;
+			signatures[m][f] = 0;
+		}
+	}
+}
+
+// Which casters the face sees and in what state. Culls into faceVisible, which the depth pass
+// then repeats with the same frustum.
+uint64_t PointShadow::faceSignature(SceneManager* scene, int face, const Mat4& viewProj) {
+	const EntityStore& entities = scene->entities;
+	const size_t count = entities.size();
+
+	float planes[24];
+	SimdMath::extractFrustumPlanes(viewProj.value_ptr(), planes);
+	faceVisible.resize(count);
+	if (count) {
+		SimdMath::cullSpheres(planes, &entities.boundsX[0], &entities.boundsY[0], &entities.boundsZ[0],
+		                      &entities.boundsRadius[0], &faceVisible[0], count);
+	}
+
+	uint64_t h = mix(14695981039346656037ull, (uint64_t)face);
+	for (size_t i = 0; i < count; ++i) {
+		if (!faceVisible[i]) continue;
+		h = mix(h, (uint64_t)(uintptr_t)entities.owners[i]);
+		h = mix(h, (uint64_t)entities.version(i));
+		h = mix(h, ((uint64_t)entities.vaos[i] << 32) | (uint32_t)entities.indexCounts[i]);
+	}
+	return h;
+}
+
+int PointShadow::update(SceneManager* scene, GLuint depthProgram, const Vec3d& lightPos, float range, int faceBudget) {
+	const bool moved = lightPos.x != frontPos.x || lightPos.y != frontPos.y || lightPos.z != frontPos.z || range != frontFar;
+	if (!hasFront) {
+		// The first map; like a rebuild below it keeps the position it started at.
+		bool started = false;
+		for (int f = 0; f < FACES; ++f) started = started || faceValid[front][f];
+		if (!started) {
+			frontPos = lightPos;
+			frontFar = range;
+		}
+		int rendered = renderFaces(scene, depthProgram, front, frontPos, frontFar, faceBudget);
+		bool complete = true;
+		for (int f = 0; f < FACES; ++f) complete = complete && faceValid[front][f];
+		hasFront = complete;
+		return rendered;
+	}
+	if (!moved) {
+		// the light is where its map was rendered: only faces whose casters changed
+		building = false;
+		return renderFaces(scene, depthProgram, front, frontPos, frontFar, faceBudget);
+	}
+
+	// The light moved: build a map for where it is now in the other texture, sampling the old
+	// one meanwhile. A build in progress keeps its position, so it always finishes.
+	const int back = 1 - front;
+	if (!building) {
+		if (!cubeTex[back]) createTexture(back);
+		building = true;
+		buildPos = lightPos;
+		buildFar = range;
+		for (int f = 0; f < FACES; ++f) faceValid[back][f] = false;
+	}
+	int rendered = renderFaces(scene, depthProgram, back, buildPos, buildFar, faceBudget);
+	bool complete = true;
+	for (int f = 0; f < FACES; ++f) complete = complete && faceValid[back][f];
+	if (complete) {
+		front = back;
+		frontPos = buildPos;
+		frontFar = buildFar;
+		building = false;
+	}
+	return rendered;
+}
+
+int PointShadow::renderFaces(SceneManager* scene, GLuint depthProgram, int map, const Vec3d& lightPos, float far, int faceBudget) {
+	if (faceBudget <= 0) return 0;
+
+	Mat4 faceProj = perspective(radians(90.0f), 1.0f, nearP, far);
+
+	GLint prevViewport[4]; glGetIntegerv(GL_VIEWPORT, prevViewport);
+	GLint prevDrawFBO = 0; glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevDrawFBO);
+	GLint prevReadFBO = 0; glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevReadFBO);
+	GLint prevProgram = 0; glGetIntegerv(GL_CURRENT_PROGRAM, &prevProgram);
+	GLint prevDrawBuf = GL_BACK; glGetIntegerv(GL_DRAW_BUFFER, &prevDrawBuf);
+	GLint prevReadBuf = GL_BACK; glGetIntegerv(GL_READ_BUFFER, &prevReadBuf);
+	bool bound = false;
+
+	int rendered = 0;
+	for (int f = 0; f < FACES && rendered < faceBudget; ++f) {
+		Vec3d dir(FACE_DIRS[f][0], FACE_DIRS[f][1], FACE_DIRS[f][2]);
+		Vec3d up(FACE_UPS[f][0], FACE_UPS[f][1], FACE_UPS[f][2]);
+		Mat4 faceView = lookAt(lightPos, lightPos + dir, up);
+
+		uint64_t sig = faceSignature(scene, f, faceProj * faceView);
+		if (faceValid[map][f] && sig == signatures[map][f]) continue;
+
+		if (!bound) {
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+			glViewport(0, 0, SHADOW_SIZE, SHADOW_SIZE);
+			glDrawBuffer(GL_NONE);
+			glReadBuffer(GL_NONE);
+			glUseProgram(depthProgram);
+			GLint locPos = glGetUniformLocation(depthProgram, "uLightPos");
+			GLint locFar = glGetUniformLocation(depthProgram, "uFarPlane");
+			if (locPos >= 0) glUniform3f(locPos, lightPos.x, lightPos.y, lightPos.z);
+			if (locFar >= 0) glUniform1f(locFar, far);
+			bound = true;
+		}
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + f, cubeTex[map], 0);
+		glClear(GL_DEPTH_BUFFER_BIT);
+
+		// an empty face only needs the clear
+		bool anyCaster = false;
+		for (size_t i = 0; i < faceVisible.size() && !anyCaster; ++i) anyCaster = faceVisible[i] != 0;
+		if (anyCaster) scene->render(depthProgram, faceView, faceProj);
+
+		faceValid[map][f] = true;
+		signatures[map][f] = sig;
+		++rendered;
+	}
+
+	if (bound) {
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, prevDrawFBO);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, prevReadFBO);
+		glDrawBuffer(prevDrawBuf);
+		glReadBuffer(prevReadBuf);
+		glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+		glUseProgram((GLuint)prevProgram);
+	}
+	return rendered;
+}
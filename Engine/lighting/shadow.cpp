@@ -1,19 +1,38 @@
 #include "Engine/lighting/shadow.hpp"
 #include "Engine/sceneManager.hpp"
 #include "Engine/util/shaderc.hpp"
+#include "Engine/util/profiler.hpp"
+
+#include <cmath>
+
+const char* Shadow::qualityName(Quality q) {
+	switch (q) {
+	case HARD: return "Hard";
+	case POISSON_4: return "Poisson 4";
+	case PCF_9: return "PCF 3x3";
+	case POISSON_ROTATED: return "Rotated Poisson 8";
+	}
+	return "?";
+}
 
 Shadow::Shadow() {
 	SHADOW_SIZE = 2048;
 	depthMapFBO = 0;
 	depthMapTex = 0;
+	casterCount = 0;
+	receiverCount = 0;
 
     glGenFramebuffers(1, &depthMapFBO);
     glGenTextures(1, &depthMapTex);
     glBindTexture(GL_TEXTURE_2D, depthMapTex);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
         SHADOW_SIZE, SHADOW_SIZE, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    // Hardware depth compare: a sampler2DShadow lookup returns the lit fraction, and with
+    // linear filtering it is a bilinear 2x2 PCF in one fetch.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
     float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
@@ -45,48 +64,81 @@ Shadow::~Shadow() {
 	if (depthMapFBO) glDeleteFramebuffers(1, &depthMapFBO);
 }
 
+// Widens [lo, hi] so that it starts on a texel boundary of a map 'mapSize' texels wide and
+// keeps the same texel size while its extent changes a little. The light view is fixed in the
+// world, so edges that move in whole texels make every caster rasterize the same way from
+// frame to frame and the shadow edges stop shimmering as the camera moves.
+static void snapToTexels(float& lo, float& hi, int mapSize) {
+    // Extent in steps of 1/16 of its power of two, with room for the texel lo moves down by.
+    float extent = (hi - lo) * mapSize / (mapSize - 1);
+    float step = std::pow(2.0f, std::ceil(std::log2(extent))) / 16.0f;
+    extent = std::ceil(extent / step) * step;
+    float texel = extent / mapSize;
+    lo = std::floor(lo / texel) * texel;
+    hi = lo + extent;
+}
+
 // Render depth-only pass for this light. scene->render will draw objects with the given shader/program.
 // depthProgram must be a depth-only shader that uses 'model','view','projection' uniforms.
-Mat4 Shadow::renderDepth(SceneManager* scene, GLuint depthProgram) {
-    // compute a scene-centered light view/proj for directional lights (orthographic)
-    // Use scene bounds center so the directional light position in editor doesn't matter.
-    Vec3d sceneMin(1e9f, 1e9f, 1e9f);
-    Vec3d sceneMax(-1e9f, -1e9f, -1e9f);
-    bool hasObjects = false;
-
-    for (size_t i = 0; i < scene->objects.size(); ++i) {
-        Object* o = scene->objects[i];
-        if (!o) continue;
-        hasObjects = true;
-        // use object position as cheap proxy for object bounds center
-        Vec3d p = o->position;
-        sceneMin.x = std::min(sceneMin.x, p.x);
-        sceneMin.y = std::min(sceneMin.y, p.y);
-        sceneMin.z = std::min(sceneMin.z, p.z);
-        sceneMax.x = std::max(sceneMax.x, p.x);
-        sceneMax.y = std::max(sceneMax.y, p.y);
-        sceneMax.z = std::max(sceneMax.z, p.z);
+//
+// The ortho box is fitted to the casters that can shadow a visible receiver: its xy is the
+// receivers' light-space footprint clipped to the casters', its depth runs from the caster
+// closest to the light to the receiver farthest from it. Its xy edges are snapped to texels
+// (see snapToTexels). The depth pass then frustum-culls against that box, so whatever lies
+// outside it is never drawn.
+Mat4 Shadow::renderDepth(SceneManager* scene, GLuint depthProgram, const uint8_t* receivers) {
+    PROFILE_SCOPE("Shadow::renderDepth");
+    const EntityStore& entities = scene->entities;
+    const size_t count = entities.size();
+
+    Vec3d dir = lightDir.normalized();
+    Vec3d up = std::fabs(dir.y) > 0.99f ? Vec3d(1, 0, 0) : Vec3d(0, 1, 0);
+    Mat4 lightView = lookAt(Vec3d(0.0f), dir, up); // light space looks down -z
+
+    // receivers: light-space bounds of everything the camera sees
+    Vec3d rMin(FLT_MAX), rMax(-FLT_MAX);
+    lightSpaceCenters.resize(count);
+    receiverCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Vec3d c = lightView.transformPoint(Vec3d(entities.boundsX[i], entities.boundsY[i], entities.boundsZ[i]));
+        lightSpaceCenters[i] = c;
+        if (receivers && !receivers[i]) continue;
+        float r = entities.boundsRadius[i];
+        rMin.x = std::min(rMin.x, c.x - r); rMax.x = std::max(rMax.x, c.x + r);
+        rMin.y = std::min(rMin.y, c.y - r); rMax.y = std::max(rMax.y, c.y + r);
+        rMin.z = std::min(rMin.z, c.z - r); rMax.z = std::max(rMax.z, c.z + r);
+        ++receiverCount;
     }
 
-    Vec3d center;
-    float useSz = sz;
-    if (hasObjects) {
-        center = (sceneMin + sceneMax) * 0.5f;
-        // expand orthographic half-size to cover scene extent if needed
-        Vec3d ext = sceneMax - sceneMin;
-        float maxDim = std::max(std::max(ext.x, ext.y), ext.z);
-        if (maxDim * 0.6f > useSz) useSz = maxDim * 0.6f;
-    } else {
-        // fallback to using the shadow's configured lightPos
-        center = lightPos;
+    // casters: anything over the receivers' footprint and not entirely behind all of them
+    Vec3d cMin(FLT_MAX), cMax(-FLT_MAX);
+    casterCount = 0;
+    for (size_t i = 0; i < count && receiverCount; ++i) {
+        const Vec3d& c = lightSpaceCenters[i];
+        float r = entities.boundsRadius[i];
+        if (c.x + r < rMin.x || c.x - r > rMax.x) continue;
+        if (c.y + r < rMin.y || c.y - r > rMax.y) continue;
+        if (c.z + r < rMin.z) continue;
+        cMin.x = std::min(cMin.x, c.x - r); cMax.x = std::max(cMax.x, c.x + r);
+        cMin.y = std::min(cMin.y, c.y - r); cMax.y = std::max(cMax.y, c.y + r);
+        cMax.z = std::max(cMax.z, c.z + r);
+        ++casterCount;
     }
 
-    // position the light camera so it looks at the scene center along lightDir.
-    // Place the camera sufficiently far opposite the light direction to cover the scene.
-    Vec3d lightCamPos = center - lightDir.normalized() * (useSz * 2.0f);
-
-    Mat4 lightView = lookAt(lightCamPos, center, Vec3d(0, 1, 0));
-    Mat4 lightProj = orthographic(-useSz, useSz, -useSz, useSz, nearP, farP);
+    Mat4 lightProj;
+    if (casterCount > 0) {
+        const float pad = 0.05f;
+        float left = std::max(rMin.x, cMin.x) - pad, right = std::min(rMax.x, cMax.x) + pad;
+        float bottom = std::max(rMin.y, cMin.y) - pad, top = std::min(rMax.y, cMax.y) + pad;
+        snapToTexels(left, right, SHADOW_SIZE);
+        snapToTexels(bottom, top, SHADOW_SIZE);
+        lightProj = orthographic(left, right, bottom, top, -cMax.z - pad, -rMin.z + pad);
+    } else {
+        // nothing to shadow: keep the old box around the light, the map is just cleared
+        Vec3d lightCamPos = lightPos - dir * (sz * 2.0f);
+        lightView = lookAt(lightCamPos, lightPos, up);
+        lightProj = orthographic(-sz, sz, -sz, sz, nearP, farP);
+    }
     lastLightSpace = lightProj * lightView;
 
     // Save GL state we will modify
@@ -117,8 +169,9 @@ Mat4 Shadow::renderDepth(SceneManager* scene, GLuint depthProgram) {
     if (locV >= 0) glUniformMatrix4fv(locV, 1, GL_FALSE, lightView.value_ptr());
     if (locP >= 0) glUniformMatrix4fv(locP, 1, GL_FALSE, lightProj.value_ptr());
 
-    // Draw scene using depth program; SceneManager::render will set 'model' per object.
-    scene->render(depthProgram, lightView, lightProj);
+    // Draw scene using depth program; SceneManager::render will set 'model' per object and
+    // cull against the fitted box.
+    if (casterCount > 0) scene->render(depthProgram, lightView, lightProj);
 
     glDisable(GL_POLYGON_OFFSET_FILL);
 
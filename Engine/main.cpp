@@ -20,6 +20,9 @@
 #include "math/math.hpp"
 
 #include "Engine/util/shaderc.hpp"
+#include "Engine/util/frameArena.hpp"
+#include "Engine/util/fileWatcher.hpp"
+#include "Engine/util/profiler.hpp"
 #include "Engine/input.hpp"
 #include "Engine/sceneManager.hpp"
 #include "Engine/editor.hpp"
@@ -36,6 +39,7 @@ int main(int argc, char* argv[]) {
 
     bool game_mode = false;
     std::string scenePath = "";
+    std::string tracePath;
     for (int i = 1; i < argc; ++i) {
         std::string a = argv[i];
         if (a == "--game") {
@@ -52,6 +56,16 @@ int main(int argc, char* argv[]) {
             scenePath = a.substr(key.size());
             continue;
         }
+        // --trace <file.json>: Chrome trace of every frame, see Profiler
+        const std::string traceKey = "--trace=";
+        if (a == "--trace" && i + 1 < argc) {
+            tracePath = std::string(argv[++i]);
+            continue;
+        }
+        if (a.size() > traceKey.size() && a.compare(0, traceKey.size(), traceKey) == 0) {
+            tracePath = a.substr(traceKey.size());
+            continue;
+        }
     }
 
     printf("[Main] Args: game_mode=%d scenePath='%s'\n", game_mode ? 1 : 0, scenePath.c_str());
@@ -127,16 +141,28 @@ int main(int argc, char* argv[]) {
     glCullFace(GL_BACK);
     glFrontFace(GL_CCW);
 
+    // Only submitted here: the driver compiles it (and the scene's own programs) while the
+    // editor and scene load. Frames skip the scene until it links.
     Shaderc ShaderCompiler;
-    GLuint shaderProgram = ShaderCompiler.loadShader("shaders/vertex.glsl", "shaders/fragment.glsl");
+    GLuint shaderProgram = ShaderCompiler.submit("shaders/vertex.glsl", "shaders/fragment.glsl");
     if (shaderProgram == 0) {
         std::cerr << "Failed to load/compile/link shaders. Exiting." << std::endl;
         SDL_Quit();
         return -1;
     }
     std::cerr << "[Main] shaderProgram id = " << shaderProgram << std::endl;
+    GLuint pendingShaderProgram = 0;    // hot-reloaded lit program, swapped in once it links
+
+    // Asset hot reload: the watcher thread reports settled writes, the frame loop applies them.
+    FileWatcher assetWatcher;
+    assetWatcher.watchDirectory("shaders");
+    assetWatcher.watchDirectory("textures");
+    assetWatcher.start();
+    std::vector<FileWatcher::Change> assetChanges;
+    std::string watchedScenePath;
 
     EditorInput inputHandler(window);
+    IdPicker idPicker;
 
     Uint64 NOW = SDL_GetTicks();
     Uint64 LAST = 0;
@@ -217,15 +243,57 @@ int main(int argc, char* argv[]) {
     } else {
         editor = new Editor(window, &game, editorWidth);
         editor->setViewportTexture(viewportTexture, viewportW, viewportH);
-        game.scene->initGrid(50, 1.f);
+        game.scene->initGrid(1.f);
         game.scene->initLightGizmo();
+        // GPU picking in the viewport; without it EditorInput falls back to CPU ray tests
+        if (idPicker.init()) {
+            idPicker.resize(viewportFBO, viewportW, viewportH);
+            inputHandler.picker = &idPicker;
+        }
     }
 
+    if (!tracePath.empty()) Profiler::startTrace(tracePath);
+    RenderStats::install();
+
     while (running) {
+        Profiler::beginFrame();
         LAST = NOW;
         NOW = SDL_GetTicks();
         deltaTime = (NOW - LAST) / 1000.0f;
 
+        // the scene's own directory, once a scene has been loaded from it. Watches are recursive,
+        // so a scene next to the executable is not watched rather than watching the whole tree.
+        if (game.scene->getLoadedScenePath() != watchedScenePath) {
+            watchedScenePath = game.scene->getLoadedScenePath();
+            fs::path sceneDir = fs::path(watchedScenePath).parent_path();
+            if (!sceneDir.empty()) assetWatcher.watchDirectory(sceneDir.string());
+        }
+        assetChanges.clear();
+        assetWatcher.poll(assetChanges);
+        for (size_t i = 0; i < assetChanges.size(); ++i) {
+            if (assetChanges[i].kind == FileWatcher::SHADER) {
+                if (pendingShaderProgram != 0) Shaderc::releaseProgram(pendingShaderProgram);
+                pendingShaderProgram = ShaderCompiler.submit("shaders/vertex.glsl", "shaders/fragment.glsl");
+            }
+            game.scene->onAssetChanged(assetChanges[i]);
+        }
+
+        Shaderc::poll();
+        if (Shaderc::failed(shaderProgram)) {
+            std::cerr << "Failed to load/compile/link shaders. Exiting." << std::endl;
+            break;
+        }
+        // a broken edit keeps the previous program on screen
+        if (pendingShaderProgram != 0 && Shaderc::ready(pendingShaderProgram)) {
+            Shaderc::releaseProgram(shaderProgram);
+            shaderProgram = pendingShaderProgram;
+            pendingShaderProgram = 0;
+        } else if (pendingShaderProgram != 0 && Shaderc::failed(pendingShaderProgram)) {
+            Shaderc::releaseProgram(pendingShaderProgram);
+            pendingShaderProgram = 0;
+        }
+        const bool sceneProgramReady = Shaderc::ready(shaderProgram);
+
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplSDL2_NewFrame();
         ImGui::NewFrame();
@@ -237,6 +305,8 @@ int main(int argc, char* argv[]) {
         }
 
         if(game_mode) {
+            PROFILE_SCOPE("Game update");
+            FrameAllocationScope countAllocations;
             game.Update(deltaTime);
         }
 
@@ -246,6 +316,7 @@ int main(int argc, char* argv[]) {
         // Update editor UI when in editor mode
         if (!game_mode) {
             editorWidth = 350.f;
+            PROFILE_SCOPE("Editor UI");
             if (editor) editor->Update();
         }
 
@@ -276,8 +347,9 @@ int main(int argc, char* argv[]) {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         Mat4 view;
-        if (game_mode && game.player && game.player->playerObject) {
-            NMATH::Vec3d target = game.player->playerObject->position;
+        Object* followed = game.player ? game.player->getObject() : nullptr;
+        if (game_mode && followed) {
+            NMATH::Vec3d target = followed->position;
             NMATH::Vec3d camPos = target + NMATH::Vec3d(0.0f, 2.0f, 6.0f);
             view = lookAt(camPos, target, NMATH::Vec3d(0.0f,1.0f,0.0f));
         } else {
@@ -309,6 +381,7 @@ int main(int argc, char* argv[]) {
 				glBindRenderbuffer(GL_RENDERBUFFER, 0);
             }
 
+            idPicker.resize(viewportFBO, viewportW, viewportH);
             editor->setViewportTexture(viewportTexture, viewportW, viewportH);
         }
 
@@ -323,19 +396,27 @@ int main(int argc, char* argv[]) {
         glClearColor(0.1f, 0.0f, 0.2f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glUseProgram(shaderProgram);
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, view.value_ptr());
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projection.value_ptr());
-        
-        game.scene->render(shaderProgram, view, projection);
-
-        if(!game_mode) {
-            GLuint activeForEditor = game.scene->getActiveProgram();
-            if (activeForEditor == 0) activeForEditor = shaderProgram;
-            game.scene->drawGrid(activeForEditor, view, projection);
-            glDisable(GL_DEPTH_TEST);
-            game.scene->drawGizmo(activeForEditor, view, projection);
-            glEnable(GL_DEPTH_TEST);
+        if (sceneProgramReady) {
+            glUseProgram(shaderProgram);
+            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, view.value_ptr());
+            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projection.value_ptr());
+
+            // editor UI is not counted, only the engine's own per-frame work
+            FrameAllocationScope countAllocations;
+            game.scene->render(shaderProgram, view, projection);
+
+            if(!game_mode) {
+                GLuint activeForEditor = game.scene->getActiveProgram();
+                if (activeForEditor == 0) activeForEditor = shaderProgram;
+                game.scene->drawGrid(view, projection);
+                glDisable(GL_DEPTH_TEST);
+                game.scene->drawGizmo(activeForEditor, view, projection);
+                glEnable(GL_DEPTH_TEST);
+
+                // only when a click or hover is waiting on it
+                if (inputHandler.picker && idPicker.wantsPass())
+                    game.scene->renderIds(idPicker, viewportFBO, view, projection);
+            }
         }
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -344,11 +425,24 @@ int main(int argc, char* argv[]) {
         SDL_GetWindowSize(window, &winW, &winH);
         glViewport(0, 0, winW, winH);
 
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            PROFILE_SCOPE("ImGui render");
+            PROFILE_GPU_SCOPE("ImGui");
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
 
-        SDL_GL_SwapWindow(window);
+        {
+            PROFILE_SCOPE("Swap");
+            SDL_GL_SwapWindow(window);
+        }
+        FrameAllocator::endFrame();
+        Profiler::endFrame();
+        RenderStats::endFrame();
     }
+    Profiler::stopTrace();
+
+    idPicker.shutdown();
 
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
@@ -0,0 +1,345 @@
+#include "Engine/math/simdMath.hpp"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+// Backend is fixed at compile time. CMake passes GENGINE_SIMD_AVX2 / GENGINE_SIMD_SSE4 along
+// with the matching compiler flags for this file; compiler-defined macros work too.
+#if !defined(GENGINE_SIMD_SCALAR)
+#if defined(GENGINE_SIMD_AVX2) || defined(__AVX2__)
+#define SIMD_AVX2 1
+#define SIMD_SSE4 1
+#elif defined(GENGINE_SIMD_SSE4) || defined(__SSE4_1__)
+#define SIMD_SSE4 1
+#endif
+#endif
+
+#if defined(SIMD_SSE4)
+#include <smmintrin.h>
+#endif
+#if defined(SIMD_AVX2)
+#include <immintrin.h>
+#endif
+
+static const float RAY_DET_EPSILON = 1e-8f;
+static const float RAY_MIN_T = 1e-6f;
+
+const char* SimdMath::backend() {
+#if defined(SIMD_AVX2)
+    return "AVX2";
+#elif defined(SIMD_SSE4)
+    return "SSE4.1";
+#else
+    return "scalar";
+#endif
+}
+
+// ---------------------------------------------------------------- compose TRS
+
+static void composeTRSScalar(const float* p, const float* q, const float* s, float* m) {
+    float xx = q[0] * q[0], yy = q[1] * q[1], zz = q[2] * q[2];
+    float xy = q[0] * q[1], xz = q[0] * q[2], yz = q[1] * q[2];
+    float wx = q[3] * q[0], wy = q[3] * q[1], wz = q[3] * q[2];
+
+    m[0]  = (1.0f - 2.0f * (yy + zz)) * s[0];
+    m[1]  = 2.0f * (xy + wz) * s[0];
+    m[2]  = 2.0f * (xz - wy) * s[0];
+    m[3]  = 0.0f;
+    m[4]  = 2.0f * (xy - wz) * s[1];
+    m[5]  = (1.0f - 2.0f * (xx + zz)) * s[1];
+    m[6]  = 2.0f * (yz + wx) * s[1];
+    m[7]  = 0.0f;
+    m[8]  = 2.0f * (xz + wy) * s[2];
+    m[9]  = 2.0f * (yz - wx) * s[2];
+    m[10] = (1.0f - 2.0f * (xx + yy)) * s[2];
+    m[11] = 0.0f;
+    m[12] = p[0];
+    m[13] = p[1];
+    m[14] = p[2];
+    m[15] = 1.0f;
+}
+
+void SimdMath::composeTRS(const float* positions, const float* quats, const float* scales,
+                          float* outMatrices, size_t count) {
+    size_t i = 0;
+#if defined(SIMD_SSE4)
+    // Four elements per step: quaternions are transposed into x/y/z/w lanes, the rotation
+    // terms computed lane-wise, and each column transposed back out per element.
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 qx = _mm_loadu_ps(quats + i * 4 + 0);
+        __m128 qy = _mm_loadu_ps(quats + i * 4 + 4);
+        __m128 qz = _mm_loadu_ps(quats + i * 4 + 8);
+        __m128 qw = _mm_loadu_ps(quats + i * 4 + 12);
+        _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+        const float* p = positions + i * 3;
+        const float* s = scales + i * 3;
+        __m128 px = _mm_setr_ps(p[0], p[3], p[6], p[9]);
+        __m128 py = _mm_setr_ps(p[1], p[4], p[7], p[10]);
+        __m128 pz = _mm_setr_ps(p[2], p[5], p[8], p[11]);
+        __m128 sx = _mm_setr_ps(s[0], s[3], s[6], s[9]);
+        __m128 sy = _mm_setr_ps(s[1], s[4], s[7], s[10]);
+        __m128 sz = _mm_setr_ps(s[2], s[5], s[8], s[11]);
+
+        __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+        __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+        __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+        __m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+        __m128 c0y = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+        __m128 c0z = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+        __m128 c0w = zero;
+        __m128 c1x = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+        __m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+        __m128 c1z = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+        __m128 c1w = zero;
+        __m128 c2x = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+        __m128 c2y = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+        __m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+        __m128 c2w = zero;
+        __m128 c3w = one;
+
+        _MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+        _MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+        _MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+        _MM_TRANSPOSE4_PS(px, py, pz, c3w);
+
+        float* m = outMatrices + i * 16;
+        _mm_storeu_ps(m + 0, c0x);  _mm_storeu_ps(m + 4, c1x);  _mm_storeu_ps(m + 8, c2x);  _mm_storeu_ps(m + 12, px);
+        _mm_storeu_ps(m + 16, c0y); _mm_storeu_ps(m + 20, c1y); _mm_storeu_ps(m + 24, c2y); _mm_storeu_ps(m + 28, py);
+        _mm_storeu_ps(m + 32, c0z); _mm_storeu_ps(m + 36, c1z); _mm_storeu_ps(m + 40, c2z); _mm_storeu_ps(m + 44, pz);
+        _mm_storeu_ps(m + 48, c0w); _mm_storeu_ps(m + 52, c1w); _mm_storeu_ps(m + 56, c2w); _mm_storeu_ps(m + 60, c3w);
+    }
+#endif
+    for (; i < count; ++i) {
+        composeTRSScalar(positions + i * 3, quats + i * 4, scales + i * 3, outMatrices + i * 16);
+    }
+}
+
+// ---------------------------------------------------------------- matrix multiply
+
+static void multiplyScalar(const float* a, const float* b, float* out) {
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            out[c * 4 + r] = a[0 * 4 + r] * b[c * 4 + 0] + a[1 * 4 + r] * b[c * 4 + 1] +
+                             a[2 * 4 + r] * b[c * 4 + 2] + a[3 * 4 + r] * b[c * 4 + 3];
+        }
+    }
+}
+
+void SimdMath::multiplyMatrices(const float* lhs, const float* matrices, float* outMatrices, size_t count) {
+    size_t i = 0;
+#if defined(SIMD_AVX2)
+    // Two result columns per 256-bit op: both halves hold the same lhs column.
+    const __m256 l0 = _mm256_broadcast_ps((const __m128*)(lhs + 0));
+    const __m256 l1 = _mm256_broadcast_ps((const __m128*)(lhs + 4));
+    const __m256 l2 = _mm256_broadcast_ps((const __m128*)(lhs + 8));
+    const __m256 l3 = _mm256_broadcast_ps((const __m128*)(lhs + 12));
+    for (; i < count; ++i) {
+        const float* b = matrices + i * 16;
+        float* out = outMatrices + i * 16;
+        for (int c = 0; c < 16; c += 8) {
+            __m256 col = _mm256_loadu_ps(b + c);
+            __m256 r = _mm256_mul_ps(l0, _mm256_permute_ps(col, 0x00));
+            r = _mm256_add_ps(r, _mm256_mul_ps(l1, _mm256_permute_ps(col, 0x55)));
+            r = _mm256_add_ps(r, _mm256_mul_ps(l2, _mm256_permute_ps(col, 0xAA)));
+            r = _mm256_add_ps(r, _mm256_mul_ps(l3, _mm256_permute_ps(col, 0xFF)));
+            _mm256_storeu_ps(out + c, r);
+        }
+    }
+#elif defined(SIMD_SSE4)
+    const __m128 l0 = _mm_loadu_ps(lhs + 0);
+    const __m128 l1 = _mm_loadu_ps(lhs + 4);
+    const __m128 l2 = _mm_loadu_ps(lhs + 8);
+    const __m128 l3 = _mm_loadu_ps(lhs + 12);
+    for (; i < count; ++i) {
+        const float* b = matrices + i * 16;
+        float* out = outMatrices + i * 16;
+        for (int c = 0; c < 16; c += 4) {
+            __m128 r = _mm_mul_ps(l0, _mm_set1_ps(b[c + 0]));
+            r = _mm_add_ps(r, _mm_mul_ps(l1, _mm_set1_ps(b[c + 1])));
+            r = _mm_add_ps(r, _mm_mul_ps(l2, _mm_set1_ps(b[c + 2])));
+            r = _mm_add_ps(r, _mm_mul_ps(l3, _mm_set1_ps(b[c + 3])));
+            _mm_storeu_ps(out + c, r);
+        }
+    }
+#endif
+    for (; i < count; ++i) multiplyScalar(lhs, matrices + i * 16, outMatrices + i * 16);
+}
+
+// ---------------------------------------------------------------- frustum culling
+
+void SimdMath::extractFrustumPlanes(const float* m, float* planes) {
+    // rows of the column-major matrix; plane = row3 +/- rowN (Gribb/Hartmann)
+    for (int p = 0; p < 6; ++p) {
+        int row = p / 2;
+        float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+        float a = m[3]  + sign * m[row];
+        float b = m[7]  + sign * m[4 + row];
+        float c = m[11] + sign * m[8 + row];
+        float d = m[15] + sign * m[12 + row];
+        float len = std::sqrt(a * a + b * b + c * c);
+        float inv = len > 0.0f ? 1.0f / len : 0.0f;
+        planes[p * 4 + 0] = a * inv;
+        planes[p * 4 + 1] = b * inv;
+        planes[p * 4 + 2] = c * inv;
+        planes[p * 4 + 3] = d * inv;
+    }
+}
+
+void SimdMath::cullSpheres(const float* planes, const float* cx, const float* cy, const float* cz,
+                           const float* radii, uint8_t* visible, size_t count) {
+    size_t i = 0;
+#if defined(SIMD_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(cx + i), y = _mm256_loadu_ps(cy + i), z = _mm256_loadu_ps(cz + i);
+        __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radii + i));
+        __m256 outside = _mm256_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            const float* pl = planes + p * 4;
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(pl[0])),
+                                                   _mm256_mul_ps(y, _mm256_set1_ps(pl[1]))),
+                                     _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(pl[2])),
+                                                   _mm256_set1_ps(pl[3])));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(d, negR, _CMP_LT_OQ));
+        }
+        int mask = _mm256_movemask_ps(outside);
+        for (int k = 0; k < 8; ++k) visible[i + k] = (uint8_t)(((mask >> k) & 1) ^ 1);
+    }
+#endif
+#if defined(SIMD_SSE4)
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(cx + i), y = _mm_loadu_ps(cy + i), z = _mm_loadu_ps(cz + i);
+        __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radii + i));
+        __m128 outside = _mm_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            const float* pl = planes + p * 4;
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(pl[0])), _mm_mul_ps(y, _mm_set1_ps(pl[1]))),
+                                  _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(pl[2])), _mm_set1_ps(pl[3])));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(d, negR));
+        }
+        int mask = _mm_movemask_ps(outside);
+        for (int k = 0; k < 4; ++k) visible[i + k] = (uint8_t)(((mask >> k) & 1) ^ 1);
+    }
+#endif
+    for (; i < count; ++i) {
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; ++p) {
+            const float* pl = planes + p * 4;
+            inside = pl[0] * cx[i] + pl[1] * cy[i] + pl[2] * cz[i] + pl[3] >= -radii[i];
+        }
+        visible[i] = inside ? 1 : 0;
+    }
+}
+
+// ---------------------------------------------------------------- ray vs triangles
+
+static inline const float* vertexAt(const void* positions, size_t stride, unsigned int index) {
+    return (const float*)((const char*)positions + stride * index);
+}
+
+// Moller-Trumbore, two-sided.
+static bool rayTriangleScalar(const float* o, const float* d, const float* v0, const float* v1,
+                              const float* v2, float& t) {
+    float e1[3] = { v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2] };
+    float e2[3] = { v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2] };
+    float p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+    float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+    if (std::fabs(det) < RAY_DET_EPSILON) return false;
+    float inv = 1.0f / det;
+    float s[3] = { o[0] - v0[0], o[1] - v0[1], o[2] - v0[2] };
+    float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv;
+    if (u < 0.0f || u > 1.0f) return false;
+    float q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+    float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inv;
+    if (v < 0.0f || u + v > 1.0f) return false;
+    t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inv;
+    return t > RAY_MIN_T;
+}
+
+#if defined(SIMD_SSE4)
+// Lane-wise Moller-Trumbore over 4 triangles whose vertices are already split into x/y/z lanes.
+// Misses come back as FLT_MAX.
+static inline __m128 rayTriangles4(const __m128 o[3], const __m128 d[3], const __m128 a[3],
+                                   const __m128 b[3], const __m128 c[3]) {
+    __m128 e1x = _mm_sub_ps(b[0], a[0]), e1y = _mm_sub_ps(b[1], a[1]), e1z = _mm_sub_ps(b[2], a[2]);
+    __m128 e2x = _mm_sub_ps(c[0], a[0]), e2y = _mm_sub_ps(c[1], a[1]), e2z = _mm_sub_ps(c[2], a[2]);
+    __m128 px = _mm_sub_ps(_mm_mul_ps(d[1], e2z), _mm_mul_ps(d[2], e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(d[2], e2x), _mm_mul_ps(d[0], e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(d[0], e2y), _mm_mul_ps(d[1], e2x));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+    __m128 absDet = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+    __m128 valid = _mm_cmpge_ps(absDet, _mm_set1_ps(RAY_DET_EPSILON));
+    __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+    __m128 sx = _mm_sub_ps(o[0], a[0]), sy = _mm_sub_ps(o[1], a[1]), sz = _mm_sub_ps(o[2], a[2]);
+    __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inv);
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+    __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], qx), _mm_mul_ps(d[1], qy)), _mm_mul_ps(d[2], qz)), inv);
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv);
+
+    __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    valid = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+    valid = _mm_and_ps(valid, _mm_cmple_ps(u, one));
+    valid = _mm_and_ps(valid, _mm_cmpge_ps(v, zero));
+    valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), one));
+    valid = _mm_and_ps(valid, _mm_cmpgt_ps(t, _mm_set1_ps(RAY_MIN_T)));
+    return _mm_blendv_ps(_mm_set1_ps(FLT_MAX), t, valid);
+}
+#endif
+
+long SimdMath::intersectRayTriangles(const float* origin, const float* dir,
+                                     const void* positions, size_t stride,
+                                     const unsigned int* indices, size_t triangleCount, float& tOut) {
+    long best = -1;
+    float bestT = FLT_MAX;
+    size_t i = 0;
+
+#if defined(SIMD_SSE4)
+    const __m128 o[3] = { _mm_set1_ps(origin[0]), _mm_set1_ps(origin[1]), _mm_set1_ps(origin[2]) };
+    const __m128 d[3] = { _mm_set1_ps(dir[0]), _mm_set1_ps(dir[1]), _mm_set1_ps(dir[2]) };
+    // gather four triangles into x/y/z lanes
+    float lanes[9][4];
+    for (; i + 4 <= triangleCount; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            const unsigned int* tri = indices + (i + k) * 3;
+            for (int v = 0; v < 3; ++v) {
+                const float* p = vertexAt(positions, stride, tri[v]);
+                lanes[v * 3 + 0][k] = p[0];
+                lanes[v * 3 + 1][k] = p[1];
+                lanes[v * 3 + 2][k] = p[2];
+            }
+        }
+        __m128 a[3] = { _mm_loadu_ps(lanes[0]), _mm_loadu_ps(lanes[1]), _mm_loadu_ps(lanes[2]) };
+        __m128 b[3] = { _mm_loadu_ps(lanes[3]), _mm_loadu_ps(lanes[4]), _mm_loadu_ps(lanes[5]) };
+        __m128 c[3] = { _mm_loadu_ps(lanes[6]), _mm_loadu_ps(lanes[7]), _mm_loadu_ps(lanes[8]) };
+        __m128 t = rayTriangles4(o, d, a, b, c);
+        if (_mm_movemask_ps(_mm_cmplt_ps(t, _mm_set1_ps(bestT))) == 0) continue;
+
+        float ts[4];
+        _mm_storeu_ps(ts, t);
+        for (int k = 0; k < 4; ++k) {
+            if (ts[k] < bestT) { bestT = ts[k]; best = (long)(i + k); }
+        }
+    }
+#endif
+
+    for (; i < triangleCount; ++i) {
+        const unsigned int* tri = indices + i * 3;
+        float t = 0.0f;
+        if (rayTriangleScalar(origin, dir, vertexAt(positions, stride, tri[0]), vertexAt(positions, stride, tri[1]),
+                              vertexAt(positions, stride, tri[2]), t) && t < bestT) {
+            bestT = t;
+            best = (long)i;
+        }
+    }
+
+    if (best >= 0) tOut = bestT;
+    return best;
+}
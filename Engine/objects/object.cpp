@@ -1,12 +1,33 @@
 #include "Engine/objects/object.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 Object::Object() {
     position = Vec3d(0.0f);
     rotation = Vec3d(0.0f);
     scale    = Vec3d(1.0f);
     name = "Unnamed object";
+    id = 0;
+    nameId = typeId = StringTable::NONE;
+    tags = 0;
+    prefab = -1;
+    meshSource = nullptr;
     VAO = VBO = EBO = 0;
     textureID = 0;
+    sharedTexture = false;
+
+    parent = nullptr;
+    isStatic = false;
+    transformQueue = nullptr;
+    transformQueueIndex = -1;
+    dynamicIndex = -1;
+    localMatrix = worldMatrix = inverseWorldMatrix = Mat4(1.0f);
+    for (int i = 0; i < 9; ++i) cachedTRS[i] = 0.0f;
+    worldVersion = 1;
+    parentVersionSeen = 0;
+    transformDirty = true;
+    inverseDirty = true;
 }
 
 void Object::initCube(float size) {
@@ -42,6 +63,8 @@ void Object::initPyramid(float size, float height) {
 }
 
 void Object::setupMesh() {
+    // the scene copies the new draw handles when it refreshes a queued object
+    queueTransform();
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
@@ -67,59 +90,127 @@ void Object::setupMesh() {
     glEnableVertexAttribArray(3);
 }
 
-Mat4 Object::getModelMatrix() const {
-    Mat4 model = Mat4::identity();
-    model = translate(model, position);
-    model = rotate(model, radians(rotation.x), {1,0,0});
-    model = rotate(model, radians(rotation.y), {0,1,0});
-    model = rotate(model, radians(rotation.z), {0,0,1});
-    model = NMATH::scale(model, scale);
-    return model;
+bool Object::setParent(Object* newParent) {
+    if (newParent == parent) return true;
+    for (Object* p = newParent; p; p = p->parent) {
+        if (p == this) return false;
+    }
+
+    if (parent) {
+        std::vector<Object*>& siblings = parent->children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+    }
+    parent = newParent;
+    if (parent) parent->children.push_back(this);
+    markDirty();
+    return true;
 }
 
+bool Object::refreshTransform(bool parentCurrent) const {
+    bool localChanged = transformDirty;
+    if (!isStatic || transformDirty) {
+        float t[9] = {
+            position.x, position.y, position.z,
+            rotation.x, rotation.y, rotation.z,
+            scale.x, scale.y, scale.z
+        };
+        if (localChanged || std::memcmp(t, cachedTRS, sizeof(t)) != 0) {
+            std::memcpy(cachedTRS, t, sizeof(t));
+            localMatrix = composeTRS(position, Quat::fromEulerDegrees(rotation), scale);
+            localChanged = true;
+        }
+    }
 
-void Object::texture(const std::string& path) {
-    if (path.empty()) return;
+    bool parentChanged = false;
+    if (parent) {
+        if (!parentCurrent) parent->refreshTransform();
+        parentChanged = parent->worldVersion != parentVersionSeen;
+    }
+    if (!localChanged && !parentChanged) return false;
 
-    texturePath = path;
+    if (parent) {
+        worldMatrix = parent->worldMatrix * localMatrix;
+        parentVersionSeen = parent->worldVersion;
+    } else {
+        worldMatrix = localMatrix;
+    }
+    ++worldVersion;
+    transformDirty = false;
+    inverseDirty = true;
+    return true;
+}
 
-    if (textureID != 0) {
-        glDeleteTextures(1, &textureID);
-        textureID = 0;
+const Mat4& Object::getModelMatrix() const {
+    refreshTransform();
+    return worldMatrix;
+}
+
+const Mat4& Object::getLocalMatrix() const {
+    refreshTransform();
+    return localMatrix;
+}
+
+const Mat4& Object::getInverseModelMatrix() const {
+    refreshTransform();
+    if (inverseDirty) {
+        inverseWorldMatrix = worldMatrix.inverse();
+        inverseDirty = false;
     }
+    return inverseWorldMatrix;
+}
 
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+void Object::texture(const std::string& path) {
+    if (path.empty()) return;
 
     int width, height, nrChannels;
     unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-    if (data) {
-        GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        std::cerr << "[Object] Loaded texture '" << path << "' -> id=" << textureID << " (" << width << "x" << height << ", ch=" << nrChannels << ")" << std::endl;
-    } else {
+    if (!data) {
+        texturePath = path;
         std::cerr << "Failed to load texture: " << path.c_str() << std::endl;
         std::cerr << "stbi_failure_reason: " << stbi_failure_reason() << std::endl;
         return;
     }
+    uploadTexture(path, data, width, height, nrChannels);
     stbi_image_free(data);
 }
 
+void Object::uploadTexture(const std::string& path, const unsigned char* pixels, int width, int height, int channels) {
+    texturePath = path;
+    queueTransform();
+
+    // a shared texture (a prefab's or the loaded scene's) is not ours to delete
+    if (textureID != 0 && !sharedTexture) glDeleteTextures(1, &textureID);
+    textureID = createTexture(pixels, width, height, channels);
+    sharedTexture = false;
+}
+
+GLuint Object::createTexture(const unsigned char* pixels, int width, int height, int channels) {
+    GLuint tex = 0;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    GLenum format = (channels == 4) ? GL_RGBA : GL_RGB;
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    return tex;
+}
+
 void Object::draw() const {
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, (GLsizei)meshIndices().size(), GL_UNSIGNED_INT, 0);
 }
 
 float Object::boundingRadius() const {
     // Compute a bounding radius from mesh vertex positions (in object local space),
     // and then account for object scale.
+    const std::vector<Vertex>& vertices = meshVertices();
     float maxDist = 0.0f;
     for (size_t i = 0; i < vertices.size(); ++i) {
         const Vertex& v = vertices[i];
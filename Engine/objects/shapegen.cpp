@@ -71,36 +71,23 @@ void ShapeGenerator::createCylinder(const Vec3d& start, const Vec3d& end, float
     Vec3d side = dir.cross(up).normalized();
     Vec3d up2 = side.cross(dir).normalized();
 
-    // precompute ring points, radial normals and u coordinates
-    std::vector<Vec3d> ringStart(segments);
-    std::vector<Vec3d> ringEnd(segments);
-    std::vector<Vec3d> radialNormals(segments);
-    std::vector<float> ucoords(segments);
-
-    for (int i = 0; i < segments; ++i) {
-        float theta = 2.0f * PI * (float)i / (float)segments;
-        float c = cosf(theta);
-        float s = sinf(theta);
-        Vec3d radial = side * c + up2 * s;
-        radial = radial.normalized();
-        radialNormals[i] = radial;
-        ringStart[i] = start + radial * radius;
-        ringEnd[i] = end + radial * radius;
-        ucoords[i] = (float)i / (float)segments;
-    }
-
     Vec3d color = {1,1,1};
 
-    // SIDE: push shared ring vertices (start ring then end ring)
+    // SIDE: push shared ring vertices (start ring then end ring). The rest of the mesh reads the
+    // ring back from these vertices, so no temporary arrays are needed.
     unsigned int sideStartIndex = outVertices.size();
-    for (int i = 0; i < segments; ++i) {
-        // start ring vertex
-        outVertices.push_back(Vertex( ringStart[i], color, radialNormals[i], Vec2d(ucoords[i], 0.0f) ));
-    }
-    for (int i = 0; i < segments; ++i) {
-        // end ring vertex
-        outVertices.push_back(Vertex( ringEnd[i], color, radialNormals[i], Vec2d(ucoords[i], 1.0f) ));
+    outVertices.reserve(outVertices.size() + 4 * segments + 2);
+    for (int ring = 0; ring < 2; ++ring) {
+        const Vec3d& center = ring ? end : start;
+        for (int i = 0; i < segments; ++i) {
+            float theta = 2.0f * PI * (float)i / (float)segments;
+            Vec3d radial = (side * cosf(theta) + up2 * sinf(theta)).normalized();
+            outVertices.push_back(Vertex( center + radial * radius, color, radial, Vec2d((float)i / (float)segments, (float)ring) ));
+        }
     }
+    auto ringStart = [&](int i) { return outVertices[sideStartIndex + i].pos; };
+    auto ringEnd = [&](int i) { return outVertices[sideStartIndex + segments + i].pos; };
+    auto radialNormal = [&](int i) { return outVertices[sideStartIndex + i].normal; };
 
     // side indices (two triangles per segment) with winding check
     for (int i = 0; i < segments; ++i) {
@@ -112,11 +99,11 @@ void ShapeGenerator::createCylinder(const Vec3d& start, const Vec3d& end, float
         unsigned int e_ni  = sideStartIndex + segments + ni;
 
         // compute triangle normal using ring positions and compare with outward radial normal
-        Vec3d v0 = ringStart[i];
-        Vec3d v1 = ringStart[ni];
-        Vec3d v2 = ringEnd[ni];
+        Vec3d v0 = ringStart(i);
+        Vec3d v1 = ringStart(ni);
+        Vec3d v2 = ringEnd(ni);
         Vec3d triNormal = (v1 - v0).cross(v2 - v0);
-        float dotOut = triNormal.dot(radialNormals[i]);
+        float dotOut = triNormal.dot(radialNormal(i));
 
         if (dotOut >= 0.0f) {
             // original winding (faces outward)
@@ -150,9 +137,9 @@ void ShapeGenerator::createCylinder(const Vec3d& start, const Vec3d& end, float
 
     // push ring vertices for start cap (with cap normal and cap UV)
     for (int i = 0; i < segments; ++i) {
-        Vec3d r_i = ringStart[i] - start;
+        Vec3d r_i = ringStart(i) - start;
         Vec2d uv_i = Vec2d( 0.5f + 0.5f * (r_i.dot(side) / radius),  0.5f + 0.5f * (r_i.dot(up2) / radius) );
-        outVertices.push_back(Vertex(ringStart[i], color, capNormalStart, uv_i));
+        outVertices.push_back(Vertex(ringStart(i), color, capNormalStart, uv_i));
     }
 
     // indices for start cap: ensure winding agrees with capNormalStart
@@ -163,8 +150,8 @@ void ShapeGenerator::createCylinder(const Vec3d& start, const Vec3d& end, float
 
         // compute triangle normal for (center, ring_ni, ring_i)
         Vec3d v0c = centerStart;
-        Vec3d v1c = ringStart[ni];
-        Vec3d v2c = ringStart[i];
+        Vec3d v1c = ringStart(ni);
+        Vec3d v2c = ringStart(i);
         Vec3d triN = (v1c - v0c).cross(v2c - v0c);
         if (triN.dot(capNormalStart) >= 0.0f) {
             outIndices.push_back(capStartCenterIndex);
@@ -187,9 +174,9 @@ void ShapeGenerator::createCylinder(const Vec3d& start, const Vec3d& end, float
 
     // push ring vertices for end cap (with cap normal and cap UV)
     for (int i = 0; i < segments; ++i) {
-        Vec3d r_i = ringEnd[i] - end;
+        Vec3d r_i = ringEnd(i) - end;
         Vec2d uv_i = Vec2d( 0.5f + 0.5f * (r_i.dot(side) / radius),  0.5f + 0.5f * (r_i.dot(up2) / radius) );
-        outVertices.push_back(Vertex(ringEnd[i], color, capNormalEnd, uv_i));
+        outVertices.push_back(Vertex(ringEnd(i), color, capNormalEnd, uv_i));
     }
 
     // indices for end cap: ensure winding agrees with capNormalEnd
@@ -200,8 +187,8 @@ void ShapeGenerator::createCylinder(const Vec3d& start, const Vec3d& end, float
 
         // compute triangle normal for (center, ring_i, ring_ni)
         Vec3d v0e = centerEnd;
-        Vec3d v1e = ringEnd[i];
-        Vec3d v2e = ringEnd[ni];
+        Vec3d v1e = ringEnd(i);
+        Vec3d v2e = ringEnd(ni);
         Vec3d triNe = (v1e - v0e).cross(v2e - v0e);
         if (triNe.dot(capNormalEnd) >= 0.0f) {
             outIndices.push_back(capEndCenterIndex);
@@ -349,6 +336,60 @@ void ShapeGenerator::createSphere(float radius, int segments, int rings, std::ve
     }
 }
 
+namespace {
+struct PrimitiveTypes {
+    StringId cube, cylinder, sphere, plane, pyramid;
+
+    PrimitiveTypes() {
+        StringTable& t = StringTable::global();
+        cube = t.intern("Cube");
+        cylinder = t.intern("Cylinder");
+        sphere = t.intern("Sphere");
+        plane = t.intern("Plane");
+        pyramid = t.intern("Pyramid");
+    }
+};
+
+const PrimitiveTypes& primitiveTypes() {
+    static PrimitiveTypes types;
+    return types;
+}
+}
+
+StringId ShapeGenerator::primitiveType(const std::string& type) {
+    const PrimitiveTypes& types = primitiveTypes();
+    // find, not intern: arbitrary type names should not grow the table
+    StringId id = StringTable::global().find(type);
+    if (id == types.cylinder || id == types.sphere || id == types.plane || id == types.pyramid) return id;
+    return types.cube;
+}
+
+const char* ShapeGenerator::createPrimitive(const std::string& type, std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices) {
+    return StringTable::global().str(createPrimitive(primitiveType(type), outVertices, outIndices)).c_str();
+}
+
+StringId ShapeGenerator::createPrimitive(StringId type, std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices) {
+    const PrimitiveTypes& types = primitiveTypes();
+    if (type == types.cylinder) {
+        createCylinder(Vec3d(0.0f, -1.0f, 0.0f), Vec3d(0.0f, 1.0f, 0.0f), 0.5f, 16, outVertices, outIndices);
+        return types.cylinder;
+    }
+    if (type == types.sphere) {
+        createSphere(0.5f, 16, 16, outVertices, outIndices);
+        return types.sphere;
+    }
+    if (type == types.plane) {
+        createPlane(5.0f, 5.0f, outVertices, outIndices);
+        return types.plane;
+    }
+    if (type == types.pyramid) {
+        createPyramid(1.0f, 1.0f, outVertices, outIndices);
+        return types.pyramid;
+    }
+    createCube(1.0f, outVertices, outIndices);
+    return types.cube;
+}
+
 unsigned int loadTexture(const char* path) {
     unsigned int textureID;
     glGenTextures(1, &textureID);
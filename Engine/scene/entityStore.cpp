@@ -0,0 +1,186 @@
+#include "Engine/scene/entityStore.hpp"
+#include "Engine/objects/object.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+EntityStore::EntityStore() {}
+
+static float meshRadius(const std::vector<Vertex>& vertices) {
+    float maxSq = 0.0f;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vec3d& p = vertices[i].pos;
+        float d = p.x * p.x + p.y * p.y + p.z * p.z;
+        if (d > maxSq) maxSq = d;
+    }
+    return maxSq > 0.0f ? std::sqrt(maxSq) : 0.5f;
+}
+
+EntityHandle EntityStore::create(Object* owner) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = (uint32_t)slotToDense.size();
+        slotToDense.push_back(0);
+        slotGeneration.push_back(0);
+    }
+
+    size_t i = owners.size();
+    slotToDense[slot] = (uint32_t)i;
+    denseToSlot.push_back(slot);
+
+    owners.push_back(owner);
+    world.push_back(Mat4(1.0f));
+    boundsX.push_back(0.0f);
+    boundsY.push_back(0.0f);
+    boundsZ.push_back(0.0f);
+    boundsRadius.push_back(0.0f);
+    vaos.push_back(0);
+    indexCounts.push_back(0);
+    textures.push_back(0);
+    versions.push_back(0);
+    localRadius.push_back(0.0f);
+
+    // The matrix is picked up by the next refresh(), after the caller has placed the object.
+    vaos[i] = owner->VAO;
+    localRadius[i] = meshRadius(owner->meshVertices());
+    indexCounts[i] = (GLsizei)owner->meshIndices().size();
+    textures[i] = owner->textureID;
+    return EntityHandle(slot, slotGeneration[slot]);
+}
+
+void EntityStore::reserve(size_t count) {
+    owners.reserve(count);
+    world.reserve(count);
+    boundsX.reserve(count);
+    boundsY.reserve(count);
+    boundsZ.reserve(count);
+    boundsRadius.reserve(count);
+    vaos.reserve(count);
+    indexCounts.reserve(count);
+    textures.reserve(count);
+    versions.reserve(count);
+    localRadius.reserve(count);
+    denseToSlot.reserve(count);
+    slotToDense.reserve(count);
+    slotGeneration.reserve(count);
+    freeSlots.reserve(count);
+}
+
+EntityHandle EntityStore::slotHandle(uint32_t slot) const {
+    if (slot >= slotToDense.size()) return EntityHandle();
+    uint32_t i = slotToDense[slot];
+    if (i >= denseToSlot.size() || denseToSlot[i] != slot) return EntityHandle();
+    return EntityHandle(slot, slotGeneration[slot]);
+}
+
+void EntityStore::destroy(EntityHandle handle) {
+    if (!valid(handle)) return;
+
+    size_t i = slotToDense[handle.index];
+    size_t last = owners.size() - 1;
+    if (i != last) {
+        owners[i] = owners[last];
+        world[i] = world[last];
+        boundsX[i] = boundsX[last];
+        boundsY[i] = boundsY[last];
+        boundsZ[i] = boundsZ[last];
+        boundsRadius[i] = boundsRadius[last];
+        vaos[i] = vaos[last];
+        indexCounts[i] = indexCounts[last];
+        textures[i] = textures[last];
+        versions[i] = versions[last];
+        localRadius[i] = localRadius[last];
+        denseToSlot[i] = denseToSlot[last];
+        slotToDense[denseToSlot[i]] = (uint32_t)i;
+    }
+
+    owners.pop_back();
+    world.pop_back();
+    boundsX.pop_back();
+    boundsY.pop_back();
+    boundsZ.pop_back();
+    boundsRadius.pop_back();
+    vaos.pop_back();
+    indexCounts.pop_back();
+    textures.pop_back();
+    versions.pop_back();
+    localRadius.pop_back();
+    denseToSlot.pop_back();
+
+    ++slotGeneration[handle.index];
+    freeSlots.push_back(handle.index);
+}
+
+void EntityStore::clear() {
+    // bump every live slot so outstanding handles go stale
+    for (size_t i = 0; i < denseToSlot.size(); ++i) {
+        ++slotGeneration[denseToSlot[i]];
+        freeSlots.push_back(denseToSlot[i]);
+    }
+    owners.clear();
+    world.clear();
+    boundsX.clear();
+    boundsY.clear();
+    boundsZ.clear();
+    boundsRadius.clear();
+    vaos.clear();
+    indexCounts.clear();
+    textures.clear();
+    versions.clear();
+    localRadius.clear();
+    denseToSlot.clear();
+}
+
+bool EntityStore::valid(EntityHandle handle) const {
+    if (handle.index >= slotGeneration.size()) return false;
+    if (slotGeneration[handle.index] != handle.generation) return false;
+    uint32_t i = slotToDense[handle.index];
+    return i < denseToSlot.size() && denseToSlot[i] == handle.index;
+}
+
+Object* EntityStore::object(EntityHandle handle) const {
+    return valid(handle) ? owners[slotToDense[handle.index]] : nullptr;
+}
+
+void EntityStore::refresh(size_t i) {
+    Object* o = owners[i];
+
+    bool meshChanged = o->VAO != vaos[i];
+    if (meshChanged) {
+        vaos[i] = o->VAO;
+        localRadius[i] = meshRadius(o->meshVertices());
+    }
+    indexCounts[i] = (GLsizei)o->meshIndices().size();
+    textures[i] = o->textureID;
+
+    if (!meshChanged && o->transformVersion() == versions[i]) return;
+
+    const Mat4& m = o->getModelMatrix();
+    versions[i] = o->transformVersion();
+    world[i] = m;
+
+    // meshes are centred on their origin, so the bounds follow the world matrix
+    boundsX[i] = m.m[3][0];
+    boundsY[i] = m.m[3][1];
+    boundsZ[i] = m.m[3][2];
+    float s = 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        float len = m.m[c][0] * m.m[c][0] + m.m[c][1] * m.m[c][1] + m.m[c][2] * m.m[c][2];
+        s = std::max(s, len);
+    }
+    boundsRadius[i] = localRadius[i] * std::sqrt(s);
+}
+
+void EntityStore::refresh(EntityHandle handle) {
+    if (valid(handle)) refresh(slotToDense[handle.index]);
+}
+
+void EntityStore::rebuild(const std::vector<Object*>& objects) {
+    clear();
+    for (size_t k = 0; k < objects.size(); ++k) {
+        if (objects[k]) objects[k]->entity = create(objects[k]);
+    }
+}
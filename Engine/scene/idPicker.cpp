@@ -0,0 +1,229 @@
+#include "Engine/scene/idPicker.hpp"
+#include "Engine/util/shaderc.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+uint32_t IdPicker::Result::nearest() const {
+    int best = -1;
+    int bestD2 = 0;
+    for (int py = 0; py < height; ++py) {
+        for (int px = 0; px < width; ++px) {
+            uint32_t id = ids[(size_t)py * width + px];
+            if (id == 0) continue;
+            int dx = x + px - centerX;
+            int dy = y + py - centerY;
+            int d2 = dx * dx + dy * dy;
+            if (best < 0 || d2 < bestD2) {
+                best = py * width + px;
+                bestD2 = d2;
+            }
+        }
+    }
+    return best < 0 ? 0 : ids[best];
+}
+
+void IdPicker::Result::unique(std::vector<uint32_t>& out) const {
+    out.clear();
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (ids[i] != 0) out.push_back(ids[i]);
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+IdPicker::IdPicker()
+    : program(0), idLoc(-1), texture(0), pointVao(0), pointVbo(0),
+      width(0), height(0), readHead(0), readCount(0), passPurpose(-1), prevFbo(0) {
+    for (int i = 0; i < 3; ++i) queued[i].queued = false;
+    for (int i = 0; i < READBACKS; ++i) {
+        readbacks[i].pbo = 0;
+        readbacks[i].capacity = 0;
+        readbacks[i].fence = 0;
+    }
+}
+
+void IdPicker::shutdown() {
+    for (int i = 0; i < READBACKS; ++i) {
+        if (readbacks[i].fence) glDeleteSync(readbacks[i].fence);
+        if (readbacks[i].pbo) glDeleteBuffers(1, &readbacks[i].pbo);
+        readbacks[i].fence = 0;
+        readbacks[i].pbo = 0;
+        readbacks[i].capacity = 0;
+    }
+    if (texture) glDeleteTextures(1, &texture);
+    if (pointVbo) glDeleteBuffers(1, &pointVbo);
+    if (pointVao) glDeleteVertexArrays(1, &pointVao);
+    Shaderc::releaseProgram(program);
+    texture = pointVbo = pointVao = program = 0;
+    idLoc = -1;
+    readHead = readCount = 0;
+    width = height = 0;
+}
+
+bool IdPicker::init() {
+    if (program != 0) return true;
+
+    // not waited on; wantsPass() stays false until it has linked
+    Shaderc compiler;
+    program = compiler.submit("shaders/picking/id_vert.glsl", "shaders/picking/id_frag.glsl");
+    if (program == 0) {
+        std::cerr << "[IdPicker] Failed to load ID shader, picking stays on the CPU." << std::endl;
+        return false;
+    }
+
+    for (int i = 0; i < READBACKS; ++i) glGenBuffers(1, &readbacks[i].pbo);
+
+    const float origin[3] = { 0.0f, 0.0f, 0.0f };
+    glGenVertexArrays(1, &pointVao);
+    glGenBuffers(1, &pointVbo);
+    glBindVertexArray(pointVao);
+    glBindBuffer(GL_ARRAY_BUFFER, pointVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(origin), origin, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glBindVertexArray(0);
+    return true;
+}
+
+void IdPicker::resize(GLuint fbo, int w, int h) {
+    if (program == 0 || w <= 0 || h <= 0) return;
+    width = w;
+    height = h;
+
+    if (texture == 0) glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, w, h, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLint prev = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prev);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, texture, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)prev);
+}
+
+void IdPicker::queue(Purpose purpose, int x0, int y0, int x1, int y1, int cx, int cy) {
+    if (program == 0 || width <= 0 || height <= 0) return;
+    x0 = std::max(0, std::min(x0, width - 1));
+    x1 = std::max(0, std::min(x1, width - 1));
+    y0 = std::max(0, std::min(y0, height - 1));
+    y1 = std::max(0, std::min(y1, height - 1));
+
+    Request& r = queued[purpose];
+    r.queued = true;
+    r.x = std::min(x0, x1);
+    r.y = std::min(y0, y1);
+    r.width = std::abs(x1 - x0) + 1;
+    r.height = std::abs(y1 - y0) + 1;
+    r.centerX = cx;
+    r.centerY = cy;
+}
+
+void IdPicker::requestPoint(Purpose purpose, float u, float v, int radius) {
+    int cx = (int)(u * (float)width);
+    int cy = (int)(v * (float)height);
+    queue(purpose, cx - radius, cy - radius, cx + radius, cy + radius, cx, cy);
+}
+
+void IdPicker::requestRect(Purpose purpose, float u0, float v0, float u1, float v1) {
+    int x0 = (int)(u0 * (float)width), y0 = (int)(v0 * (float)height);
+    int x1 = (int)(u1 * (float)width), y1 = (int)(v1 * (float)height);
+    queue(purpose, x0, y0, x1, y1, (x0 + x1) / 2, (y0 + y1) / 2);
+}
+
+bool IdPicker::wantsPass() const {
+    if (program == 0 || readCount == READBACKS || !Shaderc::ready(program)) return false;
+    return queued[CLICK].queued || queued[MARQUEE].queued || queued[HOVER].queued;
+}
+
+GLuint IdPicker::beginPass(GLuint fbo) {
+    passPurpose = -1;
+    if (!wantsPass()) return 0;
+    const Purpose order[3] = { CLICK, MARQUEE, HOVER };
+    for (int i = 0; i < 3; ++i) {
+        if (queued[order[i]].queued) { passPurpose = order[i]; break; }
+    }
+
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    const GLenum idBuffer = GL_COLOR_ATTACHMENT1;
+    glDrawBuffers(1, &idBuffer);
+
+    const GLuint clearId[4] = { 0, 0, 0, 0 };
+    glClearBufferuiv(GL_COLOR, 0, clearId);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    glUseProgram(program);
+    if (idLoc < 0) idLoc = glGetUniformLocation(program, "uId");
+    return program;
+}
+
+void IdPicker::setId(uint32_t id) {
+    glUniform1ui(idLoc, id);
+}
+
+void IdPicker::endPass() {
+    if (passPurpose < 0) return;
+
+    Request& r = queued[passPurpose];
+    Readback& rb = readbacks[(readHead + readCount) % READBACKS];
+    size_t bytes = (size_t)r.width * r.height * sizeof(uint32_t);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.pbo);
+    if (bytes > rb.capacity) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)bytes, NULL, GL_STREAM_READ);
+        rb.capacity = bytes;
+    }
+    glReadBuffer(GL_COLOR_ATTACHMENT1);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(r.x, r.y, r.width, r.height, GL_RED_INTEGER, GL_UNSIGNED_INT, (void*)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    rb.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    rb.purpose = (Purpose)passPurpose;
+    rb.region = r;
+    ++readCount;
+    r.queued = false;
+
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    const GLenum colorBuffer = GL_COLOR_ATTACHMENT0;
+    glDrawBuffers(1, &colorBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)prevFbo);
+    passPurpose = -1;
+}
+
+bool IdPicker::poll(Result& out) {
+    if (readCount == 0) return false;
+    Readback& rb = readbacks[readHead];
+
+    GLenum status = glClientWaitSync(rb.fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+    glDeleteSync(rb.fence);
+    rb.fence = 0;
+
+    const Request& r = rb.region;
+    size_t count = (size_t)r.width * r.height;
+    out.purpose = rb.purpose;
+    out.x = r.x; out.y = r.y;
+    out.width = r.width; out.height = r.height;
+    out.centerX = r.centerX; out.centerY = r.centerY;
+    out.ids.resize(count);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.pbo);
+    void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)(count * sizeof(uint32_t)), GL_MAP_READ_BIT);
+    if (data) {
+        memcpy(&out.ids[0], data, count * sizeof(uint32_t));
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        std::fill(out.ids.begin(), out.ids.end(), 0u);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readHead = (readHead + 1) % READBACKS;
+    --readCount;
+    return true;
+}
@@ -0,0 +1,109 @@
+#include "Engine/scene/objectIndex.hpp"
+#include "Engine/objects/object.hpp"
+
+#include <algorithm>
+
+ObjectIndex::ObjectIndex(const EntityStore& entities) : entities(entities) {}
+
+void ObjectIndex::add(EntityHandle handle, StringId name, uint32_t tags) {
+    byName[name].handles.push_back(handle);
+    for (int bit = 0; bit < MAX_TAGS; ++bit) {
+        if (tags & (1u << bit)) byTag[bit].handles.push_back(handle);
+    }
+}
+
+void ObjectIndex::remove(StringId name, uint32_t tags) {
+    std::unordered_map<StringId, Bucket>::iterator it = byName.find(name);
+    if (it != byName.end()) {
+        markStale(it->second);
+        if (it->second.handles.empty()) byName.erase(it);
+    }
+    for (int bit = 0; bit < MAX_TAGS; ++bit) {
+        if (tags & (1u << bit)) markStale(byTag[bit]);
+    }
+}
+
+void ObjectIndex::rename(EntityHandle handle, StringId oldName, StringId newName) {
+    if (oldName == newName) return;
+    std::unordered_map<StringId, Bucket>::iterator it = byName.find(oldName);
+    if (it != byName.end()) {
+        erase(it->second, handle);
+        if (it->second.handles.empty()) byName.erase(it);
+    }
+    byName[newName].handles.push_back(handle);
+}
+
+void ObjectIndex::retag(EntityHandle handle, uint32_t oldTags, uint32_t newTags) {
+    for (int bit = 0; bit < MAX_TAGS; ++bit) {
+        uint32_t mask = 1u << bit;
+        if ((oldTags & mask) && !(newTags & mask)) erase(byTag[bit], handle);
+        if (!(oldTags & mask) && (newTags & mask)) byTag[bit].handles.push_back(handle);
+    }
+}
+
+void ObjectIndex::reserveName(StringId name, size_t count) {
+    Bucket& bucket = byName[name];
+    bucket.handles.reserve(bucket.handles.size() + count);
+}
+
+void ObjectIndex::clear() {
+    byName.clear();
+    for (int bit = 0; bit < MAX_TAGS; ++bit) {
+        byTag[bit].handles.clear();
+        byTag[bit].stale = 0;
+    }
+}
+
+EntityHandle ObjectIndex::findFirst(StringId name) {
+    std::unordered_map<StringId, Bucket>::iterator it = byName.find(name);
+    if (it == byName.end()) return EntityHandle();
+    Bucket& bucket = it->second;
+    if (bucket.stale) compact(bucket);
+    return bucket.handles.empty() ? EntityHandle() : bucket.handles[0];
+}
+
+void ObjectIndex::findAll(StringId name, std::vector<EntityHandle>& out) {
+    std::unordered_map<StringId, Bucket>::iterator it = byName.find(name);
+    if (it == byName.end()) return;
+    Bucket& bucket = it->second;
+    if (bucket.stale) compact(bucket);
+    out.insert(out.end(), bucket.handles.begin(), bucket.handles.end());
+}
+
+void ObjectIndex::findTagged(uint32_t mask, std::vector<EntityHandle>& out) {
+    if (mask == 0) return;
+
+    // walk the smallest bucket among the requested tags, filter by the rest
+    Bucket* smallest = nullptr;
+    for (int bit = 0; bit < MAX_TAGS; ++bit) {
+        if (!(mask & (1u << bit))) continue;
+        Bucket& bucket = byTag[bit];
+        if (bucket.stale) compact(bucket);
+        if (!smallest || bucket.handles.size() < smallest->handles.size()) smallest = &bucket;
+    }
+
+    for (size_t i = 0; i < smallest->handles.size(); ++i) {
+        EntityHandle h = smallest->handles[i];
+        if ((entities.object(h)->tags & mask) == mask) out.push_back(h);
+    }
+}
+
+void ObjectIndex::markStale(Bucket& bucket) {
+    // compacting only once half the bucket is dead keeps removal amortized O(1)
+    ++bucket.stale;
+    if (bucket.stale * 2 >= bucket.handles.size()) compact(bucket);
+}
+
+void ObjectIndex::compact(Bucket& bucket) {
+    size_t kept = 0;
+    for (size_t i = 0; i < bucket.handles.size(); ++i) {
+        if (entities.valid(bucket.handles[i])) bucket.handles[kept++] = bucket.handles[i];
+    }
+    bucket.handles.resize(kept);
+    bucket.stale = 0;
+}
+
+void ObjectIndex::erase(Bucket& bucket, EntityHandle handle) {
+    std::vector<EntityHandle>::iterator it = std::find(bucket.handles.begin(), bucket.handles.end(), handle);
+    if (it != bucket.handles.end()) bucket.handles.erase(it);
+}
@@ -0,0 +1,141 @@
+#include "Engine/scene/objectPool.hpp"
+#include "Engine/objects/object.hpp"
+
+#include <iostream>
+
+#include "Engine/util/frameArena.hpp"
+
+// Smallest slab allocated when a pool runs dry without prewarm.
+static const size_t MIN_SLAB_SIZE = 32;
+
+ObjectPool::ObjectPool() {}
+
+ObjectPool::~ObjectPool() {
+    for (size_t i = 0; i < prefabs.size(); ++i) delete prefabs[i].templ;
+    for (size_t i = 0; i < slabs.size(); ++i) delete[] slabs[i];
+}
+
+ObjectPool::PrefabId ObjectPool::registerPrefab(const std::string& name, const std::string& type, const std::string& texturePath) {
+    PrefabId existing = findPrefab(name);
+    if (existing != INVALID_PREFAB) return existing;
+
+    Object* templ = new Object();
+    templ->typeId = ShapeGenerator::createPrimitive(ShapeGenerator::primitiveType(type), templ->vertices, templ->indices);
+    templ->type = StringTable::global().str(templ->typeId);
+    templ->setupMesh();
+    if (!texturePath.empty()) templ->texture(texturePath);
+    templ->name = name;
+    templ->nameId = StringTable::global().intern(name);
+
+    Prefab prefab;
+    prefab.name = templ->nameId;
+    prefab.templ = templ;
+    prefab.capacity = 0;
+    prefabs.push_back(prefab);
+    return (PrefabId)(prefabs.size() - 1);
+}
+
+ObjectPool::PrefabId ObjectPool::findPrefab(const std::string& name) const {
+    StringId id = StringTable::global().find(name);
+    if (id == StringTable::NOT_FOUND) return INVALID_PREFAB;
+    for (size_t i = 0; i < prefabs.size(); ++i) {
+        if (prefabs[i].name == id) return (PrefabId)i;
+    }
+    return INVALID_PREFAB;
+}
+
+void ObjectPool::grow(Prefab& prefab, PrefabId id, size_t count) {
+    FrameAllocator::expectAllocations();
+    Object* slab = new Object[count];
+    slabs.push_back(slab);
+    prefab.capacity += count;
+    prefab.freeList.reserve(prefab.capacity);
+
+    const Object* templ = prefab.templ;
+    for (size_t i = 0; i < count; ++i) {
+        Object* o = &slab[i];
+        o->prefab = id;
+        o->meshSource = templ;
+        o->name = templ->name;
+        o->nameId = templ->nameId;
+        o->type = templ->type;
+        o->typeId = templ->typeId;
+        o->VAO = templ->VAO;
+        o->VBO = templ->VBO;
+        o->EBO = templ->EBO;
+        o->textureID = templ->textureID;
+        o->sharedTexture = true;
+        o->texturePath = templ->texturePath;
+        prefab.freeList.push_back(o);
+    }
+}
+
+void ObjectPool::prewarm(PrefabId prefab, size_t count) {
+    if (prefab < 0 || prefab >= (PrefabId)prefabs.size()) return;
+    Prefab& p = prefabs[prefab];
+    if (p.freeList.size() < count) grow(p, prefab, count - p.freeList.size());
+}
+
+Object* ObjectPool::acquire(PrefabId prefab) {
+    if (prefab < 0 || prefab >= (PrefabId)prefabs.size()) return nullptr;
+    Prefab& p = prefabs[prefab];
+    if (p.freeList.empty()) {
+        std::cerr << "[ObjectPool] Prefab '" << p.templ->name << "' ran out of instances, growing" << std::endl;
+        grow(p, prefab, p.capacity > MIN_SLAB_SIZE ? p.capacity : MIN_SLAB_SIZE);
+    }
+
+    Object* o = p.freeList.back();
+    p.freeList.pop_back();
+
+    // Back to the prefab's defaults: every per-instance field, the last user may have changed
+    // any of them. Strings are only reassigned if they differ, so reuse does not allocate.
+    const Object* templ = p.templ;
+    if (o->nameId != templ->nameId) {
+        o->name = templ->name;
+        o->nameId = templ->nameId;
+    }
+    if (o->typeId != templ->typeId) {
+        o->type = templ->type;
+        o->typeId = templ->typeId;
+    }
+    o->position = Vec3d(0.0f);
+    o->rotation = Vec3d(0.0f);
+    o->scale = Vec3d(1.0f);
+    o->tags = 0;
+    o->isStatic = false;
+    o->parent = nullptr;
+    o->children.clear();
+    o->transformQueue = nullptr;
+    o->transformQueueIndex = -1;
+    o->dynamicIndex = -1;
+    o->meshSource = templ;
+    o->VAO = templ->VAO;
+    o->VBO = templ->VBO;
+    o->EBO = templ->EBO;
+    o->textureID = templ->textureID;
+    o->sharedTexture = true;
+    if (o->texturePath != templ->texturePath) o->texturePath = templ->texturePath;
+    o->markDirty();
+    return o;
+}
+
+void ObjectPool::release(Object* obj) {
+    if (!obj || obj->prefab < 0 || obj->prefab >= (PrefabId)prefabs.size()) return;
+    // A free instance must not point into the scene: its parent and children may be deleted
+    // before it is acquired again.
+    while (!obj->children.empty()) obj->children.back()->setParent(nullptr);
+    obj->setParent(nullptr);
+    obj->entity = EntityHandle();
+    obj->id = 0;
+    prefabs[obj->prefab].freeList.push_back(obj);
+}
+
+StringId ObjectPool::prefabName(PrefabId prefab) const {
+    if (prefab < 0 || prefab >= (PrefabId)prefabs.size()) return StringTable::NONE;
+    return prefabs[prefab].name;
+}
+
+size_t ObjectPool::freeCount(PrefabId prefab) const {
+    if (prefab < 0 || prefab >= (PrefabId)prefabs.size()) return 0;
+    return prefabs[prefab].freeList.size();
+}
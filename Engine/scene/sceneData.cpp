@@ -0,0 +1,80 @@
+#include "Engine/scene/sceneData.hpp"
+
+#include <cstring>
+
+SceneData::SceneData() {
+    clear();
+}
+
+void SceneData::clear() {
+    positions.clear();
+    rotations.clear();
+    scales.clear();
+    names.clear();
+    types.clear();
+    texturePaths.clear();
+
+    lightTypes.clear();
+    lightPositions.clear();
+    lightDirections.clear();
+    lightColors.clear();
+    lightIntensities.clear();
+
+    strings.clear();
+    strings.push_back('\0'); // EMPTY_STRING
+    sharedStrings.clear();
+}
+
+void SceneData::reserve(size_t objectCount, size_t lightCount, size_t stringBytes) {
+    positions.reserve(objectCount * 3);
+    rotations.reserve(objectCount * 3);
+    scales.reserve(objectCount * 3);
+    names.reserve(objectCount);
+    types.reserve(objectCount);
+    texturePaths.reserve(objectCount);
+
+    lightTypes.reserve(lightCount);
+    lightPositions.reserve(lightCount * 3);
+    lightDirections.reserve(lightCount * 3);
+    lightColors.reserve(lightCount * 3);
+    lightIntensities.reserve(lightCount);
+
+    strings.reserve(stringBytes);
+}
+
+uint32_t SceneData::addString(const char* s, size_t len) {
+    if (len == 0) return EMPTY_STRING;
+    uint32_t offset = (uint32_t)strings.size();
+    strings.resize(strings.size() + len + 1);
+    std::memcpy(&strings[offset], s, len);
+    strings[offset + len] = '\0';
+    return offset;
+}
+
+uint32_t SceneData::addSharedString(const std::string& s) {
+    if (s.empty()) return EMPTY_STRING;
+    std::unordered_map<std::string, uint32_t>::const_iterator it = sharedStrings.find(s);
+    if (it != sharedStrings.end()) return it->second;
+    uint32_t offset = addString(s);
+    sharedStrings[s] = offset;
+    return offset;
+}
+
+void SceneData::addObject(uint32_t name, uint32_t type, uint32_t texturePath,
+                          const Vec3d& position, const Vec3d& rotation, const Vec3d& scale) {
+    names.push_back(name);
+    types.push_back(type);
+    texturePaths.push_back(texturePath);
+    push3(positions, position);
+    push3(rotations, rotation);
+    push3(scales, scale);
+}
+
+void SceneData::addLight(LightType type, const Vec3d& position, const Vec3d& direction,
+                         const Vec3d& color, float intensity) {
+    lightTypes.push_back((uint32_t)type);
+    push3(lightPositions, position);
+    push3(lightDirections, direction);
+    push3(lightColors, color);
+    lightIntensities.push_back(intensity);
+}
@@ -0,0 +1,147 @@
+#include "Engine/scene/sceneGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// xorshift64*: the standard <random> distributions differ between standard libraries,
+// this keeps a seed's scene identical everywhere.
+class Random {
+public:
+    explicit Random(uint32_t seed) : state(0x9E3779B97F4A7C15ull ^ ((uint64_t)seed << 1 | 1)) {
+        for (int i = 0; i < 4; ++i) next();
+    }
+
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ull;
+    }
+
+    float unit() { return (float)(next() >> 40) / (float)(1u << 24); }            // [0, 1)
+    float range(float lo, float hi) { return lo + (hi - lo) * unit(); }
+    size_t index(size_t n) { return n ? (size_t)(next() % n) : 0; }
+    // Rough normal distribution: sum of three uniforms, in [-1, 1].
+    float bell() { return (unit() + unit() + unit()) * (2.0f / 3.0f) - 1.0f; }
+
+private:
+    uint64_t state;
+};
+
+const char* const TYPE_NAMES[] = { "Cube", "Sphere", "Cylinder", "Pyramid", "Plane" };
+
+} // namespace
+
+SceneGenSettings::SceneGenSettings() {
+    textures.push_back("textures/peppa.png");
+    textures.push_back("textures/yoda.png");
+    textures.push_back("textures/yoda2.png");
+}
+
+SceneGenSettings& SceneGenSettings::setObjectCount(size_t total) {
+    cubes = spheres = cylinders = pyramids = total / 4;
+    cubes += total % 4;
+    planes = 0;
+    return *this;
+}
+
+bool SceneGenSettings::parseDistribution(const std::string& name, Distribution& out) {
+    if (name == "uniform") out = UNIFORM;
+    else if (name == "clustered") out = CLUSTERED;
+    else if (name == "grid") out = GRID;
+    else return false;
+    return true;
+}
+
+const char* SceneGenSettings::distributionName(Distribution d) {
+    switch (d) {
+    case UNIFORM: return "uniform";
+    case CLUSTERED: return "clustered";
+    case GRID: return "grid";
+    }
+    return "?";
+}
+
+void SceneGenerator::generate(const SceneGenSettings& s, SceneData& out) {
+    Random rng(s.seed);
+    const size_t objectCount = s.objectCount();
+    const size_t lightCount = s.directionalLights + s.pointLights;
+
+    // about one object per 4 square units unless told otherwise
+    const float extent = s.extent > 0.0f ? s.extent : std::max(10.0f, std::sqrt((float)objectCount) * 1.0f);
+    const float clusterRadius = s.clusterRadius > 0.0f ? s.clusterRadius
+                                : extent / std::max(2.0f, std::sqrt((float)std::max<size_t>(s.clusters, 1)) * 2.0f);
+
+    out.clear();
+    out.reserve(objectCount + (s.ground ? 1 : 0), lightCount, objectCount * 16 + 256);
+
+    // Types interleaved in a shuffled order, so a grid does not come out in bands.
+    const size_t perType[] = { s.cubes, s.spheres, s.cylinders, s.pyramids, s.planes };
+    uint32_t typeIds[5];
+    for (int t = 0; t < 5; ++t) typeIds[t] = out.addSharedString(TYPE_NAMES[t]);
+    std::vector<uint8_t> order;
+    order.reserve(objectCount);
+    for (int t = 0; t < 5; ++t) order.insert(order.end(), perType[t], (uint8_t)t);
+    for (size_t i = order.size(); i > 1; --i) std::swap(order[i - 1], order[rng.index(i)]);
+
+    const size_t variety = std::min(s.textureVariety, s.textures.size());
+    std::vector<uint32_t> textureIds(variety);
+    for (size_t t = 0; t < variety; ++t) textureIds[t] = out.addSharedString(s.textures[t]);
+
+    std::vector<Vec3d> centers(s.distribution == SceneGenSettings::CLUSTERED ? std::max<size_t>(s.clusters, 1) : 0);
+    for (size_t c = 0; c < centers.size(); ++c) {
+        centers[c] = Vec3d(rng.range(-extent, extent), 0.0f, rng.range(-extent, extent));
+    }
+    const size_t side = std::max<size_t>(1, (size_t)std::ceil(std::sqrt((double)objectCount)));
+    const float spacing = 2.0f * extent / (float)side;
+
+    char name[64];
+    std::vector<size_t> typeCounters(5, 0);
+    for (size_t i = 0; i < objectCount; ++i) {
+        const int type = order[i];
+        Vec3d pos;
+        switch (s.distribution) {
+        case SceneGenSettings::UNIFORM:
+            pos = Vec3d(rng.range(-extent, extent), 0.0f, rng.range(-extent, extent));
+            break;
+        case SceneGenSettings::CLUSTERED: {
+            const Vec3d& c = centers[rng.index(centers.size())];
+            pos = Vec3d(c.x + rng.bell() * clusterRadius, 0.0f, c.z + rng.bell() * clusterRadius);
+            break;
+        }
+        case SceneGenSettings::GRID:
+            pos = Vec3d(-extent + spacing * ((float)(i % side) + 0.5f), 0.0f,
+                        -extent + spacing * ((float)(i / side) + 0.5f));
+            break;
+        }
+        const float scale = rng.range(0.5f, 1.5f);
+        pos.y = scale * 0.5f + rng.range(0.0f, 2.0f) * rng.unit();   // mostly near the ground
+
+        uint32_t texture = SceneData::EMPTY_STRING;
+        if (variety && rng.unit() < s.texturedFraction) texture = textureIds[rng.index(variety)];
+
+        snprintf(name, sizeof(name), "%s_%zu", TYPE_NAMES[type], typeCounters[type]++);
+        out.addObject(out.addString(name), typeIds[type], texture, pos,
+                      Vec3d(0.0f, rng.range(0.0f, 360.0f), 0.0f), Vec3d(scale));
+    }
+
+    if (s.ground) {
+        const float size = (extent + clusterRadius) * 2.0f + 4.0f;
+        out.addObject(out.addString("Ground"), typeIds[4], SceneData::EMPTY_STRING,
+                      Vec3d(0.0f), Vec3d(0.0f), Vec3d(size, 1.0f, size));
+    }
+
+    for (size_t i = 0; i < s.directionalLights; ++i) {
+        Vec3d dir = Vec3d(rng.range(-0.6f, 0.6f), -1.0f, rng.range(-0.6f, 0.6f)).normalized();
+        // the first sun is the key light, the rest are dimmer fills
+        out.addLight(LightType::Directional, Vec3d(0.0f), dir, Vec3d(1.0f, 0.96f, 0.9f), i == 0 ? 1.0f : 0.3f);
+    }
+    for (size_t i = 0; i < s.pointLights; ++i) {
+        Vec3d pos(rng.range(-extent, extent), rng.range(2.0f, 6.0f), rng.range(-extent, extent));
+        Vec3d color(rng.range(0.6f, 1.0f), rng.range(0.6f, 1.0f), rng.range(0.6f, 1.0f));
+        out.addLight(LightType::Point, pos, Vec3d(0.0f, -1.0f, 0.0f), color, rng.range(4.0f, 16.0f));
+    }
+}
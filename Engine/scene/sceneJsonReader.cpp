@@ -0,0 +1,359 @@
+#include "Engine/scene/sceneJsonReader.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const int MAX_SKIP_DEPTH = 256;
+
+SceneJsonReader::SceneJsonReader()
+    : text(nullptr), size(0), pos(0), data(nullptr), errorPos(0) {}
+
+size_t SceneJsonReader::errorLine() const {
+    size_t line = 1;
+    for (size_t i = 0; i < errorPos && i < size; ++i) {
+        if (text[i] == '\n') ++line;
+    }
+    return line;
+}
+
+bool SceneJsonReader::read(const char* t, size_t n, SceneData& out) {
+    text = t;
+    size = n;
+    pos = 0;
+    data = &out;
+    errorMessage.clear();
+    errorPos = 0;
+
+    // Every object/light record is a '{', so the brace count bounds the record count.
+    // Reserving up front keeps the arrays from reallocating while they fill.
+    size_t braces = 0;
+    for (const char* p = text; (p = (const char*)std::memchr(p, '{', (size_t)(text + size - p))) != nullptr; ++p) {
+        ++braces;
+    }
+    out.clear();
+    out.reserve(braces, 0, size / 8);
+
+    if (!parseScene()) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SceneJsonReader::fail(const char* message) {
+    if (errorMessage.empty()) {
+        errorMessage = message;
+        errorPos = pos;
+    }
+    return false;
+}
+
+void SceneJsonReader::skipWhitespace() {
+    while (pos < size) {
+        char c = text[pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+        ++pos;
+    }
+}
+
+bool SceneJsonReader::peek(char c) {
+    skipWhitespace();
+    return pos < size && text[pos] == c;
+}
+
+bool SceneJsonReader::expect(char c) {
+    skipWhitespace();
+    if (pos >= size) return fail("unexpected end of input");
+    if (text[pos] != c) {
+        char msg[32];
+        snprintf(msg, sizeof(msg), "expected '%c'", c);
+        return fail(msg);
+    }
+    ++pos;
+    return true;
+}
+
+// Iterates "key": value pairs of a JSON object; body is run with 'key' set and the
+// cursor on the value, and must consume it.
+#define FOR_EACH_MEMBER(body)                                        \
+    if (!expect('{')) return false;                                  \
+    if (peek('}')) { ++pos; } else {                                 \
+        for (;;) {                                                   \
+            if (!parseString(key)) return false;                     \
+            if (!expect(':')) return false;                          \
+            body                                                     \
+            if (peek(',')) { ++pos; continue; }                      \
+            if (!expect('}')) return false;                          \
+            break;                                                   \
+        }                                                            \
+    }
+
+// Iterates the elements of a JSON array; body must consume one element.
+#define FOR_EACH_ELEMENT(body)                                       \
+    if (!expect('[')) return false;                                  \
+    if (peek(']')) { ++pos; } else {                                 \
+        for (;;) {                                                   \
+            body                                                     \
+            if (peek(',')) { ++pos; continue; }                      \
+            if (!expect(']')) return false;                          \
+            break;                                                   \
+        }                                                            \
+    }
+
+bool SceneJsonReader::parseScene() {
+    bool hasObjects = false;
+    FOR_EACH_MEMBER(
+        if (key == "objects") {
+            if (!peek('[')) return fail("'objects' must be an array");
+            if (!parseObjects()) return false;
+            hasObjects = true;
+        } else if (key == "lights") {
+            if (!peek('[')) return fail("'lights' must be an array");
+            if (!parseLights()) return false;
+        } else if (!skipValue()) {
+            return false;
+        }
+    )
+    skipWhitespace();
+    if (pos != size) return fail("trailing characters after scene");
+    if (!hasObjects) {
+        pos = 0;
+        return fail("no 'objects' array in scene");
+    }
+    return true;
+}
+
+bool SceneJsonReader::parseObjects() {
+    FOR_EACH_ELEMENT(
+        if (!parseObjectRecord()) return false;
+    )
+    return true;
+}
+
+bool SceneJsonReader::parseLights() {
+    FOR_EACH_ELEMENT(
+        if (!parseLightRecord()) return false;
+    )
+    return true;
+}
+
+bool SceneJsonReader::parseObjectRecord() {
+    uint32_t name = SceneData::EMPTY_STRING;
+    uint32_t type = SceneData::EMPTY_STRING;
+    uint32_t texture = SceneData::EMPTY_STRING;
+    bool hasName = false, hasType = false;
+    Vec3d position(0.0f), rotation(0.0f), scale(1.0f);
+
+    FOR_EACH_MEMBER(
+        if (key == "name") {
+            if (!parseString(scratch)) return false;
+            name = data->addString(scratch);
+            hasName = true;
+        } else if (key == "type") {
+            if (!parseString(scratch)) return false;
+            type = data->addSharedString(scratch);
+            hasType = true;
+        } else if (key == "texturePath") {
+            if (!parseString(scratch)) return false;
+            texture = data->addSharedString(scratch);
+        } else if (key == "position") {
+            if (!parseVec3(position)) return false;
+        } else if (key == "rotation") {
+            if (!parseVec3(rotation)) return false;
+        } else if (key == "scale") {
+            if (!parseVec3(scale)) return false;
+        } else if (!skipValue()) {
+            return false;
+        }
+    )
+
+    if (!hasType) type = data->addSharedString("Cube");
+    if (!hasName) name = type;
+    data->addObject(name, type, texture, position, rotation, scale);
+    return true;
+}
+
+bool SceneJsonReader::parseLightRecord() {
+    LightType type = LightType::Directional;
+    Vec3d position(0.0f), direction(0.0f, -1.0f, 0.0f), color(1.0f);
+    float intensity = 1.0f;
+
+    FOR_EACH_MEMBER(
+        if (key == "type") {
+            if (!parseString(scratch)) return false;
+            type = (scratch == "Directional") ? LightType::Directional : LightType::Point;
+        } else if (key == "position") {
+            if (!parseVec3(position)) return false;
+        } else if (key == "direction") {
+            if (!parseVec3(direction)) return false;
+        } else if (key == "color") {
+            if (!parseVec3(color)) return false;
+        } else if (key == "intensity") {
+            if (!parseNumber(intensity)) return false;
+        } else if (!skipValue()) {
+            return false;
+        }
+    )
+
+    data->addLight(type, position, direction, color, intensity);
+    return true;
+}
+
+// Arrays that are not exactly three numbers leave 'out' untouched, like the old loader.
+bool SceneJsonReader::parseVec3(Vec3d& out) {
+    float v[3] = { 0.0f, 0.0f, 0.0f };
+    int count = 0;
+    if (!peek('[')) return fail("expected an array of 3 numbers");
+    FOR_EACH_ELEMENT(
+        float f = 0.0f;
+        if (!parseNumber(f)) return false;
+        if (count < 3) v[count] = f;
+        ++count;
+    )
+    if (count == 3) out = Vec3d(v[0], v[1], v[2]);
+    return true;
+}
+
+bool SceneJsonReader::parseNumber(float& out) {
+    skipWhitespace();
+    size_t start = pos;
+    while (pos < size) {
+        char c = text[pos];
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') ++pos;
+        else break;
+    }
+    size_t len = pos - start;
+    char buf[64];
+    if (len == 0 || len >= sizeof(buf)) {
+        pos = start;
+        return fail("expected a number");
+    }
+    // the input is not null-terminated (it may be a memory mapping), so copy the token out
+    std::memcpy(buf, text + start, len);
+    buf[len] = '\0';
+    char* end = nullptr;
+    double d = std::strtod(buf, &end);
+    if (end != buf + len) {
+        pos = start;
+        return fail("malformed number");
+    }
+    out = (float)d;
+    return true;
+}
+
+static void appendUtf8(std::string& out, unsigned int cp) {
+    if (cp < 0x80) {
+        out += (char)cp;
+    } else if (cp < 0x800) {
+        out += (char)(0xC0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += (char)(0xE0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    } else {
+        out += (char)(0xF0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3F));
+        out += (char)(0x80 | ((cp >> 6) & 0x3F));
+        out += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+static bool parseHex4(const char* p, unsigned int& out) {
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = p[i];
+        out <<= 4;
+        if (c >= '0' && c <= '9') out |= (unsigned int)(c - '0');
+        else if (c >= 'a' && c <= 'f') out |= (unsigned int)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') out |= (unsigned int)(c - 'A' + 10);
+        else return false;
+    }
+    return true;
+}
+
+bool SceneJsonReader::parseString(std::string& out) {
+    if (!expect('"')) return false;
+    out.clear();
+    for (;;) {
+        // copy runs of plain characters in one go
+        size_t runStart = pos;
+        while (pos < size && text[pos] != '"' && text[pos] != '\\' && (unsigned char)text[pos] >= 0x20) ++pos;
+        out.append(text + runStart, pos - runStart);
+
+        if (pos >= size) return fail("unterminated string");
+        char c = text[pos];
+        if (c == '"') { ++pos; return true; }
+        if (c != '\\') return fail("control character in string");
+
+        if (pos + 1 >= size) return fail("unterminated escape sequence");
+        char e = text[pos + 1];
+        pos += 2;
+        switch (e) {
+        case '"':  out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/':  out += '/'; break;
+        case 'b':  out += '\b'; break;
+        case 'f':  out += '\f'; break;
+        case 'n':  out += '\n'; break;
+        case 'r':  out += '\r'; break;
+        case 't':  out += '\t'; break;
+        case 'u': {
+            unsigned int cp = 0;
+            if (pos + 4 > size || !parseHex4(text + pos, cp)) return fail("invalid \\u escape");
+            pos += 4;
+            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                unsigned int lo = 0;
+                if (pos + 6 > size || text[pos] != '\\' || text[pos + 1] != 'u' || !parseHex4(text + pos + 2, lo) ||
+                    lo < 0xDC00 || lo > 0xDFFF) {
+                    return fail("invalid surrogate pair");
+                }
+                pos += 6;
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+            }
+            appendUtf8(out, cp);
+            break;
+        }
+        default:
+            pos -= 2;
+            return fail("invalid escape sequence");
+        }
+    }
+}
+
+bool SceneJsonReader::skipLiteral(const char* literal) {
+    size_t len = std::strlen(literal);
+    if (pos + len > size || std::memcmp(text + pos, literal, len) != 0) return fail("invalid literal");
+    pos += len;
+    return true;
+}
+
+bool SceneJsonReader::skipValue(int depth) {
+    if (depth > MAX_SKIP_DEPTH) return fail("nesting too deep");
+    skipWhitespace();
+    if (pos >= size) return fail("unexpected end of input");
+
+    char c = text[pos];
+    if (c == '{') {
+        FOR_EACH_MEMBER(
+            if (!skipValue(depth + 1)) return false;
+        )
+        return true;
+    }
+    if (c == '[') {
+        FOR_EACH_ELEMENT(
+            if (!skipValue(depth + 1)) return false;
+        )
+        return true;
+    }
+    if (c == '"') return parseString(scratch);
+    if (c == 't') return skipLiteral("true");
+    if (c == 'f') return skipLiteral("false");
+    if (c == 'n') return skipLiteral("null");
+    float ignored = 0.0f;
+    return parseNumber(ignored);
+}
+
+#undef FOR_EACH_MEMBER
+#undef FOR_EACH_ELEMENT
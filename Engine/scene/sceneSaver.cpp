@@ -0,0 +1,327 @@
+#include "Engine/scene/sceneSaver.hpp"
+#include "Engine/scene/sceneSerializer.hpp"
+
+#include "nlohmann/json.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using json = nlohmann::json;
+
+// Journals are rewritten in full once they hold more appended records than this, or than
+// the scene has objects, whichever is larger.
+static const size_t MIN_COMPACT_RECORDS = 64;
+
+SceneSaver::SceneSaver()
+	: writing(false), stopping(false), lastOk(true) {}
+
+SceneSaver::~SceneSaver() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	requestAvailable.notify_all();
+	if (worker.joinable()) worker.join();
+}
+
+void SceneSaver::save(const std::string& path, SceneData& snapshot) {
+	Request request;
+	request.path = path;
+	request.incremental = false;
+	request.data = std::move(snapshot);
+	snapshot.clear();
+	enqueue(request);
+}
+
+void SceneSaver::autosave(const std::string& path, SceneData& snapshot, std::vector<uint32_t>& ids) {
+	Request request;
+	request.path = path;
+	request.incremental = true;
+	request.data = std::move(snapshot);
+	request.ids = std::move(ids);
+	snapshot.clear();
+	ids.clear();
+	enqueue(request);
+}
+
+void SceneSaver::enqueue(Request& request) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!worker.joinable()) worker = std::thread(&SceneSaver::workerLoop, this);
+
+		if (request.incremental && !queue.empty() && queue.back().incremental && queue.back().path == request.path) {
+			queue.back() = std::move(request);
+		} else {
+			queue.push_back(std::move(request));
+		}
+	}
+	requestAvailable.notify_one();
+}
+
+bool SceneSaver::busy() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return writing || !queue.empty();
+}
+
+void SceneSaver::wait() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (writing || !queue.empty()) idle.wait(lock);
+}
+
+bool SceneSaver::lastSucceeded() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return lastOk;
+}
+
+std::chrono::steady_clock::time_point SceneSaver::lastSaveFinished() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return lastSaveEnd;
+}
+
+void SceneSaver::workerLoop() {
+	for (;;) {
+		Request request;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (!stopping && queue.empty()) requestAvailable.wait(lock);
+			if (queue.empty()) return;
+			request = std::move(queue.front());
+			queue.pop_front();
+			writing = true;
+		}
+
+		bool ok;
+		if (request.incremental) {
+			ok = writeJournal(request);
+		} else {
+			ok = SceneSerializer::save(request.path, request.data);
+			if (ok) std::cerr << "[SceneSaver] Saved " << request.path << "\n";
+		}
+		if (!ok) std::cerr << "[SceneSaver] Failed to save " << request.path << "\n";
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			writing = false;
+			lastOk = ok;
+			if (!request.incremental) lastSaveEnd = std::chrono::steady_clock::now();
+			if (queue.empty()) idle.notify_all();
+		}
+	}
+}
+
+// ---------------------------------------------------------------- journal
+
+static json vec3ToJson(const std::vector<float>& v, size_t i) {
+	json arr = json::array();
+	arr.push_back(v[i * 3 + 0]); arr.push_back(v[i * 3 + 1]); arr.push_back(v[i * 3 + 2]);
+	return arr;
+}
+
+static Vec3d jsonToVec3(const json& j, const char* key, const Vec3d& fallback) {
+	json::const_iterator it = j.find(key);
+	if (it == j.end() || !it->is_array() || it->size() != 3) return fallback;
+	return Vec3d((*it)[0].get<float>(), (*it)[1].get<float>(), (*it)[2].get<float>());
+}
+
+static std::string jsonString(const json& j, const char* key) {
+	json::const_iterator it = j.find(key);
+	return (it != j.end() && it->is_string()) ? it->get<std::string>() : std::string();
+}
+
+static void appendObjectRecord(std::string& out, const SceneData& d, size_t i, uint32_t id) {
+	json r;
+	r["op"] = "object";
+	r["id"] = id;
+	r["name"] = d.str(d.names[i]);
+	r["type"] = d.str(d.types[i]);
+	r["texturePath"] = d.str(d.texturePaths[i]);
+	r["position"] = vec3ToJson(d.positions, i);
+	r["rotation"] = vec3ToJson(d.rotations, i);
+	r["scale"] = vec3ToJson(d.scales, i);
+	out += r.dump();
+	out += '\n';
+}
+
+static void appendLightsRecord(std::string& out, const SceneData& d) {
+	json r;
+	r["op"] = "lights";
+	r["lights"] = json::array();
+	for (size_t i = 0; i < d.lightCount(); ++i) {
+		json l;
+		l["type"] = d.lightTypes[i];
+		l["position"] = vec3ToJson(d.lightPositions, i);
+		l["direction"] = vec3ToJson(d.lightDirections, i);
+		l["color"] = vec3ToJson(d.lightColors, i);
+		l["intensity"] = d.lightIntensities[i];
+		r["lights"].push_back(l);
+	}
+	out += r.dump();
+	out += '\n';
+}
+
+static bool sameObject(const SceneData& a, size_t i, const SceneData& b, size_t j) {
+	return std::memcmp(&a.positions[i * 3], &b.positions[j * 3], 3 * sizeof(float)) == 0 &&
+	       std::memcmp(&a.rotations[i * 3], &b.rotations[j * 3], 3 * sizeof(float)) == 0 &&
+	       std::memcmp(&a.scales[i * 3], &b.scales[j * 3], 3 * sizeof(float)) == 0 &&
+	       std::strcmp(a.str(a.names[i]), b.str(b.names[j])) == 0 &&
+	       std::strcmp(a.str(a.types[i]), b.str(b.types[j])) == 0 &&
+	       std::strcmp(a.str(a.texturePaths[i]), b.str(b.texturePaths[j])) == 0;
+}
+
+static bool sameLights(const SceneData& a, const SceneData& b) {
+	return a.lightTypes == b.lightTypes && a.lightPositions == b.lightPositions &&
+	       a.lightDirections == b.lightDirections && a.lightColors == b.lightColors &&
+	       a.lightIntensities == b.lightIntensities;
+}
+
+bool SceneSaver::writeJournal(Request& request) {
+	const SceneData& cur = request.data;
+	std::unordered_map<std::string, JournalState>::iterator it = journals.find(request.path);
+
+	bool full = (it == journals.end());
+	if (!full) {
+		size_t limit = cur.objectCount() > MIN_COMPACT_RECORDS ? cur.objectCount() : MIN_COMPACT_RECORDS;
+		// also start over if someone removed the journal behind our back
+		full = it->second.appendedRecords > limit || !std::ifstream(request.path).good();
+	}
+
+	std::string records;
+	size_t recordCount = 0;
+
+	if (full) {
+		records.reserve(cur.objectCount() * 160);
+		for (size_t i = 0; i < cur.objectCount(); ++i) appendObjectRecord(records, cur, i, request.ids[i]);
+		appendLightsRecord(records, cur);
+
+		std::string tmpPath = request.path + ".tmp";
+		{
+			std::ofstream file(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) return false;
+			file.write(records.data(), (std::streamsize)records.size());
+			file.flush();
+			if (!file.good()) return false;
+		}
+		if (!SceneSerializer::replaceFile(tmpPath, request.path)) return false;
+	} else {
+		const JournalState& prev = it->second;
+		std::unordered_map<uint32_t, bool> seen;
+
+		for (size_t i = 0; i < cur.objectCount(); ++i) {
+			uint32_t id = request.ids[i];
+			seen[id] = true;
+			std::unordered_map<uint32_t, uint32_t>::const_iterator p = prev.indexOfId.find(id);
+			if (p == prev.indexOfId.end() || !sameObject(cur, i, prev.data, p->second)) {
+				appendObjectRecord(records, cur, i, id);
+				++recordCount;
+			}
+		}
+		for (std::unordered_map<uint32_t, uint32_t>::const_iterator p = prev.indexOfId.begin(); p != prev.indexOfId.end(); ++p) {
+			if (seen.find(p->first) != seen.end()) continue;
+			json r;
+			r["op"] = "remove";
+			r["id"] = p->first;
+			records += r.dump();
+			records += '\n';
+			++recordCount;
+		}
+		if (!sameLights(cur, prev.data)) {
+			appendLightsRecord(records, cur);
+			++recordCount;
+		}
+
+		if (!records.empty()) {
+			std::ofstream file(request.path, std::ios::out | std::ios::binary | std::ios::app);
+			if (!file.is_open()) return false;
+			file.write(records.data(), (std::streamsize)records.size());
+			file.flush();
+			if (!file.good()) return false;
+		}
+	}
+
+	JournalState& state = journals[request.path];
+	state.appendedRecords = full ? 0 : state.appendedRecords + recordCount;
+	state.indexOfId.clear();
+	for (size_t i = 0; i < request.ids.size(); ++i) state.indexOfId[request.ids[i]] = (uint32_t)i;
+	state.data = std::move(request.data);
+
+	if (full) std::cerr << "[SceneSaver] Autosave journal written: " << request.path << "\n";
+	return true;
+}
+
+bool SceneSaver::loadJournal(const std::string& path, SceneData& out) {
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		std::cerr << "[SceneSaver] Failed to open " << path << "\n";
+		return false;
+	}
+
+	std::vector<uint32_t> order;
+	std::unordered_map<uint32_t, json> objects;
+	json lights = json::array();
+
+	std::string line;
+	size_t lineNo = 0;
+	while (std::getline(file, line)) {
+		++lineNo;
+		if (line.empty()) continue;
+
+		json r;
+		try {
+			r = json::parse(line);
+		} catch (const std::exception& e) {
+			// a crash mid-append leaves a torn last record; everything before it is good
+			std::cerr << "[SceneSaver] " << path << ": stopping at line " << lineNo << ": " << e.what() << "\n";
+			break;
+		}
+		if (!r.is_object()) continue;
+
+		std::string op = jsonString(r, "op");
+		if (op == "object" || op == "remove") {
+			json::const_iterator idIt = r.find("id");
+			if (idIt == r.end() || !idIt->is_number()) continue;
+			uint32_t id = idIt->get<uint32_t>();
+			if (op == "remove") {
+				objects.erase(id);
+			} else {
+				if (objects.find(id) == objects.end()) order.push_back(id);
+				objects[id] = r;
+			}
+		} else if (op == "lights") {
+			json::const_iterator l = r.find("lights");
+			if (l != r.end() && l->is_array()) lights = *l;
+		}
+	}
+
+	out.clear();
+	out.reserve(objects.size(), lights.size(), objects.size() * 16);
+	for (size_t i = 0; i < order.size(); ++i) {
+		std::unordered_map<uint32_t, json>::iterator o = objects.find(order[i]);
+		if (o == objects.end()) continue;
+		const json& r = o->second;
+		std::string type = jsonString(r, "type");
+		out.addObject(out.addString(jsonString(r, "name")),
+		              out.addSharedString(type.empty() ? "Cube" : type),
+		              out.addSharedString(jsonString(r, "texturePath")),
+		              jsonToVec3(r, "position", Vec3d(0.0f)),
+		              jsonToVec3(r, "rotation", Vec3d(0.0f)),
+		              jsonToVec3(r, "scale", Vec3d(1.0f)));
+		// an id removed and re-added shows up in 'order' twice; emit it once
+		objects.erase(o);
+	}
+
+	for (size_t i = 0; i < lights.size(); ++i) {
+		const json& l = lights[i];
+		json::const_iterator t = l.find("type");
+		LightType type = (t != l.end() && t->is_number()) ? (LightType)t->get<int>() : LightType::Directional;
+		json::const_iterator in = l.find("intensity");
+		float intensity = (in != l.end() && in->is_number()) ? in->get<float>() : 1.0f;
+		out.addLight(type,
+		             jsonToVec3(l, "position", Vec3d(0.0f)),
+		             jsonToVec3(l, "direction", Vec3d(0.0f, -1.0f, 0.0f)),
+		             jsonToVec3(l, "color", Vec3d(1.0f)),
+		             intensity);
+	}
+	return true;
+}
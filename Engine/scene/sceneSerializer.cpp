@@ -0,0 +1,266 @@
+#include "Engine/scene/sceneSerializer.hpp"
+#include "Engine/scene/sceneJsonReader.hpp"
+#include "Engine/util/mappedFile.hpp"
+
+#include "nlohmann/json.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+using json = nlohmann::json;
+
+static const char SCENE_BINARY_MAGIC[4] = { 'G', 'S', 'C', 'B' };
+static const uint64_t SECTION_ALIGN = 16;
+
+static uint64_t alignUp(uint64_t v) {
+	return (v + SECTION_ALIGN - 1) & ~(SECTION_ALIGN - 1);
+}
+
+static bool endsWith(const std::string& s, const std::string& suffix) {
+	return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool SceneSerializer::isBinaryPath(const std::string& path) {
+	return endsWith(path, ".gsceneb");
+}
+
+bool SceneSerializer::load(const std::string& path, SceneData& out) {
+	char magic[4] = { 0, 0, 0, 0 };
+	{
+		std::ifstream f(path, std::ios::in | std::ios::binary);
+		if (!f.is_open()) {
+			std::cerr << "[SceneSerializer] Failed to open " << path << "\n";
+			return false;
+		}
+		f.read(magic, sizeof(magic));
+	}
+	if (std::memcmp(magic, SCENE_BINARY_MAGIC, sizeof(magic)) == 0) return readBinary(path, out);
+	return readJson(path, out);
+}
+
+// Writes next to the target and renames over it, so a crash mid-save never leaves a
+// truncated scene behind.
+bool SceneSerializer::save(const std::string& path, const SceneData& data) {
+	std::string tmpPath = path + ".tmp";
+	bool ok = isBinaryPath(path) ? writeBinary(tmpPath, data) : writeJson(tmpPath, data);
+	if (!ok) {
+		std::remove(tmpPath.c_str());
+		return false;
+	}
+	return replaceFile(tmpPath, path);
+}
+
+bool SceneSerializer::replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+	bool ok = MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	bool ok = std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+	if (!ok) {
+		std::cerr << "[SceneSerializer] Failed to replace " << to << " with " << from << "\n";
+		std::remove(from.c_str());
+	}
+	return ok;
+}
+
+bool SceneSerializer::convert(const std::string& srcPath, const std::string& dstPath) {
+	SceneData data;
+	if (!load(srcPath, data)) return false;
+	return save(dstPath, data);
+}
+
+// ---------------------------------------------------------------- JSON
+
+static json vec3ToJson(const Vec3d& v) {
+	json arr = json::array();
+	arr.push_back(v.x); arr.push_back(v.y); arr.push_back(v.z);
+	return arr;
+}
+
+bool SceneSerializer::readJson(const std::string& path, SceneData& out) {
+	MappedFile file;
+	if (!file.open(path)) return false;
+
+	SceneJsonReader reader;
+	if (!reader.read((const char*)file.data(), file.size(), out)) {
+		std::cerr << "[SceneSerializer] " << path << ": byte " << reader.errorOffset()
+		          << " (line " << reader.errorLine() << "): " << reader.error() << "\n";
+		return false;
+	}
+	return true;
+}
+
+bool SceneSerializer::writeJson(const std::string& path, const SceneData& data) {
+	json j;
+	j["objects"] = json::array();
+
+	for (size_t i = 0; i < data.objectCount(); ++i) {
+		json o;
+		const char* type = data.str(data.types[i]);
+		o["name"] = data.str(data.names[i]);
+		o["type"] = (*type == '\0') ? "Cube" : type;
+		o["position"] = vec3ToJson(data.position(i));
+		o["rotation"] = vec3ToJson(data.rotation(i));
+		o["scale"] = vec3ToJson(data.scale(i));
+		o["texturePath"] = data.str(data.texturePaths[i]);
+		j["objects"].push_back(o);
+	}
+
+	j["lights"] = json::array();
+
+	for (size_t i = 0; i < data.lightCount(); ++i) {
+		json l;
+		l["type"] = (data.lightType(i) == LightType::Directional) ? "Directional" : "Point";
+		l["position"] = vec3ToJson(data.lightPosition(i));
+		l["direction"] = vec3ToJson(data.lightDirection(i));
+		l["color"] = vec3ToJson(data.lightColor(i));
+		l["intensity"] = data.lightIntensities[i];
+		j["lights"].push_back(l);
+	}
+
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "[SceneSerializer] Failed to open " << path << " for writing\n";
+		return false;
+	}
+	file << j.dump(4);
+	file.flush();
+	return file.good();
+}
+
+// ---------------------------------------------------------------- binary
+
+static uint64_t expectedSectionSize(int section, uint32_t objects, uint32_t lights, uint32_t stringBytes) {
+	switch (section) {
+	case SceneBinaryHeader::OBJ_POSITIONS:
+	case SceneBinaryHeader::OBJ_ROTATIONS:
+	case SceneBinaryHeader::OBJ_SCALES:        return (uint64_t)objects * 3 * sizeof(float);
+	case SceneBinaryHeader::OBJ_NAMES:
+	case SceneBinaryHeader::OBJ_TYPES:
+	case SceneBinaryHeader::OBJ_TEXTURES:      return (uint64_t)objects * sizeof(uint32_t);
+	case SceneBinaryHeader::LIGHT_TYPES:       return (uint64_t)lights * sizeof(uint32_t);
+	case SceneBinaryHeader::LIGHT_POSITIONS:
+	case SceneBinaryHeader::LIGHT_DIRECTIONS:
+	case SceneBinaryHeader::LIGHT_COLORS:      return (uint64_t)lights * 3 * sizeof(float);
+	case SceneBinaryHeader::LIGHT_INTENSITIES: return (uint64_t)lights * sizeof(float);
+	case SceneBinaryHeader::STRINGS:           return stringBytes;
+	default:                                   return 0;
+	}
+}
+
+template <typename T>
+static void copySection(const unsigned char* bytes, const SceneBinaryHeader& h, int section, std::vector<T>& out) {
+	size_t count = (size_t)(h.sectionSizes[section] / sizeof(T));
+	out.resize(count);
+	if (count) std::memcpy(&out[0], bytes + h.sectionOffsets[section], count * sizeof(T));
+}
+
+bool SceneSerializer::readBinary(const std::string& path, SceneData& out) {
+	MappedFile file;
+	if (!file.open(path)) return false;
+	if (!readBinary(file.data(), file.size(), out)) {
+		std::cerr << "[SceneSerializer] Invalid binary scene: " << path << "\n";
+		return false;
+	}
+	return true;
+}
+
+bool SceneSerializer::readBinary(const unsigned char* bytes, size_t size, SceneData& out) {
+	if (!bytes || size < sizeof(SceneBinaryHeader)) return false;
+
+	SceneBinaryHeader h;
+	std::memcpy(&h, bytes, sizeof(h));
+	if (std::memcmp(h.magic, SCENE_BINARY_MAGIC, sizeof(h.magic)) != 0) return false;
+	if (h.version != SceneBinaryHeader::VERSION || h.headerSize != sizeof(SceneBinaryHeader)) {
+		std::cerr << "[SceneSerializer] Unsupported binary scene version " << h.version << "\n";
+		return false;
+	}
+
+	for (int s = 0; s < SceneBinaryHeader::SECTION_COUNT; ++s) {
+		if (h.sectionSizes[s] != expectedSectionSize(s, h.objectCount, h.lightCount, h.stringBytes)) return false;
+		if (h.sectionOffsets[s] > size || h.sectionSizes[s] > size - h.sectionOffsets[s]) return false;
+	}
+
+	// the string table must be terminated and every offset must point inside it
+	if (h.stringBytes == 0 || bytes[h.sectionOffsets[SceneBinaryHeader::STRINGS] + h.stringBytes - 1] != '\0') return false;
+
+	out.clear();
+	copySection(bytes, h, SceneBinaryHeader::OBJ_POSITIONS, out.positions);
+	copySection(bytes, h, SceneBinaryHeader::OBJ_ROTATIONS, out.rotations);
+	copySection(bytes, h, SceneBinaryHeader::OBJ_SCALES, out.scales);
+	copySection(bytes, h, SceneBinaryHeader::OBJ_NAMES, out.names);
+	copySection(bytes, h, SceneBinaryHeader::OBJ_TYPES, out.types);
+	copySection(bytes, h, SceneBinaryHeader::OBJ_TEXTURES, out.texturePaths);
+	copySection(bytes, h, SceneBinaryHeader::LIGHT_TYPES, out.lightTypes);
+	copySection(bytes, h, SceneBinaryHeader::LIGHT_POSITIONS, out.lightPositions);
+	copySection(bytes, h, SceneBinaryHeader::LIGHT_DIRECTIONS, out.lightDirections);
+	copySection(bytes, h, SceneBinaryHeader::LIGHT_COLORS, out.lightColors);
+	copySection(bytes, h, SceneBinaryHeader::LIGHT_INTENSITIES, out.lightIntensities);
+	copySection(bytes, h, SceneBinaryHeader::STRINGS, out.strings);
+
+	for (size_t i = 0; i < out.objectCount(); ++i) {
+		if (out.names[i] >= h.stringBytes || out.types[i] >= h.stringBytes || out.texturePaths[i] >= h.stringBytes) {
+			out.clear();
+			return false;
+		}
+	}
+	// unknown light types (a corrupt or newer file) are rejected rather than cast to some LightType
+	for (size_t i = 0; i < out.lightCount(); ++i) {
+		if (out.lightTypes[i] != (uint32_t)LightType::Directional && out.lightTypes[i] != (uint32_t)LightType::Point) {
+			out.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SceneSerializer::writeBinary(const std::string& path, const SceneData& data) {
+	SceneBinaryHeader h;
+	std::memset(&h, 0, sizeof(h));
+	std::memcpy(h.magic, SCENE_BINARY_MAGIC, sizeof(h.magic));
+	h.version = SceneBinaryHeader::VERSION;
+	h.headerSize = sizeof(SceneBinaryHeader);
+	h.objectCount = (uint32_t)data.objectCount();
+	h.lightCount = (uint32_t)data.lightCount();
+	h.stringBytes = (uint32_t)data.strings.size();
+
+	const void* sections[SceneBinaryHeader::SECTION_COUNT] = {
+		data.positions.data(), data.rotations.data(), data.scales.data(),
+		data.names.data(), data.types.data(), data.texturePaths.data(),
+		data.lightTypes.data(), data.lightPositions.data(), data.lightDirections.data(),
+		data.lightColors.data(), data.lightIntensities.data(),
+		data.strings.data()
+	};
+
+	uint64_t offset = alignUp(sizeof(SceneBinaryHeader));
+	for (int s = 0; s < SceneBinaryHeader::SECTION_COUNT; ++s) {
+		h.sectionOffsets[s] = offset;
+		h.sectionSizes[s] = expectedSectionSize(s, h.objectCount, h.lightCount, h.stringBytes);
+		offset = alignUp(offset + h.sectionSizes[s]);
+	}
+
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		std::cerr << "[SceneSerializer] Failed to open " << path << " for writing\n";
+		return false;
+	}
+
+	static const char padding[SECTION_ALIGN] = { 0 };
+	file.write((const char*)&h, sizeof(h));
+	uint64_t written = sizeof(h);
+	for (int s = 0; s < SceneBinaryHeader::SECTION_COUNT; ++s) {
+		file.write(padding, (std::streamsize)(h.sectionOffsets[s] - written));
+		file.write((const char*)sections[s], (std::streamsize)h.sectionSizes[s]);
+		written = h.sectionOffsets[s] + h.sectionSizes[s];
+	}
+	file.flush();
+	return file.good();
+}
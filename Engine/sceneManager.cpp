@@ -2,13 +2,34 @@
 #include <iostream>
 #include <sstream>
 #include "Engine/util/shaderc.hpp"
-#include <sys/stat.h>
+#include "Engine/scene/sceneSerializer.hpp"
+#include "Engine/util/threadPool.hpp"
+#include "Engine/math/simdMath.hpp"
+#include "Engine/util/frameArena.hpp"
+#include "Engine/util/profiler.hpp"
+#include "Engine/gizmos/debugDraw.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
 
 extern int glShaderType;
 static GLuint s_unlitProgram = 0;
 static Shaderc s_shaderCompiler;
-static time_t s_unlitVertMtime = 0;
-static time_t s_unlitFragMtime = 0;
+static GLuint s_unlitPending = 0;	// submitted, replaces s_unlitProgram once it links
+static const char* s_unlitVertPath = "shaders/unlit/vertex.glsl";
+static const char* s_unlitFragPath = "shaders/unlit/fragment.glsl";
+static const char* s_shadowDepthVertPath = "shaders/shadows/shadow_depth_vert.glsl";
+static const char* s_shadowDepthFragPath = "shaders/shadows/shadow_depth_frag.glsl";
+static const char* s_pointDepthVertPath = "shaders/shadows/point_depth_vert.glsl";
+static const char* s_pointDepthFragPath = "shaders/shadows/point_depth_frag.glsl";
+static const char* s_gridVertPath = "shaders/grid/grid_vert.glsl";
+static const char* s_gridFragPath = "shaders/grid/grid_frag.glsl";
+static GLuint s_emptyShadowMap = 0;	// 1x1 depth texture for shadowMap[] slots without a light
+
+// Scene files written by this process also show up as watcher events; ignore those for a while.
+static const std::chrono::seconds OWN_SAVE_GRACE(2);
 
 SceneManager::SceneManager()
 		: selectedObject(NULL),
@@ -21,18 +42,62 @@ SceneManager::SceneManager()
 			axisGrabDistance(0.12f),
 			gizmoLineWidth(10.0f),
 			axisVAO(0), axisVBO(0),
-			lightVAO(0), lightVBO(0),
 			selectedLightIndex(-1),
 			objCounter(0),
-			gridVAO(0), gridVBO(0), gridVertexCount(0)
+			hoveredLightIndex(-1),
+			objectIndex(entities),
+			gridVAO(0), gridProgram(0), gridSpacing(1.0f)
 {
 
-	shadowDepthProgram = s_shaderCompiler.loadShader("shaders/shadows/shadow_depth_vert.glsl", "shaders/shadows/shadow_depth_frag.glsl");
+	// Submitted, not waited on: the driver compiles while the scene loads, and render() skips
+	// each pass until its program has linked.
+	shadowDepthProgram = s_shaderCompiler.submit(s_shadowDepthVertPath, s_shadowDepthFragPath);
 	if (shadowDepthProgram == 0) {
 		std::cerr << "[SceneManager] Failed to load shadow depth shader!" << std::endl;
-	} else {
-		std::cerr << "[SceneManager] shadowDepthProgram id = " << shadowDepthProgram << std::endl;
 	}
+	pointShadowDepthProgram = s_shaderCompiler.submit(s_pointDepthVertPath, s_pointDepthFragPath);
+	if (pointShadowDepthProgram == 0) {
+		std::cerr << "[SceneManager] Failed to load point shadow depth shader, point lights stay unshadowed." << std::endl;
+	}
+	// the unlit program too, so switching to it later does not stall a frame
+	if (s_unlitProgram == 0 && s_unlitPending == 0) {
+		s_unlitPending = s_shaderCompiler.submit(s_unlitVertPath, s_unlitFragPath);
+	}
+}
+
+SceneManager::~SceneManager() {
+	saver.wait();
+	clearScene();
+	if (shadowDepthProgram) Shaderc::releaseProgram(shadowDepthProgram);
+	if (pointShadowDepthProgram) Shaderc::releaseProgram(pointShadowDepthProgram);
+	if (shadowDepthPending) Shaderc::releaseProgram(shadowDepthPending);
+	if (pointShadowDepthPending) Shaderc::releaseProgram(pointShadowDepthPending);
+	if (gridProgram) Shaderc::releaseProgram(gridProgram);
+	if (gridPending) Shaderc::releaseProgram(gridPending);
+}
+
+// Hot reload: onAssetChanged resubmits a program into 'pending', and the pass that uses it
+// swaps it in once it links. A broken edit keeps the previous program.
+static void resubmitProgram(GLuint& pending, const char* vertPath, const char* fragPath) {
+	if (pending != 0) Shaderc::releaseProgram(pending);
+	pending = s_shaderCompiler.submit(vertPath, fragPath);
+}
+
+// Returns true if 'program' was replaced.
+static bool swapWhenLinked(GLuint& program, GLuint& pending, const char* name) {
+	if (pending == 0) return false;
+	if (Shaderc::ready(pending)) {
+		if (program != 0) Shaderc::releaseProgram(program);
+		program = pending;
+		pending = 0;
+		return true;
+	}
+	if (Shaderc::failed(pending)) {
+		std::cerr << "[SceneManager] Failed to load " << name << " shader, keeping the previous one." << std::endl;
+		Shaderc::releaseProgram(pending);
+		pending = 0;
+	}
+	return false;
 }
 
 static bool readFileToString(const std::string& path, std::string& out) {
@@ -45,16 +110,46 @@ static bool readFileToString(const std::string& path, std::string& out) {
 }
 
 void SceneManager::clearScene() {
+	// Everything goes, so drop the hierarchy links first: no object (pooled ones included)
+	// may be left pointing at one deleted before it.
 	for (size_t i = 0; i < objects.size(); i++) {
-		delete objects[i];
+		objects[i]->parent = nullptr;
+		objects[i]->children.clear();
+		objects[i]->transformQueue = nullptr;
+		objects[i]->transformQueueIndex = -1;
+		objects[i]->dynamicIndex = -1;
 	}
+	transformQueue.clear();
+	dynamicObjects.clear();
+	for (size_t i = 0; i < objects.size(); i++) {
+		if (objects[i]->prefab >= 0) pool.release(objects[i]);
+		else delete objects[i];
+	}
+	// the loaded scene's shared meshes and textures go with the last object using them
+	for (size_t i = 0; i < sceneMeshes.size(); i++) {
+		Object* mesh = sceneMeshes[i];
+		glDeleteVertexArrays(1, &mesh->VAO);
+		glDeleteBuffers(1, &mesh->VBO);
+		glDeleteBuffers(1, &mesh->EBO);
+		delete mesh;
+	}
+	sceneMeshes.clear();
+	if (!sceneTextures.empty()) glDeleteTextures((GLsizei)sceneTextures.size(), &sceneTextures[0]);
+	sceneTextures.clear();
 
 	for (size_t i = 0; i < lightShadows.size(); i++) {
 		delete lightShadows[i];
 	}
 	
 	lightShadows.clear();
+	for (int i = 0; i < MAX_POINT_SHADOWS; ++i) {
+		delete pointShadows[i];
+		pointShadows[i] = nullptr;
+		pointShadowOwner[i] = -1;
+	}
 	objects.clear();
+	entities.clear();
+	objectIndex.clear();
 	selectedObject = nullptr;
 	grabbedAxisIndex = -1;
 	// Also clear lights when resetting the scene so loadScene replaces them
@@ -62,13 +157,10 @@ void SceneManager::clearScene() {
 	selectedLightIndex = -1;
 }
 
-static void initMeshForType(Object* obj, const std::string& type) {
-	if (type == "Cube")         obj->initCube(1.0f);
-	else if (type == "Cylinder")obj->initCylinder(0.5f, 2.0f, 16);
-	else if (type == "Sphere")  obj->initSphere(0.5f, 16, 16);
-	else if (type == "Plane")   obj->initPlane(5.0f, 5.0f);
-	else if (type == "Pyramid") obj->initPyramid(1.0f, 1.0f);
-	else                        obj->initCube(1.0f);
+static void initMeshForType(Object* obj, StringId type) {
+	obj->typeId = ShapeGenerator::createPrimitive(type, obj->vertices, obj->indices);
+	obj->type = StringTable::global().str(obj->typeId);
+	obj->setupMesh();
 }
 
 Vec3d closestPointOnLine(const Vec3d& rayOrigin, const Vec3d& rayDir,
@@ -100,17 +192,18 @@ Vec3d closestPointOnLine(const Vec3d& rayOrigin, const Vec3d& rayDir,
 }
 
 void SceneManager::initLightGizmo() {
-	// simple single-point gizmo (we use GL_POINTS) - one vertex at origin, will be translated per-light
-	Vec3d v(0.0f,0.0f,0.0f);
-	glGenVertexArrays(1, &lightVAO);
-	glGenBuffers(1, &lightVBO);
-
-	glBindVertexArray(lightVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, lightVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(Vec3d), &v, GL_DYNAMIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,sizeof(Vec3d),(void*)0);
-	glBindVertexArray(0);
+	DebugDraw::init();
+}
+
+// Points at each light plus a short ray along its direction, drawn by the next DebugDraw::flush.
+void SceneManager::queueLightGizmos(float pointSize, float selectedPointSize) {
+	float rayLen = 0.6f * std::max(1.0f, gizmoLineWidth * 0.1f);
+	for (size_t i = 0; i < lights.size(); ++i) {
+		const Vec3d& p0 = lights[i].position;
+		bool highlighted = (int)i == selectedLightIndex || (int)i == hoveredLightIndex;
+		DebugDraw::point(p0, lights[i].color, highlighted ? selectedPointSize : pointSize);
+		DebugDraw::line(p0, p0 + lights[i].direction.normalized() * rayLen, lights[i].color);
+	}
 }
 
 
@@ -127,62 +220,9 @@ void SceneManager::drawGizmo(GLuint shaderProgram, const Mat4& view, const Mat4&
 		TransformTool::drawGizmo(selectedObject->position, grabbedAxisIndex, shaderProgram, view, projection);
 	}
 
-	// Draw light gizmos + debug direction ray (unchanged)
-	if (lightVAO != 0) {
-		glBindVertexArray(lightVAO);
-		glPointSize(10.0f * gizmoLineWidth / 2.0f);
-
-		for (size_t i = 0; i < lights.size(); ++i) {
-			Mat4 model = translate(Mat4(1.0f), lights[i].position);
-			glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, model.value_ptr());
-			glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, view.value_ptr());
-			glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projection.value_ptr());
-
-			glUniform3fv(glGetUniformLocation(shaderProgram, "overrideColor"), 1, &lights[i].color[0]);
-			glUniform1i(glGetUniformLocation(shaderProgram, "useOverrideColor"), 1);
-
-			if ((int)i == selectedLightIndex) glPointSize(14.0f * gizmoLineWidth / 2.0f);
-			glDrawArrays(GL_POINTS, 0, 1);
-			if ((int)i == selectedLightIndex) glPointSize(10.0f * gizmoLineWidth / 2.0f);
-
-			Vec3d p0 = lights[i].position;
-			Vec3d dir = lights[i].direction.normalized();
-			float rayLen = 0.6f * std::max(1.0f, gizmoLineWidth * 0.1f);
-			Vec3d p1 = p0 + dir * rayLen;
-			float lineVerts[6] = {
-				(float)p0.x, (float)p0.y, (float)p0.z,
-				(float)p1.x, (float)p1.y, (float)p1.z
-			};
-
-			GLuint lineVAO = 0, lineVBO = 0;
-			glGenVertexArrays(1, &lineVAO);
-			glGenBuffers(1, &lineVBO);
-
-			glBindVertexArray(lineVAO);
-			glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(lineVerts), lineVerts, GL_STATIC_DRAW);
-
-			GLint locPos = glGetAttribLocation(shaderProgram, "aPos");
-			if (locPos >= 0) {
-				glEnableVertexAttribArray((GLuint)locPos);
-				glVertexAttribPointer((GLuint)locPos, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-			}
-
-			glUniform1i(glGetUniformLocation(shaderProgram, "useOverrideColor"), 1);
-			glUniform3fv(glGetUniformLocation(shaderProgram, "overrideColor"), 1, &lights[i].color[0]);
-
-			glDrawArrays(GL_LINES, 0, 2);
-
-			if (locPos >= 0) glDisableVertexAttribArray((GLuint)locPos);
-			glBindVertexArray(0);
-			glDeleteBuffers(1, &lineVBO);
-			glDeleteVertexArrays(1, &lineVAO);
-		}
-
-		glUniform1i(glGetUniformLocation(shaderProgram, "useOverrideColor"), 0);
-		glPointSize(1.0f);
-		glBindVertexArray(0);
-	}
+	// Light gizmos + debug direction rays, batched into one upload
+	queueLightGizmos(10.0f * gizmoLineWidth / 2.0f, 14.0f * gizmoLineWidth / 2.0f);
+	DebugDraw::flush(shaderProgram, view, projection);
 
 	// restore previously bound program
 	glUseProgram((GLuint)prevProg);
@@ -213,10 +253,10 @@ bool SceneManager::pickGizmoAxis(const Vec3d& rayOrigin, const Vec3d& rayDir, Gi
 	if (!selectedObject) return false;
 	Vec3d pos = selectedObject->position;
 
-	std::vector<GizmoAxis> axes = {
-		{{0,0,0},{1,0,0},{1,0,0},{1,0,0}}, // X
-		{{0,0,0},{0,1,0},{0,1,0},{0,1,0}}, // Y
-		{{0,0,0},{0,0,1},{0,0,1},{0,0,1}}  // Z
+	const GizmoAxis axes[3] = {
+		GizmoAxis(Vec3d(0,0,0), Vec3d(1,0,0), Vec3d(1,0,0), Vec3d(1,0,0)), // X
+		GizmoAxis(Vec3d(0,0,0), Vec3d(0,1,0), Vec3d(0,1,0), Vec3d(0,1,0)), // Y
+		GizmoAxis(Vec3d(0,0,0), Vec3d(0,0,1), Vec3d(0,0,1), Vec3d(0,0,1))  // Z
 	};
 
 	float bestT = FLT_MAX;
@@ -225,7 +265,7 @@ bool SceneManager::pickGizmoAxis(const Vec3d& rayOrigin, const Vec3d& rayDir, Gi
 
 	Vec3d rayDirNorm = rayDir.normalized();
 
-	for (size_t i = 0; i < axes.size(); ++i) {
+	for (size_t i = 0; i < 3; ++i) {
 		GizmoAxis axis = axes[i];
 
 		// world-space endpoints of the axis segment
@@ -278,31 +318,38 @@ bool SceneManager::pickGizmoAxis(const Vec3d& rayOrigin, const Vec3d& rayDir, Gi
 			}
 		}
 
-		if (triHit) {
-			Vec3d closest = closestPointOnLine(rayOrigin, rayDir, p1, axisDir);
-			float proj = (closest - p1).dot(axisDirNorm);
-
+		if (triHit && tHit >= 0.0f && tHit < bestT) {
 			// choose the closest hit in world space
-			if (tHit >= 0.0f && tHit < bestT) {
-				bestT = tHit;
-				hit = true;
-				hitIndex = (int)i;
-
-				GizmoAxis worldAxis = axis;
-				worldAxis.start = p1;
-				worldAxis.end = p2;
-				worldAxis.dir = axisDir;
-				worldAxis.initialProj = proj;
-				worldAxis.initialObjPos = selectedObject ? selectedObject->position : Vec3d(0.0f);
-				outAxis = worldAxis;
-			}
+			bestT = tHit;
+			hit = true;
+			hitIndex = (int)i;
 		}
 	}
 
-	if (hit) grabbedAxisIndex = hitIndex;
-	else grabbedAxisIndex = -1;
+	if (hit) return grabGizmoAxis(hitIndex, rayOrigin, rayDir, outAxis);
+	grabbedAxisIndex = -1;
+	return false;
+}
+
+bool SceneManager::grabGizmoAxis(int axisIndex, const Vec3d& rayOrigin, const Vec3d& rayDir, GizmoAxis& outAxis) {
+	if (!selectedObject || axisIndex < 0 || axisIndex > 2) {
+		grabbedAxisIndex = -1;
+		return false;
+	}
+
+	const Vec3d dirs[3] = { Vec3d(1,0,0), Vec3d(0,1,0), Vec3d(0,0,1) };
+	Vec3d p1 = selectedObject->position;
+	Vec3d p2 = p1 + dirs[axisIndex];
+	Vec3d axisDir = p2 - p1;
+	Vec3d closest = closestPointOnLine(rayOrigin, rayDir, p1, axisDir);
+
+	GizmoAxis worldAxis(p1, p2, dirs[axisIndex], axisDir);
+	worldAxis.initialProj = (closest - p1).dot(axisDir.normalized());
+	worldAxis.initialObjPos = selectedObject->position;
+	outAxis = worldAxis;
 
-	return hit;
+	grabbedAxisIndex = axisIndex;
+	return true;
 }
 
 void SceneManager::dragSelectedObject(const Vec3d& rayOrigin, const Vec3d& rayDir){
@@ -332,26 +379,181 @@ void SceneManager::dragSelectedObject(const Vec3d& rayOrigin, const Vec3d& rayDi
 	// Apply movement only along the axis, preserving object's original position at pick time
 	Vec3d newPos = grabbedAxis.initialObjPos + axisDirNorm * signedDelta;
 	selectedObject->position = newPos;
+	selectedObject->markDirty();
 }
 
 Object* SceneManager::addObject(const std::string& type, const std::string& name) {
+	FrameAllocator::expectAllocations();
 	Object* obj = new Object();
-	initMeshForType(obj, type);
+	initMeshForType(obj, ShapeGenerator::primitiveType(type));
 	obj->name = name;
+	obj->id = ++objCounter;
 	objects.push_back(obj);
+	attachObject(obj);
+	indexObject(obj);
 	return obj;
 }
 
-void SceneManager::removeObject(Object* objPtr) {
-	for (std::vector<Object*>::iterator it = objects.begin(); it != objects.end(); ) {
-		if ((*it) == objPtr) {
-			it = objects.erase(it);
-		} else {
-			++it;
+ObjectHandle SceneManager::spawnObject(const std::string& type, const std::string& name) {
+	return addObject(type, name)->entity;
+}
+
+ObjectHandle SceneManager::handleOf(Object* obj) {
+	if (!obj) return ObjectHandle();
+	registerPendingObjects();
+	return entities.object(obj->entity) == obj ? obj->entity : ObjectHandle();
+}
+
+void SceneManager::registerPendingObjects(bool checkSlots) {
+	bool changed = objects.size() < entities.size();
+	// a direct drop followed by a push keeps the size, only the slots tell
+	for (size_t k = 0; checkSlots && !changed && k < entities.size(); ++k) changed = entities.owner(k) != objects[k];
+	if (changed) {
+		// Objects were dropped or replaced in the vector directly: rebuild the store in vector
+		// order. The queues may hold the dropped objects, so they are emptied without being read.
+		entities.rebuild(objects);
+		transformQueue.clear();
+		dynamicObjects.clear();
+		objectIndex.clear();
+		for (size_t k = 0; k < objects.size(); ++k) {
+			Object* o = objects[k];
+			if (!o) continue;
+			o->transformQueue = &transformQueue;
+			o->transformQueueIndex = -1;
+			o->dynamicIndex = -1;
+			o->markDirty();
+			indexObject(o);
 		}
+		return;
+	}
+	for (size_t k = entities.size(); k < objects.size(); ++k) {
+		Object* o = objects[k];
+		if (o && entities.object(o->entity) != o) {
+			FrameAllocator::expectAllocations();
+			attachObject(o);
+			indexObject(o);
+		}
+	}
+}
+
+void SceneManager::indexObject(Object* obj) {
+	obj->nameId = StringTable::global().intern(obj->name);
+	if (obj->typeId == StringTable::NONE) obj->typeId = ShapeGenerator::primitiveType(obj->type);
+	objectIndex.add(obj->entity, obj->nameId, obj->tags);
+}
+
+void SceneManager::removeObject(Object* objPtr) {
+	if (!objPtr) return;
+	registerPendingObjects();
+
+	// children stay in the scene, attached to the removed object's parent
+	while (!objPtr->children.empty()) objPtr->children.back()->setParent(objPtr->parent);
+	objPtr->setParent(nullptr);
+	detachObject(objPtr);
+
+	if (entities.object(objPtr->entity) == objPtr && objects[entities.indexOf(objPtr->entity)] == objPtr) {
+		// same swap-remove as the entity store, so both stay in step
+		size_t i = entities.indexOf(objPtr->entity);
+		objects[i] = objects.back();
+		objects.pop_back();
+		entities.destroy(objPtr->entity);
+	} else {
+		// 'objects' was reordered by hand; handles stay correct, only this removal is linear
+		objects.erase(std::remove(objects.begin(), objects.end(), objPtr), objects.end());
+		entities.destroy(objPtr->entity);
+	}
+	objectIndex.remove(objPtr->nameId, objPtr->tags);
+
+	if (selectedObject == objPtr) selectedObject = nullptr;
+	if (objPtr->prefab >= 0) pool.release(objPtr);
+	else delete objPtr;
+}
+
+void SceneManager::removeObject(ObjectHandle handle) {
+	Object* obj = get(handle);
+	if (obj) removeObject(obj);
+}
+
+ObjectPool::PrefabId SceneManager::registerPrefab(const std::string& name, const std::string& type,
+												  const std::string& texturePath, size_t prewarmCount) {
+	ObjectPool::PrefabId prefab = pool.registerPrefab(name, type, texturePath);
+	if (prewarmCount > 0) prewarmPrefab(prefab, prewarmCount);
+	return prefab;
+}
+
+void SceneManager::prewarmPrefab(ObjectPool::PrefabId prefab, size_t count) {
+	pool.prewarm(prefab, count);
+	objectIndex.reserveName(pool.prefabName(prefab), count);
+	// room for every instance in the scene at once, so spawning never reallocates
+	size_t total = objects.size() + count;
+	objects.reserve(total);
+	entities.reserve(total);
+}
+
+ObjectHandle SceneManager::spawnPrefab(ObjectPool::PrefabId prefab, const Vec3d& position, const Vec3d& rotation) {
+	Object* obj = pool.acquire(prefab);
+	if (!obj) return ObjectHandle();
+	registerPendingObjects();
+
+	obj->position = position;
+	obj->rotation = rotation;
+	obj->id = ++objCounter;
+	objects.push_back(obj);
+	attachObject(obj);
+	objectIndex.add(obj->entity, obj->nameId, obj->tags);
+	return obj->entity;
+}
+
+void SceneManager::renameObject(Object* obj, const std::string& name) {
+	if (!obj) return;
+	registerPendingObjects();
+	StringId newName = StringTable::global().intern(name);
+	objectIndex.rename(obj->entity, obj->nameId, newName);
+	obj->nameId = newName;
+	obj->name = name;
+}
+
+ObjectHandle SceneManager::findByName(const std::string& name) {
+	registerPendingObjects();
+	StringId id = StringTable::global().find(name);
+	return id == StringTable::NOT_FOUND ? ObjectHandle() : objectIndex.findFirst(id);
+}
+
+void SceneManager::findAllByName(const std::string& name, std::vector<ObjectHandle>& out) {
+	registerPendingObjects();
+	StringId id = StringTable::global().find(name);
+	if (id != StringTable::NOT_FOUND) objectIndex.findAll(id, out);
+}
+
+uint32_t SceneManager::tagMask(const std::string& tag) {
+	StringId id = StringTable::global().intern(tag);
+	for (size_t bit = 0; bit < tagNames.size(); ++bit) {
+		if (tagNames[bit] == id) return 1u << bit;
+	}
+	if (tagNames.size() >= (size_t)ObjectIndex::MAX_TAGS) {
+		std::cerr << "[SceneManager] Out of tag bits, ignoring tag '" << tag << "'" << std::endl;
+		return 0;
 	}
+	tagNames.push_back(id);
+	return 1u << (tagNames.size() - 1);
+}
 
-	delete objPtr;
+void SceneManager::setTags(Object* obj, uint32_t tags) {
+	if (!obj) return;
+	registerPendingObjects();
+	objectIndex.retag(obj->entity, obj->tags, tags);
+	obj->tags = tags;
+}
+
+void SceneManager::findByTag(const std::string& tag, std::vector<ObjectHandle>& out) {
+	registerPendingObjects();
+	StringId id = StringTable::global().find(tag);
+	for (size_t bit = 0; bit < tagNames.size(); ++bit) {
+		if (tagNames[bit] == id) {
+			objectIndex.findTagged(1u << bit, out);
+			return;
+		}
+	}
 }
 
 void SceneManager::removeLight(int index) {
@@ -362,14 +564,24 @@ void SceneManager::removeLight(int index) {
 			delete lightShadows[index];
 			lightShadows.erase(lightShadows.begin() + index);
 		}
+		// cube maps follow their lights to the new indices; the removed light's map is free
+		for (int s = 0; s < MAX_POINT_SHADOWS; ++s) {
+			if (pointShadowOwner[s] == index) pointShadowOwner[s] = -1;
+			else if (pointShadowOwner[s] > index) --pointShadowOwner[s];
+		}
 	}
 }
 
 void SceneManager::addLight(const Light& light){
 	lights.push_back(light);
 	// ensure gizmo resources exist when lights are present
-	if (lightVAO == 0) initLightGizmo();
+	initLightGizmo();
 
+	// point lights are shadowed from the cube map pool instead
+	if (light.type != LightType::Directional) {
+		lightShadows.push_back(NULL);
+		return;
+	}
 	Shadow* sh = new Shadow();
 	sh->lightPos = light.position;
 	sh->lightDir = light.direction;
@@ -382,39 +594,265 @@ void SceneManager::addLight(const Light& light){
 
 void SceneManager::update(float deltaTime) {}
 
-void SceneManager::render(GLuint shaderProgram, const Mat4& view, const Mat4& projection) {
-	const char* unlitVertPath = "shaders/unlit/vertex.glsl";
-	const char* unlitFragPath = "shaders/unlit/fragment.glsl";
+// Walks one subtree depth-first; parents are always refreshed before their children. The root
+// first brings its own parent chain up to date. Every visited object pushes its new state into
+// its entity; subtrees are disjoint, so jobs on different subtrees write different entities.
+static void updateSubtree(Object* root, EntityStore& entities, std::vector<Object*>& stack) {
+	root->refreshTransform();
+	entities.refresh(root->entity);
+	for (size_t c = 0; c < root->children.size(); ++c) stack.push_back(root->children[c]);
+	while (!stack.empty()) {
+		Object* o = stack.back();
+		stack.pop_back();
+		o->refreshTransform(true);
+		entities.refresh(o->entity);
+		for (size_t c = 0; c < o->children.size(); ++c) stack.push_back(o->children[c]);
+	}
+}
 
-	auto getMTime = [](const char* path)->time_t {
-		struct stat st;
-		if (stat(path, &st) == 0) return st.st_mtime;
-		return 0;
-	};
+// True if the subtree walk of a non-static ancestor already covers this object.
+static bool hasDynamicAncestor(const Object* obj) {
+	for (const Object* p = obj->parent; p; p = p->parent) {
+		if (!p->isStatic) return true;
+	}
+	return false;
+}
 
-	if (glShaderType == 1) {
-		time_t vm = getMTime(unlitVertPath);
-		time_t fm = getMTime(unlitFragPath);
-		if (s_unlitProgram == 0 || vm != s_unlitVertMtime || fm != s_unlitFragMtime) {
-			if (s_unlitProgram != 0) {
-				glDeleteProgram(s_unlitProgram);
-				s_unlitProgram = 0;
-			}
-			GLuint prog = s_shaderCompiler.loadShader(unlitVertPath, unlitFragPath);
-			if (prog != 0) {
-				s_unlitProgram = prog;
-				s_unlitVertMtime = vm;
-				s_unlitFragMtime = fm;
-				std::cerr << "[SceneManager] Loaded unlit shader id=" << prog << std::endl;
+// At least this many non-static objects split their root subtrees across the thread pool.
+static const size_t PARALLEL_TRANSFORM_MIN_OBJECTS = 4096;
+
+void SceneManager::setDynamic(Object* obj, bool dynamic) {
+	if (dynamic == (obj->dynamicIndex >= 0)) return;
+	if (dynamic) {
+		obj->dynamicIndex = (int)dynamicObjects.size();
+		dynamicObjects.push_back(obj);
+	} else {
+		Object* last = dynamicObjects.back();
+		dynamicObjects[obj->dynamicIndex] = last;
+		last->dynamicIndex = obj->dynamicIndex;
+		dynamicObjects.pop_back();
+		obj->dynamicIndex = -1;
+	}
+}
+
+void SceneManager::attachObject(Object* obj) {
+	obj->entity = entities.create(obj);
+	// each object is queued at most once, so with this much room queueing never reallocates
+	if (transformQueue.capacity() < objects.size()) {
+		transformQueue.reserve(objects.capacity());
+		dynamicObjects.reserve(objects.capacity());
+	}
+	obj->transformQueue = &transformQueue;
+	obj->transformQueueIndex = -1;
+	obj->dynamicIndex = -1;
+	obj->markDirty();
+}
+
+void SceneManager::detachObject(Object* obj) {
+	// O(1) like setDynamic, so despawning many objects queued this frame stays linear
+	if (obj->transformQueueIndex >= 0) {
+		Object* last = transformQueue.back();
+		transformQueue[obj->transformQueueIndex] = last;
+		last->transformQueueIndex = obj->transformQueueIndex;
+		transformQueue.pop_back();
+		obj->transformQueueIndex = -1;
+	}
+	setDynamic(obj, false);
+	obj->transformQueue = nullptr;
+}
+
+void SceneManager::updateTransforms() {
+	// Objects that reported a change (markDirty, setParent, new in the scene) and their subtrees;
+	// this is also where a changed isStatic takes effect.
+	for (size_t q = 0; q < transformQueue.size(); ++q) {
+		Object* o = transformQueue[q];
+		o->transformQueueIndex = -1;
+		setDynamic(o, !o->isStatic);
+		updateSubtree(o, entities, transformStack);
+	}
+	transformQueue.clear();
+
+	// Non-static objects are change-detected every frame, together with their subtrees; static
+	// objects elsewhere are not visited at all. Top-level subtrees are disjoint and may run in
+	// parallel. The others hang below static parents that nothing else touches this frame.
+	transformRoots.clear();
+	for (size_t i = 0; i < dynamicObjects.size(); ++i) {
+		Object* o = dynamicObjects[i];
+		if (!o->parent) transformRoots.push_back(o);
+		else if (!hasDynamicAncestor(o)) updateSubtree(o, entities, transformStack);
+	}
+
+	ThreadPool& threads = ThreadPool::shared();
+	size_t jobCount = threads.size() + 1;
+	if (dynamicObjects.size() < PARALLEL_TRANSFORM_MIN_OBJECTS || jobCount < 2 || transformRoots.size() < jobCount) {
+		for (size_t r = 0; r < transformRoots.size(); ++r) updateSubtree(transformRoots[r], entities, transformStack);
+		return;
+	}
+
+	// Subtrees are disjoint, so each job owns a contiguous run of roots. The main thread takes
+	// the last run itself instead of idling. Jobs capture only the context and their index so
+	// they fit std::function's small buffer and submitting does not allocate.
+	struct TransformJobs {
+		Object** roots;
+		EntityStore* entities;
+		size_t rootCount;
+		size_t perJob;
+		std::vector<Object*>* stacks;
+		std::mutex doneMutex;
+		std::condition_variable doneCv;
+		size_t remaining;
+	} ctx;
+	if (transformJobStacks.size() < jobCount) transformJobStacks.resize(jobCount);
+	ctx.roots = &transformRoots[0];
+	ctx.entities = &entities;
+	ctx.rootCount = transformRoots.size();
+	ctx.perJob = (ctx.rootCount + jobCount - 1) / jobCount;
+	ctx.stacks = &transformJobStacks[0];
+	ctx.remaining = jobCount - 1;
+
+	for (size_t j = 0; j + 1 < jobCount; ++j) {
+		TransformJobs* job = &ctx;
+		threads.submit([job, j]() {
+			size_t begin = std::min(job->rootCount, j * job->perJob);
+			size_t end = std::min(job->rootCount, begin + job->perJob);
+			for (size_t r = begin; r < end; ++r) updateSubtree(job->roots[r], *job->entities, job->stacks[j]);
+			std::lock_guard<std::mutex> lock(job->doneMutex);
+			if (--job->remaining == 0) job->doneCv.notify_one();
+		});
+	}
+	for (size_t r = std::min(ctx.rootCount, (jobCount - 1) * ctx.perJob); r < ctx.rootCount; ++r) {
+		updateSubtree(ctx.roots[r], entities, transformStack);
+	}
+
+	std::unique_lock<std::mutex> lock(ctx.doneMutex);
+	while (ctx.remaining > 0) ctx.doneCv.wait(lock);
+}
+
+// A compare-mode depth texture at the far plane: bound to unused shadowMap[] units so every
+// sampler2DShadow has a unit of its own and a texture of its type.
+static GLuint emptyShadowMap() {
+	if (s_emptyShadowMap == 0) {
+		const float far = 1.0f;
+		glGenTextures(1, &s_emptyShadowMap);
+		glBindTexture(GL_TEXTURE_2D, s_emptyShadowMap);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, 1, 1, 0, GL_DEPTH_COMPONENT, GL_FLOAT, &far);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	}
+	return s_emptyShadowMap;
+}
+
+static bool moreImportant(const std::pair<float, int>& a, const std::pair<float, int>& b) {
+	return a.first > b.first;
+}
+
+void SceneManager::updatePointShadows(GLuint activeProgram, const float* cameraPlanes, const Vec3d& cameraPos, int texBase) {
+	PROFILE_SCOPE("Point shadows");
+	PROFILE_GPU_SCOPE("Point shadows");
+
+	// Candidates are the point lights the shader shades, and only those whose range reaches
+	// the screen: a light off screen cannot throw a visible shadow.
+	pointShadowOrder.clear();
+	int pointIndex = 0;
+	for (size_t li = 0; li < lights.size() && pointIndex < MAX_POINT_SHADOWS; ++li) {
+		const Light& L = lights[li];
+		if (L.type != LightType::Point) continue;
+		++pointIndex;
+		float range = PointShadow::rangeFor(L.intensity);
+		uint8_t onScreen = 0;
+		SimdMath::cullSpheres(cameraPlanes, &L.position.x, &L.position.y, &L.position.z, &range, &onScreen, 1);
+		if (!onScreen || range <= 0.0f) continue;
+		Vec3d d = L.position - cameraPos;
+		pointShadowOrder.push_back(std::make_pair(L.intensity / (1.0f + d.dot(d)), (int)li));
+	}
+	std::sort(pointShadowOrder.begin(), pointShadowOrder.end(), moreImportant);
+	size_t budget = (size_t)std::max(0, std::min(pointShadowBudget, (int)MAX_POINT_SHADOWS));
+	if (!Shaderc::ready(pointShadowDepthProgram)) budget = 0;
+	if (pointShadowOrder.size() > budget) pointShadowOrder.resize(budget);
+
+	// Lights that stay chosen keep their map (and its cached faces); the others free theirs.
+	for (int s = 0; s < MAX_POINT_SHADOWS; ++s) {
+		bool chosen = false;
+		for (size_t c = 0; c < pointShadowOrder.size() && !chosen; ++c) chosen = pointShadowOrder[c].second == pointShadowOwner[s];
+		if (!chosen) pointShadowOwner[s] = -1;
+	}
+	int faceBudget = pointShadowFaceBudget;
+	for (size_t c = 0; c < pointShadowOrder.size(); ++c) {
+		int li = pointShadowOrder[c].second;
+		int slot = -1;
+		for (int s = 0; s < MAX_POINT_SHADOWS && slot < 0; ++s) {
+			if (pointShadowOwner[s] == li) slot = s;
+		}
+		if (slot < 0) {
+			for (int s = 0; s < MAX_POINT_SHADOWS && slot < 0; ++s) {
+				if (pointShadowOwner[s] == -1) slot = s;
 			}
-			else {
-				std::cerr << "[SceneManager] Failed to load unlit shader, falling back to lit." << std::endl;
+			if (!pointShadows[slot]) {
+				FrameAllocator::expectAllocations();
+				pointShadows[slot] = new PointShadow();
 			}
+			pointShadows[slot]->invalidate();
+			pointShadowOwner[slot] = li;
 		}
+		const Light& L = lights[li];
+		faceBudget -= pointShadows[slot]->update(this, pointShadowDepthProgram, L.position,
+		                                         PointShadow::rangeFor(L.intensity), faceBudget);
 	}
+	glUseProgram(activeProgram);
+
+	// Every sampler gets its own unit, bound or not, so none of them aliases uTexture on unit 0.
+	pointIndex = 0;
+	for (size_t li = 0; li < lights.size() && pointIndex < MAX_POINT_SHADOWS; ++li) {
+		if (lights[li].type != LightType::Point) continue;
+		const PointShadow* ps = NULL;
+		for (int s = 0; s < MAX_POINT_SHADOWS && !ps; ++s) {
+			if (pointShadowOwner[s] == (int)li && pointShadows[s]->ready()) ps = pointShadows[s];
+		}
+		int texUnit = texBase + pointIndex;
+		glActiveTexture(GL_TEXTURE0 + texUnit);
+		glBindTexture(GL_TEXTURE_CUBE_MAP, ps ? ps->getDepthTexture() : 0);
+		char buf[64];
+		snprintf(buf, sizeof(buf), "pointShadowMap[%d]", pointIndex);
+		GLint locS = glGetUniformLocation(activeProgram, buf);
+		if (locS >= 0) glUniform1i(locS, texUnit);
+		// 0 turns shadowing off for this light
+		snprintf(buf, sizeof(buf), "pointShadowFar[%d]", pointIndex);
+		GLint locF = glGetUniformLocation(activeProgram, buf);
+		if (locF >= 0) glUniform1f(locF, ps ? ps->getFarPlane() : 0.0f);
+		if (ps) {
+			snprintf(buf, sizeof(buf), "pointShadowPos[%d]", pointIndex);
+			GLint locP = glGetUniformLocation(activeProgram, buf);
+			const Vec3d& origin = ps->getOrigin();
+			if (locP >= 0) glUniform3f(locP, origin.x, origin.y, origin.z);
+		}
+		++pointIndex;
+	}
+	for (; pointIndex < MAX_POINT_SHADOWS; ++pointIndex) {
+		char buf[64];
+		snprintf(buf, sizeof(buf), "pointShadowMap[%d]", pointIndex);
+		GLint locS = glGetUniformLocation(activeProgram, buf);
+		if (locS >= 0) glUniform1i(locS, texBase + pointIndex);
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+void SceneManager::render(GLuint shaderProgram, const Mat4& view, const Mat4& projection) {
+	PROFILE_SCOPE("SceneManager::render");
+
+	// Unlit program: resubmitted by onAssetChanged and swapped in once it links. Until then
+	// draws keep using the previous unlit program, or the lit one.
+	swapWhenLinked(s_unlitProgram, s_unlitPending, "unlit");
 
 	// Detect depth-only pass (renderDepth calls scene->render with depthProgram)
-	bool depthPass = (shaderProgram == shadowDepthProgram);
+	bool depthPass = (shaderProgram == shadowDepthProgram) ||
+		(pointShadowDepthProgram != 0 && shaderProgram == pointShadowDepthProgram);
+	// the depth programs only change between frames, never under a depth pass that uses them
+	if (!depthPass) {
+		swapWhenLinked(shadowDepthProgram, shadowDepthPending, "shadow depth");
+		swapWhenLinked(pointShadowDepthProgram, pointShadowDepthPending, "point shadow depth");
+	}
 
 	GLuint activeProgram = (glShaderType == 1 && s_unlitProgram != 0 && !depthPass) ? s_unlitProgram : shaderProgram;
 	glUseProgram(activeProgram);
@@ -446,21 +884,42 @@ void SceneManager::render(GLuint shaderProgram, const Mat4& view, const Mat4& pr
 		glBindVertexArray(0);
 	}
 
+	// Bring this frame's changes into the dense arrays once; the depth passes below reuse them.
+	if (!depthPass) {
+		PROFILE_SCOPE("Sync entities");
+		registerPendingObjects(true);
+		updateTransforms();
+	}
+
+	const size_t entityCount = entities.size();
+	const float* centersY = entityCount ? &entities.boundsY[0] : nullptr;
+
 	float sceneMaxY = -1e9f;
-	bool hasSceneObjects = false;
-	for (size_t oi = 0; oi < objects.size(); ++oi) {
-		Object* o = objects[oi];
-		if (!o) continue;
-		hasSceneObjects = true;
-		sceneMaxY = std::max(sceneMaxY, o->position.y);
+	for (size_t i = 0; i < entityCount; ++i) {
+		sceneMaxY = std::max(sceneMaxY, centersY[i]);
+	}
+	if (entityCount == 0) sceneMaxY = 0.0f; // fallback
+
+	// Camera frustum test, done before the shadow passes: the visible entities are the
+	// receivers the shadow boxes are fitted to.
+	float cameraPlanes[24];
+	if (!depthPass) {
+		Mat4 cameraViewProj = projection * view;
+		SimdMath::extractFrustumPlanes(cameraViewProj.value_ptr(), cameraPlanes);
+		cameraVisible.resize(entityCount);
+		if (entityCount) {
+			SimdMath::cullSpheres(cameraPlanes, &entities.boundsX[0], &entities.boundsY[0], &entities.boundsZ[0],
+			                      &entities.boundsRadius[0], &cameraVisible[0], entityCount);
+		}
 	}
-	if (!hasSceneObjects) sceneMaxY = 0.0f; // fallback
 
 	// Only generate shadow maps during the regular (non-depth) render
 	if (!depthPass) {
 		int texBase = 4; // choose starting texture unit (0 = diffuse texture)
 		int dirShadowCount = 0;
-		for (size_t li = 0; li < lights.size() && dirShadowCount < MAX_DIR_SHADOWS; ++li) {
+		const bool depthReady = Shaderc::ready(shadowDepthProgram);
+		GpuProfileScope dirShadowPass("Directional shadows");
+		for (size_t li = 0; li < lights.size() && dirShadowCount < MAX_DIR_SHADOWS && depthReady; ++li) {
 			Light& L = lights[li];
 			if (L.type != LightType::Directional) continue;
 			// update shadow params
@@ -469,7 +928,7 @@ void SceneManager::render(GLuint shaderProgram, const Mat4& view, const Mat4& pr
 				sh->lightPos = L.position;
 				sh->lightDir = L.direction;
 				// render depth (this will bind the depth program + FBO)
-				Mat4 ls = sh->renderDepth(this, shadowDepthProgram);
+				Mat4 ls = sh->renderDepth(this, shadowDepthProgram, entityCount ? &cameraVisible[0] : NULL);
 
 				// renderDepth may have changed the bound program/framebuffer; re-bind our active program
 				glUseProgram(activeProgram);
@@ -500,33 +959,60 @@ void SceneManager::render(GLuint shaderProgram, const Mat4& view, const Mat4& pr
 				// Inform shader of shadow map resolution (used for PCF)
 				GLint locSz = glGetUniformLocation(activeProgram, "uShadowMapSize");
 				if (locSz >= 0) glUniform1f(locSz, (float)sh->SHADOW_SIZE);
+				GLint locKernel = glGetUniformLocation(activeProgram, "uShadowKernel");
+				if (locKernel >= 0) glUniform1i(locKernel, (int)shadowQuality);
 
 				++dirShadowCount;
 			}
 		}
+		dirShadowPass.end();
+		// Lights without a map this frame (depth program still compiling) sample no shadow. Their
+		// samplers still get a unit and a depth texture each: a sampler2DShadow left on unit 0
+		// next to uTexture makes every draw fail with GL_INVALID_OPERATION.
+		for (int k = dirShadowCount; k < MAX_DIR_SHADOWS; ++k) {
+			char buf[64];
+			int texUnit = texBase + k;
+			glActiveTexture(GL_TEXTURE0 + texUnit);
+			glBindTexture(GL_TEXTURE_2D, emptyShadowMap());
+			snprintf(buf, sizeof(buf), "shadowMap[%d]", k);
+			GLint locS = glGetUniformLocation(activeProgram, buf);
+			if (locS >= 0) glUniform1i(locS, texUnit);
+
+			snprintf(buf, sizeof(buf), "uShadowCullHeight[%d]", k);
+			GLint locCull = glGetUniformLocation(activeProgram, buf);
+			if (locCull >= 0) glUniform1f(locCull, -FLT_MAX);
+		}
+		glActiveTexture(GL_TEXTURE0);
+
+		Mat4 invView = view.inverse();
+		Vec3d cameraPos(invView.m[3][0], invView.m[3][1], invView.m[3][2]);
+		updatePointShadows(activeProgram, cameraPlanes, cameraPos, texBase + MAX_DIR_SHADOWS);
 	}
 
+	// the rest of the camera pass: lighting uniforms, object draws and gizmos
+	GpuProfileScope scenePass(depthPass ? NULL : "Scene");
+
 	// Set per-light uniforms (direction/color/intensity) on the active program
 	int dirCount = 0, pointCount = 0;
 	for (size_t i = 0; i < lights.size(); i++) {
 		Light& l = lights[i];
 		if (l.type == LightType::Directional) {
-			std::ostringstream ss; ss << dirCount; std::string idx = ss.str();
-			std::string locDirs = std::string("dirLightDirs[") + idx + "]";
-			std::string locColors = std::string("dirLightColors[") + idx + "]";
-			std::string locInts = std::string("dirLightIntensities[") + idx + "]";
-			glUniform3fv(glGetUniformLocation(activeProgram, locDirs.c_str()), 1, &l.direction[0]);
-			glUniform3fv(glGetUniformLocation(activeProgram, locColors.c_str()), 1, &l.color[0]);
-			glUniform1f(glGetUniformLocation(activeProgram, locInts.c_str()), l.intensity);
+			char buf[64];
+			snprintf(buf, sizeof(buf), "dirLightDirs[%d]", dirCount);
+			glUniform3fv(glGetUniformLocation(activeProgram, buf), 1, &l.direction[0]);
+			snprintf(buf, sizeof(buf), "dirLightColors[%d]", dirCount);
+			glUniform3fv(glGetUniformLocation(activeProgram, buf), 1, &l.color[0]);
+			snprintf(buf, sizeof(buf), "dirLightIntensities[%d]", dirCount);
+			glUniform1f(glGetUniformLocation(activeProgram, buf), l.intensity);
 			dirCount++;
 		} else if (l.type == LightType::Point) {
-			std::ostringstream ss; ss << pointCount; std::string idx = ss.str();
-			std::string locPos = std::string("pointLightPositions[") + idx + "]";
-			std::string locCol = std::string("pointLightColors[") + idx + "]";
-			std::string locInt = std::string("pointLightIntensities[") + idx + "]";
-			glUniform3fv(glGetUniformLocation(activeProgram, locPos.c_str()), 1, &l.position[0]);
-			glUniform3fv(glGetUniformLocation(activeProgram, locCol.c_str()), 1, &l.color[0]);
-			glUniform1f(glGetUniformLocation(activeProgram, locInt.c_str()), l.intensity);
+			char buf[64];
+			snprintf(buf, sizeof(buf), "pointLightPositions[%d]", pointCount);
+			glUniform3fv(glGetUniformLocation(activeProgram, buf), 1, &l.position[0]);
+			snprintf(buf, sizeof(buf), "pointLightColors[%d]", pointCount);
+			glUniform3fv(glGetUniformLocation(activeProgram, buf), 1, &l.color[0]);
+			snprintf(buf, sizeof(buf), "pointLightIntensities[%d]", pointCount);
+			glUniform1f(glGetUniformLocation(activeProgram, buf), l.intensity);
 			pointCount++;
 		}
 	}
@@ -540,30 +1026,54 @@ void SceneManager::render(GLuint shaderProgram, const Mat4& view, const Mat4& pr
 	glUniformMatrix4fv(viewLoc, 1, GL_FALSE, view.value_ptr());
 	glUniformMatrix4fv(projLoc, 1, GL_FALSE, projection.value_ptr());
 
-	// Draw scene objects (both regular and depth passes)
-	for (size_t oi = 0; oi < objects.size(); ++oi) {
-		Object* obj = objects[oi];
-		Mat4 model = obj->getModelMatrix();
-		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, model.value_ptr());
+	GLint texLoc = -1, useTexLoc = -1;
+	if (!depthPass) {
+		texLoc = glGetUniformLocation(activeProgram, "uTexture");
+		useTexLoc = glGetUniformLocation(activeProgram, "useTexture");
+		glUniform1i(texLoc, 0);
+		// ensure override is off for normal object draw
+		glUniform1i(glGetUniformLocation(activeProgram, "useOverrideColor"), 0);
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	// Depth passes cull against the light's fitted box; the camera pass reuses its test from above.
+	if (depthPass) {
+		float planes[24];
+		Mat4 viewProj = projection * view;
+		SimdMath::extractFrustumPlanes(viewProj.value_ptr(), planes);
+		cullVisible.resize(entityCount);
+		if (entityCount) {
+			SimdMath::cullSpheres(planes, &entities.boundsX[0], &entities.boundsY[0], &entities.boundsZ[0],
+			                      &entities.boundsRadius[0], &cullVisible[0], entityCount);
+		}
+	}
+	const uint8_t* visible = entityCount ? (depthPass ? &cullVisible[0] : &cameraVisible[0]) : nullptr;
+
+	// Draw scene objects (both regular and depth passes) straight from the dense arrays
+	const Mat4* worlds = entityCount ? &entities.world[0] : nullptr;
+	const GLuint* vaos = entityCount ? &entities.vaos[0] : nullptr;
+	const GLsizei* counts = entityCount ? &entities.indexCounts[0] : nullptr;
+	const GLuint* textures = entityCount ? &entities.textures[0] : nullptr;
+	uint32_t drawn = 0;
+	for (size_t i = 0; i < entityCount; ++i) {
+		if (!visible[i]) continue;
+		++drawn;
+		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, worlds[i].value_ptr());
 
 		if (!depthPass) {
-			if (obj->textureID != 0) {
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, obj->textureID);
-				glUniform1i(glGetUniformLocation(activeProgram, "uTexture"), 0);
-				glUniform1i(glGetUniformLocation(activeProgram, "useTexture"), 1);
+			if (textures[i] != 0) {
+				glBindTexture(GL_TEXTURE_2D, textures[i]);
+				glUniform1i(useTexLoc, 1);
 			} else {
-				glUniform1i(glGetUniformLocation(activeProgram, "useTexture"), 0);
+				glUniform1i(useTexLoc, 0);
 			}
-
-			// ensure override is off for normal object draw
-			glUniform1i(glGetUniformLocation(activeProgram, "useOverrideColor"), 0);
 		}
 
-		glBindVertexArray(obj->VAO);
-		glDrawElements(GL_TRIANGLES, (GLsizei)obj->indices.size(), GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
+		glBindVertexArray(vaos[i]);
+		glDrawElements(GL_TRIANGLES, counts[i], GL_UNSIGNED_INT, 0);
 	}
+	glBindVertexArray(0);
+	RenderStats::countObjects(drawn, (uint32_t)entityCount - drawn);
 
 	// If we were called as a depth pass, return now — do not draw gizmos, grid, or light gizmos into shadow maps.
 
@@ -588,92 +1098,158 @@ void SceneManager::render(GLuint shaderProgram, const Mat4& view, const Mat4& pr
 		glBindVertexArray(0);
 	}
 
+	// Hover feedback from the ID picker
+	Object* hovered = entities.object(hoveredObject);
+	if (hovered && hovered != selectedObject) {
+		size_t i = entities.indexOf(hoveredObject);
+		Vec3d c(entities.boundsX[i], entities.boundsY[i], entities.boundsZ[i]);
+		Vec3d r(entities.boundsRadius[i]);
+		DebugDraw::wireBox(c - r, c + r, Vec3d(1.0f, 0.8f, 0.2f));
+	}
+
 	// Draw light gizmos (always draw, even if no object is selected)
-	if (lightVAO != 0) {
-		glBindVertexArray(lightVAO);
-		glPointSize(10.0f);
-		for (size_t i = 0; i < lights.size(); ++i) {
-			// draw point at light position
-			Mat4 model = translate(Mat4(1.0f), lights[i].position);
-			glUniformMatrix4fv(glGetUniformLocation(activeProgram,"model"),1,GL_FALSE, model.value_ptr());
-			glUniform3fv(glGetUniformLocation(activeProgram,"overrideColor"),1,&lights[i].color[0]);
-			glUniform1i(glGetUniformLocation(activeProgram,"useOverrideColor"), 1);
-
-			// ensure the lightVBO contains a single point when drawing point
-			Vec3d pt = lights[i].position;
-			glBindBuffer(GL_ARRAY_BUFFER, lightVBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(Vec3d), &Vec3d(0.0f,0.0f,0.0f), GL_DYNAMIC_DRAW);
-			// draw point (will be transformed by model uniform)
-			if ((int)i == selectedLightIndex) glPointSize(14.0f);
-			glDrawArrays(GL_POINTS, 0, 1);
-			if ((int)i == selectedLightIndex) glPointSize(10.0f);
-
-			// --- Debug direction ray: update same VBO with two positions in world-space and draw as lines ---
-			Vec3d p0 = lights[i].position;
-			Vec3d dir = lights[i].direction.normalized();
-			float rayLen = 0.6f * std::max(1.0f, gizmoLineWidth * 0.1f);
-			Vec3d p1 = p0 + dir * rayLen;
-			Vec3d linePts[2] = { p0, p1 };
-
-			// Because the shader multiplies by model, we set model to identity for world-space line verts
-			Mat4 identity = Mat4(1.0f);
-			glUniformMatrix4fv(glGetUniformLocation(activeProgram,"model"),1,GL_FALSE, identity.value_ptr());
-
-			glBindBuffer(GL_ARRAY_BUFFER, lightVBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(linePts), linePts, GL_DYNAMIC_DRAW);
-
-			glEnableVertexAttribArray(0);
-			glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,sizeof(Vec3d),(void*)0);
-
-			glUniform1i(glGetUniformLocation(activeProgram, "useOverrideColor"), 1);
-			glUniform3fv(glGetUniformLocation(activeProgram, "overrideColor"), 1, &lights[i].color[0]);
-
-			glDrawArrays(GL_LINES, 0, 2);
-
-			// restore VBO to single point  (so next point draw works)
-			Vec3d origin(0.0f,0.0f,0.0f);
-			glBindBuffer(GL_ARRAY_BUFFER, lightVBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(Vec3d), &origin, GL_DYNAMIC_DRAW);
-		}
-		glUniform1i(glGetUniformLocation(activeProgram,"useOverrideColor"), 0);
-		glPointSize(1.0f);
-		glBindVertexArray(0);
+	queueLightGizmos(10.0f, 14.0f);
+	DebugDraw::flush(activeProgram, view, projection);
+}
+
+void SceneManager::renderIds(IdPicker& picker, GLuint fbo, const Mat4& view, const Mat4& projection) {
+	PROFILE_SCOPE("ID picking");
+	PROFILE_GPU_SCOPE("ID picking");
+	GLuint prog = picker.beginPass(fbo);
+	if (prog == 0) return;
+
+	GLint modelLoc = glGetUniformLocation(prog, "model");
+	glUniformMatrix4fv(glGetUniformLocation(prog, "view"), 1, GL_FALSE, view.value_ptr());
+	glUniformMatrix4fv(glGetUniformLocation(prog, "projection"), 1, GL_FALSE, projection.value_ptr());
+
+	// Objects, reusing the frustum test render() made for the same camera. Slots rather than
+	// dense indices go into the IDs since the readback arrives a frame or two later.
+	const size_t entityCount = entities.size();
+	bool culled = cameraVisible.size() == entityCount;
+	for (size_t i = 0; i < entityCount; ++i) {
+		if (culled && !cameraVisible[i]) continue;
+		picker.setId(IdPicker::encode(IdPicker::OBJECT, entities.slotOf(i)));
+		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, entities.world[i].value_ptr());
+		glBindVertexArray(entities.vaos[i]);
+		glDrawElements(GL_TRIANGLES, entities.indexCounts[i], GL_UNSIGNED_INT, 0);
+	}
+
+	// Lights as fat points, about the size of their gizmo
+	glPointSize(14.0f);
+	glBindVertexArray(picker.pointVAO());
+	for (size_t i = 0; i < lights.size(); ++i) {
+		Mat4 model = translate(Mat4(1.0f), lights[i].position);
+		picker.setId(IdPicker::encode(IdPicker::LIGHT, (uint32_t)i));
+		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, model.value_ptr());
+		glDrawArrays(GL_POINTS, 0, 1);
+	}
+	glBindVertexArray(0);
+	glPointSize(1.0f);
+
+	// The gizmo is drawn on top, as on screen, so it wins over whatever is behind it
+	if (selectedObject) {
+		GLboolean wasDepthEnabled = glIsEnabled(GL_DEPTH_TEST);
+		glDisable(GL_DEPTH_TEST);
+		Mat4 model = translate(Mat4(1.0f), selectedObject->position);
+		glUniformMatrix4fv(modelLoc, 1, GL_FALSE, model.value_ptr());
+		for (int axis = 0; axis < 3; ++axis) {
+			picker.setId(IdPicker::encode(IdPicker::GIZMO_AXIS, (uint32_t)axis));
+			TransformTool::drawAxisMesh(axis);
+		}
+		if (wasDepthEnabled) glEnable(GL_DEPTH_TEST);
+	}
+
+	picker.endPass();
+}
+
+Object* SceneManager::objectFromPickId(uint32_t id) const {
+	if (IdPicker::kindOf(id) != IdPicker::OBJECT) return nullptr;
+	return entities.object(entities.slotHandle(IdPicker::payloadOf(id)));
+}
+
+void SceneManager::applyPick(uint32_t id, const Vec3d& rayOrigin, const Vec3d& rayDir) {
+	uint32_t payload = IdPicker::payloadOf(id);
+	switch (IdPicker::kindOf(id)) {
+	case IdPicker::GIZMO_AXIS:
+		if (grabGizmoAxis((int)payload, rayOrigin, rayDir, grabbedAxis)) {
+			axisGrabbed = true;
+			return;
+		}
+		break;
+	case IdPicker::OBJECT:
+		if (Object* picked = objectFromPickId(id)) {
+			axisGrabbed = false;
+			grabbedAxisIndex = -1;
+			selectedObject = picked;
+			return;
+		}
+		break;
+	case IdPicker::LIGHT:
+		if (payload < lights.size()) {
+			axisGrabbed = false;
+			grabbedAxisIndex = -1;
+			selectedLightIndex = (int)payload;
+			return;
+		}
+		break;
+	default:
+		break;
 	}
+
+	// nothing (still) there: clear, as a CPU pick that hits nothing does
+	axisGrabbed = false;
+	grabbedAxisIndex = -1;
+	selectedObject = nullptr;
+	selectedLightIndex = -1;
+}
+
+void SceneManager::setHovered(uint32_t id) {
+	Object* obj = objectFromPickId(id);
+	hoveredObject = obj ? obj->entity : ObjectHandle();
+	uint32_t payload = IdPicker::payloadOf(id);
+	hoveredLightIndex = (IdPicker::kindOf(id) == IdPicker::LIGHT && payload < lights.size()) ? (int)payload : -1;
 }
 Object* SceneManager::pickObject(const Vec3d& rayOrigin, const Vec3d& rayDir) {
 	float bestDist = FLT_MAX;
 	Object* picked = nullptr;
 
-	for (size_t oi = 0; oi < objects.size(); ++oi) {
-		Object* obj = objects[oi];
-		if (!obj) continue;
-		if (obj->indices.size() < 3 || obj->vertices.size() == 0) continue;
+	registerPendingObjects(true);
+	updateTransforms();
+	Vec3d dir = rayDir.normalized();
+
+	for (size_t oi = 0; oi < entities.size(); ++oi) {
+		// Broad phase on the dense bounding spheres: skip anything the ray misses or that
+		// starts farther away than the best hit so far.
+		float r = entities.boundsRadius[oi];
+		Vec3d oc = Vec3d(entities.boundsX[oi], entities.boundsY[oi], entities.boundsZ[oi]) - rayOrigin;
+		float tca = oc.dot(dir);
+		float d2 = oc.dot(oc) - tca * tca;
+		if (d2 > r * r) continue;
+		float thc = std::sqrt(r * r - d2);
+		if (tca + thc < 0.0f || tca - thc > bestDist) continue;
+
+		Object* obj = entities.owners[oi];
+		const std::vector<Vertex>& vertices = obj->meshVertices();
+		const std::vector<unsigned int>& indices = obj->meshIndices();
+		if (indices.size() < 3 || vertices.size() == 0) continue;
 
 		// Transform ray into object local space
-		Mat4 model = obj->getModelMatrix();
-		Mat4 invModel = model.inverse();
+		const Mat4& model = entities.world[oi];
+		const Mat4& invModel = obj->getInverseModelMatrix();
 		Vec3d localOrig = invModel.transformPoint(rayOrigin);
 		Vec3d localDir = invModel.transformDir(rayDir).normalized();
 
-		for (size_t idx = 0; idx + 2 < obj->indices.size(); idx += 3) {
-			unsigned int i0 = obj->indices[idx + 0];
-			unsigned int i1 = obj->indices[idx + 1];
-			unsigned int i2 = obj->indices[idx + 2];
-			if (i0 >= obj->vertices.size() || i1 >= obj->vertices.size() || i2 >= obj->vertices.size())
-				continue;
-			const Vec3d& v0 = obj->vertices[i0].pos;
-			const Vec3d& v1 = obj->vertices[i1].pos;
-			const Vec3d& v2 = obj->vertices[i2].pos;
-
-			float tLocal = 0.0f;
-			if (IntersectRayTriangle(localOrig, localDir, v0, v1, v2, tLocal)) {
-				Vec3d localHit = localOrig + localDir * tLocal;
-				Vec3d worldHit = model.transformPoint(localHit);
-				float distWorld = (worldHit - rayOrigin).length();
-				if (distWorld < bestDist) {
-					bestDist = distWorld;
-					picked = obj;
-				}
+		// All triangles of the mesh in one batch; the closest local hit is also the closest
+		// world hit, since the object's transform is affine.
+		float tLocal = 0.0f;
+		if (SimdMath::intersectRayTriangles(&localOrig.x, &localDir.x, &vertices[0].pos, sizeof(Vertex),
+		                                    &indices[0], indices.size() / 3, tLocal) >= 0) {
+			Vec3d localHit = localOrig + localDir * tLocal;
+			Vec3d worldHit = model.transformPoint(localHit);
+			float distWorld = (worldHit - rayOrigin).length();
+			if (distWorld < bestDist) {
+				bestDist = distWorld;
+				picked = obj;
 			}
 		}
 	}
@@ -682,177 +1258,283 @@ Object* SceneManager::pickObject(const Vec3d& rayOrigin, const Vec3d& rayDir) {
 }
 
 
-void SceneManager::initGrid(int gridSize, float spacing) {
-	std::vector<Vec3d> gridVertices;
+void SceneManager::initGrid(float spacing) {
+	gridSpacing = spacing > 0.0f ? spacing : 1.0f;
+	if (gridProgram != 0) return;
 
-	for (int i = -gridSize; i <= gridSize; i++) {
-		gridVertices.push_back(Vec3d(i * spacing, 0.0f, -gridSize * spacing));
-		gridVertices.push_back(Vec3d(i * spacing, 0.0f,  gridSize * spacing));
-
-		gridVertices.push_back(Vec3d(-gridSize * spacing, 0.0f, i * spacing));
-		gridVertices.push_back(Vec3d( gridSize * spacing, 0.0f, i * spacing));
+	// uniform locations are looked up on the first draw after it links
+	gridProgram = s_shaderCompiler.submit(s_gridVertPath, s_gridFragPath);
+	if (gridProgram == 0) {
+		std::cerr << "[SceneManager] Failed to load grid shader, grid disabled." << std::endl;
+		return;
 	}
 
-	gridVertexCount = gridVertices.size();
-
+	// core profile needs a VAO bound to draw, even with no attributes
 	glGenVertexArrays(1, &gridVAO);
-	glGenBuffers(1, &gridVBO);
-
-	glBindVertexArray(gridVAO);
-	glBindBuffer(GL_ARRAY_BUFFER, gridVBO);
-	glBufferData(GL_ARRAY_BUFFER, gridVertices.size() * sizeof(Vec3d),
-	gridVertices.data(), GL_STATIC_DRAW);
-
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vec3d), (void*)0);
-
-	glBindVertexArray(0);
 }
 
-void SceneManager::drawGrid(GLuint shaderProgram, const Mat4& view, const Mat4& projection) {
-	if (gridVAO == 0) return;
+void SceneManager::drawGrid(const Mat4& view, const Mat4& projection) {
+	if (swapWhenLinked(gridProgram, gridPending, "grid")) gridLocationsFetched = false;
+	if (gridProgram == 0 || !Shaderc::ready(gridProgram)) return;
+	PROFILE_GPU_SCOPE("Grid");
+	if (!gridLocationsFetched) {
+		gridInvViewProjLoc = glGetUniformLocation(gridProgram, "uInvViewProj");
+		gridViewProjLoc = glGetUniformLocation(gridProgram, "uViewProj");
+		gridCameraLoc = glGetUniformLocation(gridProgram, "uCameraPos");
+		gridSpacingLoc = glGetUniformLocation(gridProgram, "uSpacing");
+		gridFadeLoc = glGetUniformLocation(gridProgram, "uFadeDistance");
+		gridLocationsFetched = true;
+	}
+
+	Mat4 viewProj = projection * view;
+	Mat4 invViewProj = viewProj.inverse();
+	Mat4 invView = view.inverse();
+	Vec3d cameraPos(invView.m[3][0], invView.m[3][1], invView.m[3][2]);
+	// far plane of a GL perspective matrix; the grid fades out there
+	float denom = projection.m[2][2] + 1.0f;
+	float farPlane = std::fabs(denom) > 1e-6f ? projection.m[3][2] / denom : 100.0f;
 
-	Mat4 model = Mat4(1.0f);
-	glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, model.value_ptr());
-	glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, view.value_ptr());
-	glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, projection.value_ptr());
+	GLint prevProg = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &prevProg);
+	GLboolean prevDepthMask = GL_TRUE;
+	glGetBooleanv(GL_DEPTH_WRITEMASK, &prevDepthMask);
+	GLboolean wasBlend = glIsEnabled(GL_BLEND);
+
+	glUseProgram(gridProgram);
+	glUniformMatrix4fv(gridInvViewProjLoc, 1, GL_FALSE, invViewProj.value_ptr());
+	glUniformMatrix4fv(gridViewProjLoc, 1, GL_FALSE, viewProj.value_ptr());
+	glUniform3f(gridCameraLoc, cameraPos.x, cameraPos.y, cameraPos.z);
+	glUniform1f(gridSpacingLoc, gridSpacing);
+	glUniform1f(gridFadeLoc, farPlane);
+
+	// depth-tested against the scene (the shader writes the plane's depth) but not written
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDepthMask(GL_FALSE);
 
 	glBindVertexArray(gridVAO);
-	glDrawArrays(GL_LINES, 0, gridVertexCount);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
 	glBindVertexArray(0);
+
+	glDepthMask(prevDepthMask);
+	if (!wasBlend) glDisable(GL_BLEND);
+	glUseProgram((GLuint)prevProg);
 }
 
-void SceneManager::saveScene(const std::string& path) {
-	json j;
-	j["objects"] = json::array();
+void SceneManager::buildSceneData(SceneData& out) const {
+	out.clear();
+	out.reserve(objects.size(), lights.size(), objects.size() * 16);
 
 	for (size_t oi = 0; oi < objects.size(); ++oi) {
-		Object* obj = objects[oi];
-		json o;
-		o["name"] = obj->name;
-		o["type"] = obj->type.empty() ? "Cube" : obj->type;
-		json posArr = json::array(); posArr.push_back(obj->position.x); posArr.push_back(obj->position.y); posArr.push_back(obj->position.z);
-		json rotArr = json::array(); rotArr.push_back(obj->rotation.x); rotArr.push_back(obj->rotation.y); rotArr.push_back(obj->rotation.z);
-		json sclArr = json::array(); sclArr.push_back(obj->scale.x); sclArr.push_back(obj->scale.y); sclArr.push_back(obj->scale.z);
-		o["position"] = posArr;
-		o["rotation"] = rotArr;
-		o["scale"] = sclArr;
-		o["texturePath"] = obj->texturePath;
-		j["objects"].push_back(o);
+		const Object* obj = objects[oi];
+		out.addObject(out.addString(obj->name),
+		              out.addSharedString(obj->type.empty() ? "Cube" : obj->type),
+		              out.addSharedString(obj->texturePath),
+		              obj->position, obj->rotation, obj->scale);
 	}
 
-
-	j["lights"] = json::array();
-
 	for (size_t li = 0; li < lights.size(); ++li) {
-		Light light = lights[li];
-		json l;
-		l["type"] = (light.type == LightType::Directional) ? "Directional" : "Point";
-		l["position"] = { light.position.x, light.position.y, light.position.z };
-		l["color"] = { light.color.x, light.color.y, light.color.z };
-		l["intensity"] = light.intensity;
-		j["lights"].push_back(l);
-	}
-
-	std::ofstream file(path);
-	if (file.is_open()) {
-		file << j.dump(4);
-	} else {
-		std::cerr << "[saveScene] Failed to open " << path << " for writing\n";
+		const Light& light = lights[li];
+		out.addLight(light.type, light.position, light.direction, light.color, light.intensity);
 	}
 }
 
-void SceneManager::loadScene(const std::string& path) {
-	std::ifstream file(path);
-	if (!file.is_open()) {
-		std::cerr << "[loadScene] Failed to open " << path << "\n";
-		return;
-	}
+namespace {
+	// One distinct mesh / texture needed by a scene being loaded.
+	struct MeshJob {
+		std::string type;
+		const char* canonicalType;
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+	};
+	struct ImageJob {
+		std::string path;
+		unsigned char* pixels;
+		int width, height, channels;
+		const char* failure;
+	};
+}
 
-	json j;
-	try {
-		file >> j;
-	} catch (const std::exception& e) {
-		std::cerr << "[loadScene] JSON parse error: " << e.what() << "\n";
-		return;
+// GL objects are created this many at a time between progress callbacks.
+static const size_t UPLOAD_BATCH_SIZE = 256;
+
+// Loading is staged: the records are scanned for distinct meshes and textures, those are
+// generated/decoded on the shared thread pool, and only the GL object creation runs here on
+// the context thread, in batches. The current scene stays untouched until the GL stage.
+void SceneManager::applySceneData(const SceneData& data, const SceneLoadProgress& progress) {
+	const size_t objectCount = data.objectCount();
+	if (progress) progress("Preparing", 0.0f);
+
+	std::vector<MeshJob> meshes;
+	std::vector<ImageJob> images;
+	std::vector<int> objectMesh(objectCount), objectImage(objectCount, -1);
+	std::unordered_map<std::string, int> meshLookup, imageLookup;
+
+	for (size_t i = 0; i < objectCount; ++i) {
+		std::string type = data.str(data.types[i]);
+		if (type.empty()) type = "Cube";
+		std::unordered_map<std::string, int>::iterator mit = meshLookup.find(type);
+		if (mit == meshLookup.end()) {
+			mit = meshLookup.insert(std::make_pair(type, (int)meshes.size())).first;
+			MeshJob job;
+			job.type = type;
+			job.canonicalType = "Cube";
+			meshes.push_back(job);
+		}
+		objectMesh[i] = mit->second;
+
+		const char* texPath = data.str(data.texturePaths[i]);
+		if (*texPath) {
+			std::unordered_map<std::string, int>::iterator iit = imageLookup.find(texPath);
+			if (iit == imageLookup.end()) {
+				iit = imageLookup.insert(std::make_pair(std::string(texPath), (int)images.size())).first;
+				ImageJob job;
+				job.path = texPath;
+				job.pixels = nullptr;
+				job.width = job.height = job.channels = 0;
+				job.failure = nullptr;
+				images.push_back(job);
+			}
+			objectImage[i] = iit->second;
+		}
 	}
 
-	clearScene();
+	// Worker stage: mesh generation and image decoding. The job vectors are not resized
+	// from here on, so workers can write into their own element.
+	std::mutex doneMutex;
+	std::condition_variable doneCv;
+	size_t remaining = meshes.size() + images.size();
+	const size_t jobCount = remaining;
+	ThreadPool& pool = ThreadPool::shared();
+
+	for (size_t m = 0; m < meshes.size(); ++m) {
+		MeshJob* job = &meshes[m];
+		pool.submit([job, &doneMutex, &doneCv, &remaining]() {
+			job->canonicalType = ShapeGenerator::createPrimitive(job->type, job->vertices, job->indices);
+			std::lock_guard<std::mutex> lock(doneMutex);
+			--remaining;
+			doneCv.notify_one();
+		});
+	}
+	for (size_t t = 0; t < images.size(); ++t) {
+		ImageJob* job = &images[t];
+		pool.submit([job, &doneMutex, &doneCv, &remaining]() {
+			job->pixels = stbi_load(job->path.c_str(), &job->width, &job->height, &job->channels, 0);
+			if (!job->pixels) job->failure = stbi_failure_reason();
+			std::lock_guard<std::mutex> lock(doneMutex);
+			--remaining;
+			doneCv.notify_one();
+		});
+	}
 
-	if (j.find("objects") == j.end() || !j["objects"].is_array()) {
-		std::cerr << "[loadScene] No 'objects' array in scene\n";
-		return;
+	{
+		std::unique_lock<std::mutex> lock(doneMutex);
+		while (remaining > 0) {
+			doneCv.wait_for(lock, std::chrono::milliseconds(16));
+			if (progress && remaining > 0) {
+				float done = (float)(jobCount - remaining) / (float)jobCount;
+				lock.unlock();
+				progress("Decoding", 0.05f + 0.55f * done);
+				lock.lock();
+			}
+		}
 	}
 
-	for (size_t ji = 0; ji < j["objects"].size(); ++ji) {
-		const json& objJson = j["objects"][ji];
-		std::string type = objJson.value("type", "Cube");
-		std::string name = objJson.value("name", type);
+	// GL stage: everything below runs on the context thread. Each distinct mesh and texture
+	// becomes one set of GL objects, and the scene's objects only point at them, the way pooled
+	// instances point at their prefab.
+	FrameAllocator::expectAllocations();
+	clearScene();
 
-		Vec3d pos(0.0f), rot(0.0f), scl(1.0f);
-		if (objJson.find("position") != objJson.end() && objJson["position"].size() == 3) {
-			pos = Vec3d(objJson["position"][0], objJson["position"][1], objJson["position"][2]);
+	const size_t uploadCount = meshes.size() + images.size();
+	size_t uploaded = 0;
+	sceneMeshes.reserve(meshes.size());
+	for (size_t m = 0; m < meshes.size(); ++m, ++uploaded) {
+		MeshJob& job = meshes[m];
+		Object* mesh = new Object();
+		mesh->type = job.canonicalType;
+		mesh->vertices.swap(job.vertices);
+		mesh->indices.swap(job.indices);
+		mesh->setupMesh();
+		sceneMeshes.push_back(mesh);
+		if (progress && (uploaded + 1) % UPLOAD_BATCH_SIZE == 0) {
+			progress("Uploading", 0.6f + 0.3f * (float)(uploaded + 1) / (float)uploadCount);
 		}
-		if (objJson.find("rotation") != objJson.end() && objJson["rotation"].size() == 3) {
-			rot = Vec3d(objJson["rotation"][0], objJson["rotation"][1], objJson["rotation"][2]);
+	}
+	// an image that failed to decode leaves a 0 name, which glDeleteTextures skips
+	sceneTextures.assign(images.size(), 0);
+	for (size_t t = 0; t < images.size(); ++t, ++uploaded) {
+		ImageJob& img = images[t];
+		if (img.pixels) {
+			sceneTextures[t] = Object::createTexture(img.pixels, img.width, img.height, img.channels);
+			stbi_image_free(img.pixels);
+			img.pixels = nullptr;
+		} else {
+			std::cerr << "Failed to load texture: " << img.path << std::endl;
+			std::cerr << "stbi_failure_reason: " << (img.failure ? img.failure : "unknown") << std::endl;
 		}
-		if (objJson.find("scale") != objJson.end() && objJson["scale"].size() == 3) {
-			scl = Vec3d(objJson["scale"][0], objJson["scale"][1], objJson["scale"][2]);
+		if (progress && (uploaded + 1) % UPLOAD_BATCH_SIZE == 0) {
+			progress("Uploading", 0.6f + 0.3f * (float)(uploaded + 1) / (float)uploadCount);
 		}
-		std::string texPath = objJson.value("texturePath", "");
-
-		Object* o = new Object();
-		o->name = name;
-		o->type = type;
-
-		initMeshForType(o, type);
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+	if (!images.empty()) {
+		std::cerr << "[loadScene] " << meshes.size() << " mesh(es), " << images.size()
+		          << " texture(s) shared by " << objectCount << " object(s)" << std::endl;
+	}
 
-		o->position = pos;
-		o->rotation = rot;
-		o->scale    = scl;
+	objects.reserve(objectCount);
+	for (size_t i = 0; i < objectCount; ++i) {
+		const Object* mesh = sceneMeshes[objectMesh[i]];
 
-		if (!texPath.empty()) {
-			o->texture(texPath);
+		Object* o = new Object();
+		o->id = ++objCounter;
+		o->type = mesh->type;
+		std::string name = data.str(data.names[i]);
+		o->name = name.empty() ? meshes[objectMesh[i]].type : name;
+
+		o->meshSource = mesh;
+		o->VAO = mesh->VAO;
+		o->VBO = mesh->VBO;
+		o->EBO = mesh->EBO;
+
+		o->position = data.position(i);
+		o->rotation = data.rotation(i);
+		o->scale    = data.scale(i);
+
+		if (objectImage[i] >= 0) {
+			o->texturePath = images[objectImage[i]].path;
+			o->textureID = sceneTextures[objectImage[i]];
+			o->sharedTexture = true;
 		}
 
 		objects.push_back(o);
-	}
+		attachObject(o);
+		indexObject(o);
 
-	if (j.find("lights") == j.end() || !j["lights"].is_array()) {
-		std::cerr << "[loadScene] No 'lights' array in scene\n";
+		if (progress && (i + 1) % UPLOAD_BATCH_SIZE == 0) {
+			progress("Creating objects", 0.9f + 0.1f * (float)(i + 1) / (float)objectCount);
+		}
 	}
 
-	for (size_t li = 0; li < j["lights"].size(); ++li) {
-		Vec3d color = {1,1,1};
-		Vec3d pos = {0,0,0};
-		LightType type = LightType::Directional;
-
-		const json& lightJson = j["lights"][li];
-		if (lightJson.find("type") != lightJson.end()) {
-			std::string typeStr = lightJson["type"];
-			if (typeStr == "Directional") type = LightType::Directional;
-			else type = LightType::Point;
-		}
-		if (lightJson.find("position") != lightJson.end() && lightJson["position"].size() == 3) {
-			pos = Vec3d(lightJson["position"][0], lightJson["position"][1], lightJson["position"][2]);
-		}
-		if (lightJson.find("color") != lightJson.end() && lightJson["color"].size() == 3) {
-			color = Vec3d(
-				static_cast<float>(lightJson["color"][0]),
-				static_cast<float>(lightJson["color"][1]),
-				static_cast<float>(lightJson["color"][2])
-			);
-		}
-		float intensity = lightJson.value("intensity", 1.0f);
-		Light light(type, color, intensity);
-		light.position = pos;
+	for (size_t li = 0; li < data.lightCount(); ++li) {
+		Light light(data.lightType(li), data.lightColor(li), data.lightIntensities[li]);
+		light.position = data.lightPosition(li);
+		light.direction = data.lightDirection(li);
 		lights.push_back(light);
-		std::string tname = (type == LightType::Directional) ? "Directional" : "Point";
+
+		Vec3d pos = light.position;
+		Vec3d color = light.color;
+		std::string tname = (light.type == LightType::Directional) ? "Directional" : "Point";
 		std::cerr << "[loadScene] loaded light[" << li << "] type=" << tname
 				  << " pos=(" << pos.x << "," << pos.y << "," << pos.z << ")"
 				  << " color=(" << color.x << "," << color.y << "," << color.z << ")"
-				  << " intensity=" << intensity << std::endl;
+				  << " intensity=" << light.intensity << std::endl;
 
+		if (light.type != LightType::Directional) {
+			lightShadows.push_back(NULL);
+			continue;
+		}
 		Shadow* sh = new Shadow();
 		sh->lightPos = light.position;
 		sh->lightDir = light.direction;
@@ -861,4 +1543,127 @@ void SceneManager::loadScene(const std::string& path) {
 		sh->farP = 60.0f;
 		lightShadows.push_back(sh);
 	}
-}
\ No newline at end of file
+
+	if (progress) progress("Done", 1.0f);
+}
+
+void SceneManager::saveScene(const std::string& path) {
+	SceneData data;
+	buildSceneData(data);
+	if (!SceneSerializer::save(path, data)) {
+		std::cerr << "[saveScene] Failed to save " << path << "\n";
+	}
+	lastOwnSave = std::chrono::steady_clock::now();
+}
+
+void SceneManager::saveSceneAsync(const std::string& path) {
+	// lastOwnSave is taken from the saver once the write is done, see onAssetChanged
+	SceneData snapshot;
+	buildSceneData(snapshot);
+	saver.save(path, snapshot);
+}
+
+void SceneManager::autosaveScene(const std::string& journalPath) {
+	SceneData snapshot;
+	buildSceneData(snapshot);
+
+	std::vector<uint32_t> ids(objects.size());
+	for (size_t i = 0; i < objects.size(); ++i) {
+		// objects pushed into the scene directly have no id yet
+		if (objects[i]->id == 0) objects[i]->id = ++objCounter;
+		ids[i] = objects[i]->id;
+	}
+	saver.autosave(journalPath, snapshot, ids);
+}
+
+bool SceneManager::recoverAutosave(const std::string& journalPath) {
+	saver.wait();
+	SceneData data;
+	if (!SceneSaver::loadJournal(journalPath, data)) return false;
+	applySceneData(data);
+	return true;
+}
+
+void SceneManager::loadScene(const std::string& path, const SceneLoadProgress& progress) {
+	// a save of this very file may still be in flight
+	saver.wait();
+
+	// Parse fully before touching the current scene so a bad file leaves it intact.
+	if (progress) progress("Parsing", 0.0f);
+	SceneData data;
+	if (!SceneSerializer::load(path, data)) {
+		std::cerr << "[loadScene] Failed to load " << path << "\n";
+		return;
+	}
+	loadedScenePath = FileWatcher::normalize(path);
+	applySceneData(data, progress);
+}
+
+void SceneManager::generateScene(const SceneGenSettings& settings, const SceneLoadProgress& progress) {
+	saver.wait();
+	if (progress) progress("Generating", 0.0f);
+	SceneData data;
+	SceneGenerator::generate(settings, data);
+	loadedScenePath.clear();
+	applySceneData(data, progress);
+}
+
+void SceneManager::onAssetChanged(const FileWatcher::Change& change) {
+	FrameAllocator::expectAllocations();
+
+	if (change.kind == FileWatcher::SHADER) {
+		// Any file may be included by any program; resubmitting an unchanged variant is a cache
+		// hit, so there is no need to track which files each program pulled in.
+		resubmitProgram(s_unlitPending, s_unlitVertPath, s_unlitFragPath);
+		resubmitProgram(shadowDepthPending, s_shadowDepthVertPath, s_shadowDepthFragPath);
+		resubmitProgram(pointShadowDepthPending, s_pointDepthVertPath, s_pointDepthFragPath);
+		// the grid only exists once initGrid has run
+		if (gridProgram != 0) resubmitProgram(gridPending, s_gridVertPath, s_gridFragPath);
+	} else if (change.kind == FileWatcher::TEXTURE) {
+		reloadTexture(change.path);
+	} else if (change.kind == FileWatcher::SCENE) {
+		if (change.path != loadedScenePath) return;
+		if (saver.busy()) return;
+		// the grace period runs from the end of the write, a slow save would outlast it otherwise
+		std::chrono::steady_clock::time_point saved = saver.lastSaveFinished();
+		if (saved > lastOwnSave) lastOwnSave = saved;
+		if (std::chrono::steady_clock::now() - lastOwnSave < OWN_SAVE_GRACE) return;
+		std::cerr << "[SceneManager] Reloading changed scene " << change.path << std::endl;
+		loadScene(change.path);
+	}
+}
+
+void SceneManager::reloadTexture(const std::string& path) {
+	int width, height, channels;
+	unsigned char* pixels = NULL;
+
+	// Objects share texture names (pooled instances use their prefab's), so each name is
+	// re-uploaded in place once and every user sees the new image.
+	std::vector<GLuint> updated;
+	for (size_t i = 0; i < objects.size(); ++i) {
+		Object* o = objects[i];
+		if (o->textureID == 0 || o->texturePath.empty()) continue;
+		if (FileWatcher::normalize(o->texturePath) != path) continue;
+		if (std::find(updated.begin(), updated.end(), o->textureID) != updated.end()) continue;
+
+		if (!pixels) {
+			pixels = stbi_load(path.c_str(), &width, &height, &channels, 0);
+			if (!pixels) {
+				// usually a half-written file; the finished write brings another event
+				std::cerr << "[SceneManager] Failed to reload texture " << path << ": " << stbi_failure_reason() << std::endl;
+				return;
+			}
+		}
+		GLenum format = (channels == 4) ? GL_RGBA : GL_RGB;
+		glBindTexture(GL_TEXTURE_2D, o->textureID);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		updated.push_back(o->textureID);
+	}
+	if (pixels) {
+		stbi_image_free(pixels);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		std::cerr << "[SceneManager] Reloaded texture " << path << " (" << updated.size() << " texture(s))" << std::endl;
+	}
+}
@@ -0,0 +1,239 @@
+#include "Engine/util/fileWatcher.hpp"
+#include "filesystem/filesystem.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// How long a path must go without events before it is reported.
+const std::chrono::milliseconds QUIET_PERIOD(200);
+// Rescan interval of the polling fallback.
+const std::chrono::milliseconds SCAN_INTERVAL(500);
+
+bool endsWith(const std::string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+} // namespace
+
+FileWatcher::FileWatcher()
+    : inotifyFd(-1), running(false) {
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        std::cerr << "[FileWatcher] inotify unavailable, falling back to polling" << std::endl;
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+    stop();
+#ifdef __linux__
+    if (inotifyFd >= 0) close(inotifyFd);
+#endif
+}
+
+FileWatcher::Kind FileWatcher::kindOf(const std::string& path) {
+    std::string lower(path);
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (endsWith(lower, ".glsl") || endsWith(lower, ".vert") || endsWith(lower, ".frag")) return SHADER;
+    if (endsWith(lower, ".png") || endsWith(lower, ".jpg") || endsWith(lower, ".jpeg") ||
+        endsWith(lower, ".bmp") || endsWith(lower, ".tga")) return TEXTURE;
+    if (endsWith(lower, ".gscene") || endsWith(lower, ".gsceneb")) return SCENE;
+    return OTHER;
+}
+
+std::string FileWatcher::normalize(const std::string& path) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find_first_of("/\\", start);
+        if (end == std::string::npos) end = path.size();
+        std::string part = path.substr(start, end - start);
+        if (part == "..") {
+            if (!parts.empty() && parts.back() != "..") parts.pop_back();
+            else parts.push_back(part);
+        } else if (!part.empty() && part != ".") {
+            parts.push_back(part);
+        }
+        start = end + 1;
+    }
+    std::string out = (!path.empty() && (path[0] == '/' || path[0] == '\\')) ? "/" : "";
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (i) out += '/';
+        out += parts[i];
+    }
+    return out;
+}
+
+void FileWatcher::watchDirectory(const std::string& dir) {
+    std::string root = normalize(dir);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (std::find(roots.begin(), roots.end(), root) != roots.end()) return;
+    roots.push_back(root);
+    // the polling fallback takes its baseline on the worker's next scan
+    if (inotifyFd >= 0) addWatches(root);
+}
+
+void FileWatcher::addWatches(const std::string& dir) {
+#ifdef __linux__
+    if (!fs::exists(dir)) return;
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+    std::vector<std::string> dirs(1, dir);
+    fs::recursive_directory_iterator it(dir), end;
+    for (; it != end; ++it) {
+        if (it->is_directory()) dirs.push_back(normalize(it->path().string()));
+    }
+    for (size_t i = 0; i < dirs.size(); ++i) {
+        int wd = inotify_add_watch(inotifyFd, dirs[i].c_str(), mask);
+        if (wd >= 0) watchDirs[wd] = dirs[i];
+    }
+#else
+    (void)dir;
+#endif
+}
+
+void FileWatcher::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) return;
+    running = true;
+    worker = std::thread(&FileWatcher::workerLoop, this);
+}
+
+void FileWatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void FileWatcher::poll(std::vector<Change>& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (settled.empty()) return;
+    out.insert(out.end(), settled.begin(), settled.end());
+    settled.clear();
+}
+
+void FileWatcher::note(const std::string& path) {
+    if (kindOf(path) == OTHER) return;
+    unsettled[path] = Clock::now();
+}
+
+void FileWatcher::settle() {
+    Clock::time_point now = Clock::now();
+    for (std::unordered_map<std::string, Clock::time_point>::iterator it = unsettled.begin(); it != unsettled.end();) {
+        if (now - it->second < QUIET_PERIOD) { ++it; continue; }
+        Change change;
+        change.path = it->first;
+        change.kind = kindOf(it->first);
+        settled.push_back(change);
+        it = unsettled.erase(it);
+    }
+}
+
+void FileWatcher::readInotify() {
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        ssize_t len = read(inotifyFd, buffer, sizeof(buffer));
+        if (len <= 0) break;    // EAGAIN: drained
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (char* p = buffer; p < buffer + len;) {
+            const struct inotify_event* ev = (const struct inotify_event*)p;
+            p += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & IN_IGNORED) { watchDirs.erase(ev->wd); continue; }
+            std::unordered_map<int, std::string>::const_iterator dir = watchDirs.find(ev->wd);
+            if (dir == watchDirs.end() || ev->len == 0) continue;
+            std::string path = dir->second + "/" + ev->name;
+
+            if (ev->mask & IN_ISDIR) {
+                if (ev->mask & (IN_CREATE | IN_MOVED_TO)) addWatches(path);
+            } else if (ev->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                note(path);
+            }
+        }
+    }
+#endif
+}
+
+// Polling fallback: compares size and mtime of every file under the roots with the last scan.
+void FileWatcher::scanForChanges() {
+    std::vector<std::string> scanRoots;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        scanRoots = roots;
+    }
+
+    std::vector<std::string> changed;
+    for (size_t r = 0; r < scanRoots.size(); ++r) {
+        if (!fs::exists(scanRoots[r])) continue;
+        // a root seen for the first time only records its baseline
+        const bool baseline = std::find(scannedRoots.begin(), scannedRoots.end(), scanRoots[r]) == scannedRoots.end();
+        if (baseline) scannedRoots.push_back(scanRoots[r]);
+
+        fs::recursive_directory_iterator it(scanRoots[r]), end;
+        for (; it != end; ++it) {
+            if (!it->is_regular_file()) continue;
+            std::string path = normalize(it->path().string());
+            if (kindOf(path) == OTHER) continue;
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0) continue;
+
+            Snapshot now = { (long long)st.st_mtime, (long long)st.st_size };
+            std::unordered_map<std::string, Snapshot>::iterator prev = snapshots.find(path);
+            if (prev == snapshots.end()) {
+                snapshots[path] = now;
+                if (!baseline) changed.push_back(path);
+            } else if (prev->second.mtime != now.mtime || prev->second.size != now.size) {
+                prev->second = now;
+                changed.push_back(path);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < changed.size(); ++i) note(changed[i]);
+}
+
+void FileWatcher::workerLoop() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!running) break;
+        }
+
+        if (inotifyFd >= 0) {
+#ifdef __linux__
+            // short timeout so stop() and the quiet period are noticed without a wake-up fd
+            struct pollfd pfd;
+            pfd.fd = inotifyFd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (::poll(&pfd, 1, 100) > 0) readInotify();
+#endif
+        } else {
+            scanForChanges();
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait_for(lock, SCAN_INTERVAL, [this] { return !running; });
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        settle();
+    }
+}
@@ -0,0 +1,142 @@
+#include "Engine/util/frameArena.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+// ---------------------------------------------------------------- allocation counting
+
+#if defined(GENGINE_TRACK_ALLOCATIONS)
+// Counting replacements for the global allocation functions. Per thread, so worker threads
+// (saver, pool jobs) do not show up in the main thread's frame count.
+static thread_local size_t t_heapAllocations = 0;
+
+void* operator new(size_t bytes) {
+    ++t_heapAllocations;
+    void* p = std::malloc(bytes ? bytes : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t bytes) { return operator new(bytes); }
+void* operator new(size_t bytes, const std::nothrow_t&) noexcept {
+    ++t_heapAllocations;
+    return std::malloc(bytes ? bytes : 1);
+}
+void* operator new[](size_t bytes, const std::nothrow_t& tag) noexcept { return operator new(bytes, tag); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+#endif
+
+// ---------------------------------------------------------------- FrameArena
+
+FrameArena::FrameArena(size_t capacity)
+    : base(static_cast<char*>(std::malloc(capacity))), size(capacity), offset(0),
+      overflowBytes(0), highWater(0)
+{
+    if (!base) size = 0;
+}
+
+FrameArena::~FrameArena() {
+    reset();
+    std::free(base);
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+    uintptr_t p = (uintptr_t)(base + offset);
+    uintptr_t aligned = (p + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    size_t newOffset = (size_t)(aligned - (uintptr_t)base) + bytes;
+    if (base && newOffset <= size) {
+        offset = newOffset;
+        return (void*)aligned;
+    }
+
+    // Out of room this frame; malloc keeps max_align_t alignment, enough for everything here.
+    void* extra = std::malloc(bytes ? bytes : 1);
+    if (!extra) throw std::bad_alloc();
+    overflows.push_back(extra);
+    overflowBytes += bytes;
+    return extra;
+}
+
+void FrameArena::reset() {
+    size_t frameBytes = offset + overflowBytes;
+    if (frameBytes > highWater) highWater = frameBytes;
+
+    for (size_t i = 0; i < overflows.size(); ++i) std::free(overflows[i]);
+    overflows.clear();
+    overflowBytes = 0;
+    offset = 0;
+
+    if (highWater > size) {
+        // grow with some headroom so the next peak fits without overflowing again
+        size_t newSize = highWater + highWater / 2;
+        char* grown = static_cast<char*>(std::malloc(newSize));
+        if (grown) {
+            std::free(base);
+            base = grown;
+            size = newSize;
+        }
+    }
+}
+
+// ---------------------------------------------------------------- FrameAllocator
+
+static FrameArena* frameArenas() {
+    static FrameArena arenas[2];
+    return arenas;
+}
+
+static unsigned int s_currentArena = 0;
+static unsigned int s_frameIndex = 0;
+static size_t s_frameHeapAllocations = 0;
+static size_t s_lastFrameHeapAllocations = 0;
+static bool s_frameExpectsAllocations = false;
+
+FrameArena& FrameAllocator::current() { return frameArenas()[s_currentArena]; }
+FrameArena& FrameAllocator::previous() { return frameArenas()[s_currentArena ^ 1]; }
+
+void FrameAllocator::endFrame() {
+    s_lastFrameHeapAllocations = s_frameHeapAllocations;
+    bool steady = !s_frameExpectsAllocations && s_frameIndex >= WARMUP_FRAMES;
+    s_frameHeapAllocations = 0;
+    s_frameExpectsAllocations = false;
+    ++s_frameIndex;
+
+#if defined(GENGINE_TRACK_ALLOCATIONS)
+    if (steady && s_lastFrameHeapAllocations > 0) {
+        std::cerr << "[FrameAllocator] " << s_lastFrameHeapAllocations
+                  << " heap allocations in steady-state frame " << s_frameIndex << std::endl;
+        assert(!"heap allocation in a steady-state frame");
+    }
+#else
+    (void)steady;
+#endif
+
+    // the arena filled two frames ago is free again
+    s_currentArena ^= 1;
+    frameArenas()[s_currentArena].reset();
+}
+
+void FrameAllocator::expectAllocations() { s_frameExpectsAllocations = true; }
+
+size_t FrameAllocator::lastFrameHeapAllocations() { return s_lastFrameHeapAllocations; }
+void FrameAllocator::addHeapAllocations(size_t count) { s_frameHeapAllocations += count; }
+
+size_t FrameAllocator::threadHeapAllocations() {
+#if defined(GENGINE_TRACK_ALLOCATIONS)
+    return t_heapAllocations;
+#else
+    return 0;
+#endif
+}
+
+bool FrameAllocator::trackingAllocations() {
+#if defined(GENGINE_TRACK_ALLOCATIONS)
+    return true;
+#else
+    return false;
+#endif
+}
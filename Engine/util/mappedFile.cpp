@@ -0,0 +1,121 @@
+#include "Engine/util/mappedFile.hpp"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : ptr(nullptr), length(0), opened(false)
+#ifdef _WIN32
+    , fileHandle(nullptr), mappingHandle(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[MappedFile] Failed to open " << path << "\n";
+        return false;
+    }
+
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(file, &sz)) {
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    length = (size_t)sz.QuadPart;
+    opened = true;
+    if (length == 0) return true; // empty files cannot be mapped
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        std::cerr << "[MappedFile] CreateFileMapping failed for " << path << "\n";
+        close();
+        return false;
+    }
+    mappingHandle = mapping;
+
+    ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!ptr) {
+        std::cerr << "[MappedFile] MapViewOfFile failed for " << path << "\n";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (ptr) UnmapViewOfFile(ptr);
+    if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+    ptr = nullptr;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+    length = 0;
+    opened = false;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "[MappedFile] Failed to open " << path << "\n";
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    length = (size_t)st.st_size;
+    opened = true;
+    if (length == 0) {
+        ::close(fd);
+        return true; // empty files cannot be mapped
+    }
+
+    void* p = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps its own reference to the file
+    if (p == MAP_FAILED) {
+        std::cerr << "[MappedFile] mmap failed for " << path << "\n";
+        length = 0;
+        opened = false;
+        return false;
+    }
+    madvise(p, length, MADV_SEQUENTIAL);
+    ptr = p;
+    return true;
+}
+
+void MappedFile::close() {
+    if (ptr) munmap(ptr, length);
+    ptr = nullptr;
+    length = 0;
+    opened = false;
+}
+
+#endif
@@ -0,0 +1,411 @@
+#include "Engine/util/profiler.hpp"
+#include "glad/glad.h"
+#include "imgui/imgui.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const Clock::time_point s_epoch = Clock::now();
+
+uint64_t nowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - s_epoch).count();
+}
+
+bool s_enabled = true;
+bool s_inFrame = false;
+std::thread::id s_mainThread;
+uint64_t s_frameIndex = 0;
+
+// s_frames[s_building] is being recorded, the other one is the last completed frame.
+Profiler::Frame s_frames[2];
+int s_building = 0;
+int s_depth = 0;
+
+struct GpuSlot {
+    GLuint queries[Profiler::MAX_GPU_SCOPES];
+    Profiler::GpuScope scopes[Profiler::MAX_GPU_SCOPES];
+    int count;
+    bool pending;
+    uint64_t frame;
+};
+
+GpuSlot s_gpuSlots[Profiler::GPU_LATENCY];
+bool s_gpuInitialized = false;
+bool s_gpuAvailable = false;
+int s_activeGpuScope = -1;
+Profiler::GpuScope s_lastGpu[Profiler::MAX_GPU_SCOPES];
+int s_lastGpuCount = 0;
+uint64_t s_lastGpuFrame = 0;
+
+float s_frameMs[Profiler::HISTORY];
+float s_gpuMs[Profiler::HISTORY];
+
+FILE* s_trace = NULL;
+bool s_traceFirstEvent = true;
+bool s_traceAtExit = false;
+
+void writeTraceEvent(const char* name, int tid, uint64_t startNs, uint64_t durNs) {
+    fprintf(s_trace, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+            s_traceFirstEvent ? "" : ",", name, tid, startNs / 1000.0, durNs / 1000.0);
+    s_traceFirstEvent = false;
+}
+
+void initGpuQueries() {
+    s_gpuInitialized = true;
+    // no context (or a loader that skipped queries): CPU scopes only
+    s_gpuAvailable = glGenQueries != NULL && glGetQueryObjectui64v != NULL;
+    if (!s_gpuAvailable) return;
+    for (int s = 0; s < Profiler::GPU_LATENCY; ++s) {
+        glGenQueries(Profiler::MAX_GPU_SCOPES, s_gpuSlots[s].queries);
+        s_gpuSlots[s].count = 0;
+        s_gpuSlots[s].pending = false;
+    }
+}
+
+// Reads a slot's queries if the GPU is done with them; never waits.
+bool resolveGpuSlot(GpuSlot& slot) {
+    if (!slot.pending) return true;
+    GLint available = 0;
+    // queries finish in submission order, so the last one stands for all of them
+    glGetQueryObjectiv(slot.queries[slot.count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+
+    uint64_t totalNs = 0;
+    for (int i = 0; i < slot.count; ++i) {
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &ns);
+        slot.scopes[i].gpuNs = ns;
+        totalNs += ns;
+        // the GPU clock is not synchronised with ours; passes are placed where they were issued
+        if (s_trace) writeTraceEvent(slot.scopes[i].name, 2, slot.scopes[i].cpuStartNs, ns);
+    }
+    if (slot.frame + Profiler::HISTORY > s_frameIndex) s_gpuMs[slot.frame % Profiler::HISTORY] = totalNs / 1e6f;
+    if (slot.frame >= s_lastGpuFrame) {
+        std::copy(slot.scopes, slot.scopes + slot.count, s_lastGpu);
+        s_lastGpuCount = slot.count;
+        s_lastGpuFrame = slot.frame;
+    }
+    slot.pending = false;
+    return true;
+}
+
+} // namespace
+
+void Profiler::setEnabled(bool enabled) {
+    s_enabled = enabled;
+}
+
+bool Profiler::enabled() {
+    return s_enabled;
+}
+
+void Profiler::beginFrame() {
+    if (!s_enabled) return;
+    s_mainThread = std::this_thread::get_id();
+    s_inFrame = true;
+    s_depth = 0;
+
+    Frame& frame = s_frames[s_building];
+    frame.index = s_frameIndex;
+    frame.startNs = nowNs();
+    frame.endNs = frame.startNs;
+    frame.scopeCount = 0;
+    frame.droppedScopes = 0;
+
+    // The slot last used GPU_LATENCY frames ago; if its results are still not back, drop them
+    // rather than stall.
+    if (s_gpuAvailable) {
+        GpuSlot& slot = s_gpuSlots[s_frameIndex % GPU_LATENCY];
+        if (!resolveGpuSlot(slot)) slot.pending = false;
+        slot.count = 0;
+        slot.frame = s_frameIndex;
+    }
+}
+
+void Profiler::endFrame() {
+    if (!s_inFrame) return;
+    if (s_activeGpuScope >= 0) endGpuScope(s_activeGpuScope);
+
+    Frame& frame = s_frames[s_building];
+    frame.endNs = nowNs();
+    s_frameMs[s_frameIndex % HISTORY] = (frame.endNs - frame.startNs) / 1e6f;
+    s_gpuMs[s_frameIndex % HISTORY] = 0.0f;
+
+    if (s_trace) {
+        writeTraceEvent("Frame", 1, frame.startNs, frame.endNs - frame.startNs);
+        for (int i = 0; i < frame.scopeCount; ++i) {
+            const Scope& s = frame.scopes[i];
+            writeTraceEvent(s.name, 1, s.startNs, std::max(s.endNs, s.startNs) - s.startNs);
+        }
+    }
+
+    if (s_gpuAvailable) {
+        GpuSlot& current = s_gpuSlots[s_frameIndex % GPU_LATENCY];
+        current.pending = current.count > 0;
+        for (int s = 0; s < GPU_LATENCY; ++s) resolveGpuSlot(s_gpuSlots[s]);
+    }
+
+    s_building ^= 1;
+    ++s_frameIndex;
+    s_inFrame = false;
+}
+
+int Profiler::beginScope(const char* name) {
+    if (!s_inFrame || std::this_thread::get_id() != s_mainThread) return -1;
+    Frame& frame = s_frames[s_building];
+    if (frame.scopeCount >= MAX_SCOPES) {
+        ++frame.droppedScopes;
+        return -1;
+    }
+    Scope& s = frame.scopes[frame.scopeCount];
+    s.name = name;
+    s.depth = s_depth++;
+    s.startNs = nowNs();
+    s.endNs = 0;
+    return frame.scopeCount++;
+}
+
+void Profiler::endScope(int scope) {
+    if (scope < 0 || !s_inFrame) return;
+    s_frames[s_building].scopes[scope].endNs = nowNs();
+    --s_depth;
+}
+
+int Profiler::beginGpuScope(const char* name) {
+    if (!s_inFrame || s_activeGpuScope >= 0 || std::this_thread::get_id() != s_mainThread) return -1;
+    if (!s_gpuInitialized) {
+        initGpuQueries();
+        if (s_gpuAvailable) {
+            GpuSlot& slot = s_gpuSlots[s_frameIndex % GPU_LATENCY];
+            slot.frame = s_frameIndex;
+        }
+    }
+    if (!s_gpuAvailable) return -1;
+
+    GpuSlot& slot = s_gpuSlots[s_frameIndex % GPU_LATENCY];
+    if (slot.count >= MAX_GPU_SCOPES) return -1;
+    GpuScope& s = slot.scopes[slot.count];
+    s.name = name;
+    s.cpuStartNs = nowNs();
+    s.gpuNs = 0;
+    glBeginQuery(GL_TIME_ELAPSED, slot.queries[slot.count]);
+    s_activeGpuScope = slot.count;
+    return slot.count++;
+}
+
+void Profiler::endGpuScope(int scope) {
+    if (scope < 0 || scope != s_activeGpuScope) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    s_activeGpuScope = -1;
+}
+
+bool Profiler::startTrace(const std::string& path) {
+    stopTrace();
+    s_trace = fopen(path.c_str(), "w");
+    if (!s_trace) {
+        std::cerr << "[Profiler] Cannot write trace " << path << std::endl;
+        return false;
+    }
+    s_traceFirstEvent = true;
+    fprintf(s_trace, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    fprintf(s_trace, "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Main thread\"}},");
+    fprintf(s_trace, "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+    s_traceFirstEvent = false;
+    if (!s_traceAtExit) {
+        std::atexit(&Profiler::stopTrace);
+        s_traceAtExit = true;
+    }
+    std::cerr << "[Profiler] Writing trace to " << path << std::endl;
+    return true;
+}
+
+void Profiler::stopTrace() {
+    if (!s_trace) return;
+    fprintf(s_trace, "\n]}\n");
+    fclose(s_trace);
+    s_trace = NULL;
+}
+
+const Profiler::Frame& Profiler::lastFrame() {
+    return s_frames[s_building ^ 1];
+}
+
+int Profiler::lastGpuScopes(const GpuScope*& scopes) {
+    scopes = s_lastGpu;
+    return s_lastGpuCount;
+}
+
+float Profiler::frameMs(int framesAgo) {
+    if (framesAgo < 0 || framesAgo >= HISTORY || (uint64_t)framesAgo >= s_frameIndex) return 0.0f;
+    return s_frameMs[(s_frameIndex - 1 - framesAgo) % HISTORY];
+}
+
+float Profiler::gpuMs(int framesAgo) {
+    if (framesAgo < 0 || framesAgo >= HISTORY || (uint64_t)framesAgo >= s_frameIndex) return 0.0f;
+    return s_gpuMs[(s_frameIndex - 1 - framesAgo) % HISTORY];
+}
+
+// ---- ImGui views --------------------------------------------------------------------------
+
+namespace {
+
+const int MAX_FLAME_DEPTH = 64;
+
+struct FlameNode {
+    const char* name;
+    int parent;
+    int depth;
+    uint64_t ns;
+    uint64_t x;         // offset inside the parent, laid out left to right
+};
+
+FlameNode s_flame[Profiler::MAX_SCOPES];   // scratch for the flame view
+
+ImU32 colorFor(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const char* c = name; *c; ++c) h = (h ^ (uint8_t)*c) * 16777619u;
+    return ImColor::HSV((h % 360) / 360.0f, 0.45f, 0.8f);
+}
+
+void drawBar(ImDrawList* dl, const ImVec2& min, const ImVec2& max, const char* name, double ms) {
+    if (max.x - min.x < 1.0f) return;
+    dl->AddRectFilled(min, max, colorFor(name));
+    dl->AddRect(min, max, IM_COL32(0, 0, 0, 96));
+    dl->PushClipRect(min, max, true);
+    dl->AddText(ImVec2(min.x + 3.0f, min.y + 1.0f), IM_COL32(0, 0, 0, 255), name);
+    dl->PopClipRect();
+    if (ImGui::IsMouseHoveringRect(min, max)) ImGui::SetTooltip("%s\n%.3f ms", name, ms);
+}
+
+float historyValue(void*, int idx) {
+    return Profiler::frameMs(Profiler::HISTORY - 1 - idx);
+}
+
+// CPU scopes where they happened in the frame, GPU passes below on the same scale.
+void drawTimeline(const Profiler::Frame& frame, const Profiler::GpuScope* gpu, int gpuCount) {
+    int maxDepth = 0;
+    for (int i = 0; i < frame.scopeCount; ++i) maxDepth = std::max(maxDepth, frame.scopes[i].depth);
+
+    const float rowH = ImGui::GetTextLineHeight() + 4.0f;
+    const float width = std::max(ImGui::GetContentRegionAvail().x, 50.0f);
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float gpuY = origin.y + (maxDepth + 1) * rowH + rowH * 0.5f;
+    ImGui::InvisibleButton("##timeline", ImVec2(width, gpuY - origin.y + rowH));
+
+    ImDrawList* dl = ImGui::GetWindowDrawList();
+    const double frameNs = (double)std::max<uint64_t>(frame.endNs - frame.startNs, 1);
+    const double scale = width / frameNs;
+    for (int i = 0; i < frame.scopeCount; ++i) {
+        const Profiler::Scope& s = frame.scopes[i];
+        uint64_t end = std::max(s.endNs, s.startNs);
+        ImVec2 min(origin.x + (float)((s.startNs - frame.startNs) * scale), origin.y + s.depth * rowH);
+        ImVec2 max(origin.x + (float)((end - frame.startNs) * scale), min.y + rowH - 1.0f);
+        drawBar(dl, min, max, s.name, (end - s.startNs) / 1e6);
+    }
+
+    float x = origin.x;
+    for (int i = 0; i < gpuCount; ++i) {
+        float w = (float)(gpu[i].gpuNs * scale);
+        drawBar(dl, ImVec2(x, gpuY), ImVec2(x + w, gpuY + rowH - 1.0f), gpu[i].name, gpu[i].gpuNs / 1e6);
+        x += w;
+    }
+    dl->AddText(ImVec2(origin.x, gpuY + rowH), ImGui::GetColorU32(ImGuiCol_TextDisabled), "GPU passes (back to back)");
+    ImGui::Dummy(ImVec2(0.0f, rowH));
+}
+
+// Scopes with the same name under the same parent merged, widths proportional to their total.
+void drawFlame(const Profiler::Frame& frame) {
+    int nodeCount = 0;
+    int stack[MAX_FLAME_DEPTH];
+    int maxDepth = 0;
+    for (int i = 0; i < frame.scopeCount; ++i) {
+        const Profiler::Scope& s = frame.scopes[i];
+        if (s.depth >= MAX_FLAME_DEPTH) continue;
+        int parent = s.depth > 0 ? stack[s.depth - 1] : -1;
+        int n = 0;
+        while (n < nodeCount && !(s_flame[n].parent == parent && strcmp(s_flame[n].name, s.name) == 0)) ++n;
+        if (n == nodeCount) {
+            FlameNode& node = s_flame[nodeCount++];
+            node.name = s.name;
+            node.parent = parent;
+            node.depth = s.depth;
+            node.ns = 0;
+            node.x = 0;
+        }
+        s_flame[n].ns += std::max(s.endNs, s.startNs) - s.startNs;
+        stack[s.depth] = n;
+        maxDepth = std::max(maxDepth, s.depth);
+    }
+
+    // parents are created before their children, so one pass lays everything out
+    uint64_t cursor[Profiler::MAX_SCOPES];
+    uint64_t rootCursor = 0;
+    for (int n = 0; n < nodeCount; ++n) {
+        FlameNode& node = s_flame[n];
+        uint64_t& c = node.parent < 0 ? rootCursor : cursor[node.parent];
+        node.x = (node.parent < 0 ? 0 : s_flame[node.parent].x) + c;
+        c += node.ns;
+        cursor[n] = 0;
+    }
+
+    const float rowH = ImGui::GetTextLineHeight() + 4.0f;
+    const float width = std::max(ImGui::GetContentRegionAvail().x, 50.0f);
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::InvisibleButton("##flame", ImVec2(width, (maxDepth + 1) * rowH));
+
+    ImDrawList* dl = ImGui::GetWindowDrawList();
+    const double scale = width / (double)std::max<uint64_t>(frame.endNs - frame.startNs, 1);
+    for (int n = 0; n < nodeCount; ++n) {
+        const FlameNode& node = s_flame[n];
+        ImVec2 min(origin.x + (float)(node.x * scale), origin.y + node.depth * rowH);
+        ImVec2 max(min.x + (float)(node.ns * scale), min.y + rowH - 1.0f);
+        drawBar(dl, min, max, node.name, node.ns / 1e6);
+    }
+}
+
+} // namespace
+
+void Profiler::drawWindow(bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(720, 360), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+
+    bool on = s_enabled;
+    if (ImGui::Checkbox("Record", &on)) setEnabled(on);
+
+    const Frame& frame = lastFrame();
+    const GpuScope* gpu = NULL;
+    const int gpuCount = lastGpuScopes(gpu);
+    float gpuTotal = 0.0f;
+    for (int i = 0; i < gpuCount; ++i) gpuTotal += gpu[i].gpuNs / 1e6f;
+
+    ImGui::SameLine();
+    ImGui::Text("CPU %.2f ms   GPU %.2f ms   %d scopes%s", (frame.endNs - frame.startNs) / 1e6f, gpuTotal,
+                frame.scopeCount, frame.droppedScopes ? " (some dropped)" : "");
+    ImGui::PlotLines("##frametimes", &historyValue, NULL, HISTORY, 0, "frame ms", 0.0f, 50.0f,
+                     ImVec2(ImGui::GetContentRegionAvail().x, 60.0f));
+
+    if (ImGui::BeginTabBar("ProfilerViews")) {
+        if (ImGui::BeginTabItem("Timeline")) {
+            drawTimeline(frame, gpu, gpuCount);
+            ImGui::EndTabItem();
+        }
+        if (ImGui::BeginTabItem("Flame")) {
+            drawFlame(frame);
+            ImGui::EndTabItem();
+        }
+        ImGui::EndTabBar();
+    }
+    ImGui::End();
+}
@@ -0,0 +1,290 @@
+#include "Engine/util/renderStats.hpp"
+#include "glad/glad.h"
+#include "imgui/imgui.h"
+
+#include <cstring>
+
+namespace {
+
+const int MAX_PASS_DEPTH = 8;
+
+// s_frames[s_building] collects this frame, the other one is the last completed frame.
+RenderStats::Frame s_frames[2];
+int s_building = 0;
+uint64_t s_frameIndex = 0;
+int s_passStack[MAX_PASS_DEPTH];
+int s_passDepth = 0;
+bool s_installed = false;
+
+void resetFrame(RenderStats::Frame& frame) {
+    memset(&frame, 0, sizeof(frame));
+    frame.index = s_frameIndex;
+    frame.passes[0].name = "Other";
+    frame.passCount = 1;
+}
+
+struct FrameInit {
+    FrameInit() { resetFrame(s_frames[0]); resetFrame(s_frames[1]); }
+} s_frameInit;
+
+inline RenderStats::Counters& counters() {
+    RenderStats::Frame& frame = s_frames[s_building];
+    return frame.passes[s_passDepth ? s_passStack[s_passDepth - 1] : 0].counters;
+}
+
+#ifdef GENGINE_RENDER_STATS
+
+uint64_t trianglesFor(GLenum mode, GLsizei count) {
+    switch (mode) {
+    case GL_TRIANGLES: return (uint64_t)count / 3;
+    case GL_TRIANGLE_STRIP:
+    case GL_TRIANGLE_FAN: return count > 2 ? (uint64_t)count - 2 : 0;
+    default: return 0;
+    }
+}
+
+// The driver's entry points, called by the wrappers below.
+PFNGLDRAWELEMENTSPROC realDrawElements;
+PFNGLDRAWARRAYSPROC realDrawArrays;
+PFNGLDRAWELEMENTSINSTANCEDPROC realDrawElementsInstanced;
+PFNGLDRAWARRAYSINSTANCEDPROC realDrawArraysInstanced;
+PFNGLUSEPROGRAMPROC realUseProgram;
+PFNGLBINDVERTEXARRAYPROC realBindVertexArray;
+PFNGLBINDTEXTUREPROC realBindTexture;
+PFNGLBINDFRAMEBUFFERPROC realBindFramebuffer;
+PFNGLBUFFERDATAPROC realBufferData;
+PFNGLBUFFERSUBDATAPROC realBufferSubData;
+
+void APIENTRY countedDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    RenderStats::Counters& c = counters();
+    ++c.drawCalls;
+    ++c.instances;
+    c.triangles += trianglesFor(mode, count);
+    realDrawElements(mode, count, type, indices);
+}
+
+void APIENTRY countedDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    RenderStats::Counters& c = counters();
+    ++c.drawCalls;
+    ++c.instances;
+    c.triangles += trianglesFor(mode, count);
+    realDrawArrays(mode, first, count);
+}
+
+void APIENTRY countedDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances) {
+    RenderStats::Counters& c = counters();
+    ++c.drawCalls;
+    c.instances += instances;
+    c.triangles += trianglesFor(mode, count) * instances;
+    realDrawElementsInstanced(mode, count, type, indices, instances);
+}
+
+void APIENTRY countedDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) {
+    RenderStats::Counters& c = counters();
+    ++c.drawCalls;
+    c.instances += instances;
+    c.triangles += trianglesFor(mode, count) * instances;
+    realDrawArraysInstanced(mode, first, count, instances);
+}
+
+void APIENTRY countedUseProgram(GLuint program) {
+    ++counters().programBinds;
+    realUseProgram(program);
+}
+
+void APIENTRY countedBindVertexArray(GLuint vao) {
+    ++counters().vaoBinds;
+    realBindVertexArray(vao);
+}
+
+void APIENTRY countedBindTexture(GLenum target, GLuint texture) {
+    ++counters().textureBinds;
+    realBindTexture(target, texture);
+}
+
+void APIENTRY countedBindFramebuffer(GLenum target, GLuint framebuffer) {
+    ++counters().fboBinds;
+    realBindFramebuffer(target, framebuffer);
+}
+
+void APIENTRY countedBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    counters().bufferBytes += (uint64_t)size;
+    realBufferData(target, size, data, usage);
+}
+
+void APIENTRY countedBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    counters().bufferBytes += (uint64_t)size;
+    realBufferSubData(target, offset, size, data);
+}
+
+// Uniform setters all look alike: count, then forward.
+#define COUNTED_UNIFORM(Name, PFN, Params, Args) \
+    PFN real##Name; \
+    void APIENTRY counted##Name Params { ++counters().uniformUploads; real##Name Args; }
+
+COUNTED_UNIFORM(Uniform1i, PFNGLUNIFORM1IPROC, (GLint l, GLint v0), (l, v0))
+COUNTED_UNIFORM(Uniform1ui, PFNGLUNIFORM1UIPROC, (GLint l, GLuint v0), (l, v0))
+COUNTED_UNIFORM(Uniform1f, PFNGLUNIFORM1FPROC, (GLint l, GLfloat v0), (l, v0))
+COUNTED_UNIFORM(Uniform2f, PFNGLUNIFORM2FPROC, (GLint l, GLfloat v0, GLfloat v1), (l, v0, v1))
+COUNTED_UNIFORM(Uniform3f, PFNGLUNIFORM3FPROC, (GLint l, GLfloat v0, GLfloat v1, GLfloat v2), (l, v0, v1, v2))
+COUNTED_UNIFORM(Uniform4f, PFNGLUNIFORM4FPROC, (GLint l, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (l, v0, v1, v2, v3))
+COUNTED_UNIFORM(Uniform1iv, PFNGLUNIFORM1IVPROC, (GLint l, GLsizei n, const GLint* v), (l, n, v))
+COUNTED_UNIFORM(Uniform1fv, PFNGLUNIFORM1FVPROC, (GLint l, GLsizei n, const GLfloat* v), (l, n, v))
+COUNTED_UNIFORM(Uniform2fv, PFNGLUNIFORM2FVPROC, (GLint l, GLsizei n, const GLfloat* v), (l, n, v))
+COUNTED_UNIFORM(Uniform3fv, PFNGLUNIFORM3FVPROC, (GLint l, GLsizei n, const GLfloat* v), (l, n, v))
+COUNTED_UNIFORM(Uniform4fv, PFNGLUNIFORM4FVPROC, (GLint l, GLsizei n, const GLfloat* v), (l, n, v))
+COUNTED_UNIFORM(UniformMatrix3fv, PFNGLUNIFORMMATRIX3FVPROC, (GLint l, GLsizei n, GLboolean t, const GLfloat* v), (l, n, t, v))
+COUNTED_UNIFORM(UniformMatrix4fv, PFNGLUNIFORMMATRIX4FVPROC, (GLint l, GLsizei n, GLboolean t, const GLfloat* v), (l, n, t, v))
+
+#undef COUNTED_UNIFORM
+
+// Every wrapped entry point, as (glad pointer, saved driver pointer, wrapper).
+#define RENDER_STATS_HOOKS(X) \
+    X(DrawElements) X(DrawArrays) X(DrawElementsInstanced) X(DrawArraysInstanced) \
+    X(UseProgram) X(BindVertexArray) X(BindTexture) X(BindFramebuffer) \
+    X(BufferData) X(BufferSubData) \
+    X(Uniform1i) X(Uniform1ui) X(Uniform1f) X(Uniform2f) X(Uniform3f) X(Uniform4f) \
+    X(Uniform1iv) X(Uniform1fv) X(Uniform2fv) X(Uniform3fv) X(Uniform4fv) \
+    X(UniformMatrix3fv) X(UniformMatrix4fv)
+
+#endif // GENGINE_RENDER_STATS
+
+} // namespace
+
+void RenderStats::Counters::add(const Counters& o) {
+    drawCalls += o.drawCalls;
+    triangles += o.triangles;
+    instances += o.instances;
+    programBinds += o.programBinds;
+    vaoBinds += o.vaoBinds;
+    textureBinds += o.textureBinds;
+    fboBinds += o.fboBinds;
+    uniformUploads += o.uniformUploads;
+    bufferBytes += o.bufferBytes;
+    objectsDrawn += o.objectsDrawn;
+    objectsCulled += o.objectsCulled;
+}
+
+bool RenderStats::install() {
+#ifdef GENGINE_RENDER_STATS
+    if (s_installed) return true;
+    // entry points the context does not have stay untouched
+#define INSTALL_HOOK(Name) \
+    real##Name = glad_gl##Name; \
+    if (real##Name) glad_gl##Name = &counted##Name;
+    RENDER_STATS_HOOKS(INSTALL_HOOK)
+#undef INSTALL_HOOK
+    s_installed = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void RenderStats::uninstall() {
+#ifdef GENGINE_RENDER_STATS
+    if (!s_installed) return;
+#define UNINSTALL_HOOK(Name) \
+    if (real##Name) glad_gl##Name = real##Name;
+    RENDER_STATS_HOOKS(UNINSTALL_HOOK)
+#undef UNINSTALL_HOOK
+    s_installed = false;
+#endif
+}
+
+bool RenderStats::installed() {
+    return s_installed;
+}
+
+int RenderStats::beginPass(const char* name) {
+    if (s_passDepth >= MAX_PASS_DEPTH) return -1;
+    Frame& frame = s_frames[s_building];
+    int p = 1;
+    while (p < frame.passCount && strcmp(frame.passes[p].name, name) != 0) ++p;
+    if (p == frame.passCount) {
+        if (frame.passCount >= MAX_PASSES) return -1;
+        frame.passes[p].name = name;
+        ++frame.passCount;
+    }
+    s_passStack[s_passDepth++] = p;
+    return p;
+}
+
+void RenderStats::endPass(int pass) {
+    if (pass < 0 || s_passDepth == 0) return;
+    --s_passDepth;
+}
+
+void RenderStats::countObjects(uint32_t drawn, uint32_t culled) {
+    Counters& c = counters();
+    c.objectsDrawn += drawn;
+    c.objectsCulled += culled;
+}
+
+void RenderStats::endFrame() {
+    Frame& frame = s_frames[s_building];
+    for (int p = 0; p < frame.passCount; ++p) frame.total.add(frame.passes[p].counters);
+
+    s_building ^= 1;
+    ++s_frameIndex;
+    resetFrame(s_frames[s_building]);
+    s_passDepth = 0;
+}
+
+const RenderStats::Frame& RenderStats::lastFrame() {
+    return s_frames[s_building ^ 1];
+}
+
+void RenderStats::dump(FILE* out) {
+    const Frame& frame = lastFrame();
+    fprintf(out, "[RenderStats] frame %llu%s\n", (unsigned long long)frame.index,
+            s_installed ? "" : " (GL calls not counted in this build)");
+    fprintf(out, "  %-20s %6s %9s %6s %6s %6s %6s %6s %8s %10s %7s %7s\n", "pass", "draws", "tris", "inst",
+            "prog", "vao", "tex", "fbo", "uniform", "bufbytes", "drawn", "culled");
+    for (int p = 0; p <= frame.passCount; ++p) {
+        const bool total = p == frame.passCount;
+        const Counters& c = total ? frame.total : frame.passes[p].counters;
+        fprintf(out, "  %-20s %6u %9llu %6u %6u %6u %6u %6u %8u %10llu %7u %7u\n",
+                total ? "Total" : frame.passes[p].name, c.drawCalls, (unsigned long long)c.triangles,
+                c.instances, c.programBinds, c.vaoBinds, c.textureBinds, c.fboBinds, c.uniformUploads,
+                (unsigned long long)c.bufferBytes, c.objectsDrawn, c.objectsCulled);
+    }
+}
+
+void RenderStats::drawWindow(bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(760, 260), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Render Stats", open)) {
+        ImGui::End();
+        return;
+    }
+    if (!s_installed) ImGui::TextDisabled("GL calls are not counted in this build (GENGINE_RENDER_STATS).");
+
+    const Frame& frame = lastFrame();
+    static const char* const COLUMNS[] = { "Pass", "Draws", "Triangles", "Instances", "Programs", "VAOs",
+                                           "Textures", "FBOs", "Uniforms", "Buffer bytes", "Drawn", "Culled" };
+    const int columnCount = (int)(sizeof(COLUMNS) / sizeof(COLUMNS[0]));
+    if (ImGui::BeginTable("##renderstats", columnCount, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+                                                        ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_ScrollX)) {
+        for (int i = 0; i < columnCount; ++i) ImGui::TableSetupColumn(COLUMNS[i]);
+        ImGui::TableHeadersRow();
+        for (int p = 0; p <= frame.passCount; ++p) {
+            const bool total = p == frame.passCount;
+            const Counters& c = total ? frame.total : frame.passes[p].counters;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(total ? "Total" : frame.passes[p].name);
+            ImGui::TableNextColumn(); ImGui::Text("%u", c.drawCalls);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)c.triangles);
+            ImGui::TableNextColumn(); ImGui::Text("%u", c.instances);
+            ImGui::TableNextColumn(); ImGui::Text("%u", c.programBinds);
+            ImGui::TableNextColumn(); ImGui::Text("%u", c.vaoBinds);
+            ImGui::TableNextColumn(); ImGui::Text("%u", c.textureBinds);
+            ImGui::TableNextColumn(); ImGui::Text("%u", c.fboBinds);
+            ImGui::TableNextColumn(); ImGui::Text("%u", c.uniformUploads);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)c.bufferBytes);
+            ImGui::TableNextColumn(); ImGui::Text("%u", c.objectsDrawn);
+            ImGui::TableNextColumn(); ImGui::Text("%u", c.objectsCulled);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
@@ -1,4 +1,295 @@
 #include "Engine/util/shaderc.hpp"
+#include "Engine/util/frameArena.hpp"
+#include "filesystem/filesystem.hpp"
+#include "SDL2/SDL.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+// GL 4.1 / ARB_get_program_binary; the glad loader only covers 3.3, so these are looked up at runtime.
+const GLenum PROGRAM_BINARY_RETRIEVABLE_HINT = 0x8257;
+const GLenum PROGRAM_BINARY_LENGTH = 0x8741;
+const GLenum NUM_PROGRAM_BINARY_FORMATS = 0x87FE;
+typedef void (APIENTRYP GetProgramBinaryFn)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+typedef void (APIENTRYP ProgramBinaryFn)(GLuint, GLenum, const void*, GLsizei);
+typedef void (APIENTRYP ProgramParameteriFn)(GLuint, GLenum, GLint);
+// KHR/ARB_parallel_shader_compile
+const GLenum COMPLETION_STATUS = 0x91B1;
+typedef void (APIENTRYP MaxShaderCompilerThreadsFn)(GLuint);
+
+const uint32_t BINARY_MAGIC = 0x42505347;   // "GSPB"
+const uint32_t BINARY_VERSION = 1;
+
+enum ProgramStatus { LINKING, READY, FAILED };
+
+struct CachedProgram {
+    uint64_t key;
+    unsigned refs;      // submit/loadShader calls not yet matched by releaseProgram
+    ProgramStatus status;
+};
+
+// A program whose compile and link were issued but whose result has not been looked at yet.
+struct PendingLink {
+    GLuint program;
+    GLuint vertex, fragment;
+    std::string label;                          // paths and defines, for the log
+    std::vector<std::string> vFiles, fFiles;
+    std::chrono::steady_clock::time_point start;
+};
+
+struct CacheState {
+    std::unordered_map<uint64_t, GLuint> byKey;             // permutation key -> program
+    std::unordered_map<GLuint, CachedProgram> programs;
+    std::vector<PendingLink> pending;
+    bool parallelChecked = false;
+    bool parallel = false;                          // COMPLETION_STATUS can be queried
+    std::string directory = "shadercache";
+    std::string driver;                             // vendor|renderer|version, read once
+    bool binaryChecked = false;
+    GetProgramBinaryFn getProgramBinary = NULL;
+    ProgramBinaryFn programBinary = NULL;
+    ProgramParameteriFn programParameteri = NULL;
+    Shaderc::Stats stats = Shaderc::Stats();
+};
+
+CacheState& cache() {
+    static CacheState s;
+    return s;
+}
+
+uint64_t fnv1a(const std::string& s, uint64_t h = 14695981039346656037ull) {
+    for (size_t i = 0; i < s.size(); ++i) {
+        h ^= (unsigned char)s[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+const char* glString(GLenum name) {
+    const GLubyte* s = glGetString(name);
+    return s ? (const char*)s : "";
+}
+
+// True when the driver can hand out program binaries; loads the entry points on first call.
+bool binariesSupported() {
+    CacheState& c = cache();
+    if (!c.binaryChecked) {
+        c.binaryChecked = true;
+        c.driver = std::string(glString(GL_VENDOR)) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+        GLint formats = 0;
+        glGetIntegerv(NUM_PROGRAM_BINARY_FORMATS, &formats);
+        glGetError(); // GL_INVALID_ENUM on drivers without the extension
+        if (formats > 0) {
+            c.getProgramBinary = (GetProgramBinaryFn)SDL_GL_GetProcAddress("glGetProgramBinary");
+            c.programBinary = (ProgramBinaryFn)SDL_GL_GetProcAddress("glProgramBinary");
+            c.programParameteri = (ProgramParameteriFn)SDL_GL_GetProcAddress("glProgramParameteri");
+        }
+    }
+    return !c.directory.empty() && c.getProgramBinary && c.programBinary && c.programParameteri;
+}
+
+std::string binaryPath(uint64_t key) {
+    CacheState& c = cache();
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)fnv1a(c.driver, key));
+    return c.directory + "/" + name;
+}
+
+GLuint loadBinary(uint64_t key) {
+    if (!binariesSupported()) return 0;
+    std::ifstream f(binaryPath(key).c_str(), std::ios::in | std::ios::binary);
+    if (!f.is_open()) return 0;
+
+    uint32_t header[3] = { 0, 0, 0 };   // magic, version, format
+    f.read((char*)header, sizeof(header));
+    if (!f || header[0] != BINARY_MAGIC || header[1] != BINARY_VERSION) return 0;
+    std::vector<char> blob((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    if (blob.empty()) return 0;
+
+    GLuint program = glCreateProgram();
+    cache().programBinary(program, (GLenum)header[2], &blob[0], (GLsizei)blob.size());
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        // driver update or a different GPU behind the same strings; recompile and overwrite
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void storeBinary(uint64_t key, GLuint program) {
+    if (!binariesSupported()) return;
+    GLint length = 0;
+    glGetProgramiv(program, PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> blob((size_t)length);
+    GLenum format = 0;
+    cache().getProgramBinary(program, length, NULL, &format, &blob[0]);
+
+    fs::create_directories(cache().directory);
+    std::ofstream f(binaryPath(key).c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) return;
+    uint32_t header[3] = { BINARY_MAGIC, BINARY_VERSION, (uint32_t)format };
+    f.write((const char*)header, sizeof(header));
+    f.write(&blob[0], (std::streamsize)blob.size());
+}
+
+// Folds "dir/../" and "./" so a file reached through different relative paths is included once.
+std::string normalizePath(const std::string& path) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find_first_of("/\\", start);
+        if (end == std::string::npos) end = path.size();
+        std::string part = path.substr(start, end - start);
+        if (part == "..") {
+            if (!parts.empty() && parts.back() != "..") parts.pop_back();
+            else parts.push_back(part);
+        } else if (!part.empty() && part != ".") {
+            parts.push_back(part);
+        }
+        start = end + 1;
+    }
+    std::string out = (!path.empty() && path[0] == '/') ? "/" : "";
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (i) out += '/';
+        out += parts[i];
+    }
+    return out;
+}
+
+void printSources(const std::vector<std::string>& files) {
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::cerr << "  source " << i << ": " << files[i] << std::endl;
+    }
+}
+
+// Asks the driver for its own compiler threads. Without the extension, compiles still run when
+// the driver likes (often at link time) but finishing a link blocks.
+void enableParallelCompile() {
+    CacheState& c = cache();
+    if (c.parallelChecked) return;
+    c.parallelChecked = true;
+
+    MaxShaderCompilerThreadsFn maxThreads = NULL;
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count && !maxThreads; ++i) {
+        const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (!ext) continue;
+        if (strcmp(ext, "GL_KHR_parallel_shader_compile") == 0)
+            maxThreads = (MaxShaderCompilerThreadsFn)SDL_GL_GetProcAddress("glMaxShaderCompilerThreadsKHR");
+        else if (strcmp(ext, "GL_ARB_parallel_shader_compile") == 0)
+            maxThreads = (MaxShaderCompilerThreadsFn)SDL_GL_GetProcAddress("glMaxShaderCompilerThreadsARB");
+    }
+    if (maxThreads) {
+        maxThreads(0xFFFFFFFFu);    // as many as the implementation wants
+        c.parallel = true;
+    }
+}
+
+GLuint submitStage(GLenum type, const std::string& code) {
+    GLuint shader = glCreateShader(type);
+    if (shader == 0) return 0;
+    const char* src = code.c_str();
+    glShaderSource(shader, 1, &src, 0);
+    glCompileShader(shader);
+    return shader;
+}
+
+void printStageLog(GLuint shader, const char* stage, const std::vector<std::string>& files) {
+    GLint success = GL_TRUE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (success) return;
+    GLchar infoLog[1024];
+    glGetShaderInfoLog(shader, 1024, 0, infoLog);
+    std::cerr << "ERROR::SHADER::" << stage << "::COMPILATION_FAILED\n" << infoLog << std::endl;
+    printSources(files);
+}
+
+// Non-blocking with parallel compile; otherwise reports done and lets finishLink wait.
+bool linkDone(const PendingLink& p) {
+    if (!cache().parallel) return true;
+    GLint done = GL_FALSE;
+    glGetProgramiv(p.program, COMPLETION_STATUS, &done);
+    return done == GL_TRUE;
+}
+
+// Reads the link result (blocking if it is not in yet), logs it and frees the shader objects.
+void finishLink(PendingLink& p) {
+    FrameAllocator::expectAllocations();    // may land mid-frame, through ready()
+    CacheState& c = cache();
+    CachedProgram& entry = c.programs[p.program];
+
+    GLint success = GL_FALSE;
+    glGetProgramiv(p.program, GL_LINK_STATUS, &success);
+    if (success) {
+        entry.status = READY;
+        storeBinary(entry.key, p.program);
+        ++c.stats.compiled;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - p.start).count();
+        std::cerr << "[Shaderc] compiled " << p.label << " in " << ms << " ms (id=" << p.program << ")" << std::endl;
+    } else {
+        printStageLog(p.vertex, "VERTEX", p.vFiles);
+        printStageLog(p.fragment, "FRAGMENT", p.fFiles);
+        GLchar infoLog[1024];
+        glGetProgramInfoLog(p.program, 1024, 0, infoLog);
+        std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED (" << p.label << ")\n" << infoLog << std::endl;
+        entry.status = FAILED;
+        c.byKey.erase(entry.key);   // a later submit of the same source tries again
+    }
+    glDetachShader(p.program, p.vertex);
+    glDetachShader(p.program, p.fragment);
+    glDeleteShader(p.vertex);
+    glDeleteShader(p.fragment);
+}
+
+// Finishes 'program' if it is pending and (when 'wait' is false) its link is done.
+void settle(GLuint program, bool wait) {
+    std::vector<PendingLink>& pending = cache().pending;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        if (pending[i].program != program) continue;
+        if (!wait && !linkDone(pending[i])) return;
+        finishLink(pending[i]);
+        pending.erase(pending.begin() + i);
+        return;
+    }
+}
+
+} // namespace
+
+ShaderDefines& ShaderDefines::set(const std::string& name, const std::string& value) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i].first == name) { values[i].second = value; return *this; }
+    }
+    values.push_back(std::make_pair(name, value));
+    return *this;
+}
+
+ShaderDefines& ShaderDefines::set(const std::string& name, int value) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", value);
+    return set(name, std::string(buf));
+}
+
+std::string ShaderDefines::key() const {
+    std::vector<std::pair<std::string, std::string> > sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+    std::string k;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (i) k += ';';
+        k += sorted[i].first + "=" + sorted[i].second;
+    }
+    return k;
+}
 
 std::string Shaderc::loadShaderSource(const char* filepath) {
     std::ifstream file(filepath);
@@ -12,18 +303,102 @@ std::string Shaderc::loadShaderSource(const char* filepath) {
     return buffer.str();
 }
 
-GLuint Shaderc::loadShader(const char* vertexPath, const char* fragmentPath) {
-    std::string vCode = loadShaderSource(vertexPath);
-    std::string fCode = loadShaderSource(fragmentPath);
+// Appends 'path' with its includes expanded. #line directives carry the index of each file in
+// 'included' as the source string number, so compile errors can be traced back to the file.
+//
+// Before GLSL 4.30, "#line N" numbers the line after the directive N + 1 rather than N. The
+// top-level file's #version sets 'lineShift' to 1 for those versions (and for no #version,
+// i.e. 1.10) and to 0 otherwise; every #line is emitted that much lower.
+bool Shaderc::expand(const std::string& path, std::vector<std::string>& included, std::string& out, int& lineShift) {
+    if (std::find(included.begin(), included.end(), path) != included.end()) return true;
+    std::ifstream file(path.c_str());
+    if (!file.is_open()) {
+        std::cerr << "ERROR::SHADER::FILE_NOT_FOUND: " << path << std::endl;
+        return false;
+    }
+    included.push_back(path);
+    const size_t index = included.size() - 1;
+    const size_t slash = path.find_last_of("/\\");
+    const std::string dir = (slash == std::string::npos) ? "" : path.substr(0, slash + 1);
 
-    std::cerr << "[Shaderc] loadShader start: vlen=" << vCode.size() << " flen=" << fCode.size() << std::endl;
+    std::string line;
+    int lineNo = 0;
+    char buf[48];
+    while (std::getline(file, line)) {
+        ++lineNo;
+        size_t p = line.find_first_not_of(" \t");
+        if (index == 0 && p != std::string::npos && line.compare(p, 8, "#version") == 0) {
+            lineShift = atoi(line.c_str() + p + 8) < 430 ? 1 : 0;
+        }
+        if (p != std::string::npos && line.compare(p, 8, "#include") == 0) {
+            size_t open = line.find('"', p + 8);
+            size_t close = (open == std::string::npos) ? open : line.find('"', open + 1);
+            if (close == std::string::npos) {
+                std::cerr << "[Shaderc] " << path << ":" << lineNo << ": malformed #include" << std::endl;
+                return false;
+            }
+            snprintf(buf, sizeof(buf), "#line %d %u\n", 1 - lineShift, (unsigned)included.size());
+            out += buf;
+            if (!expand(normalizePath(dir + line.substr(open + 1, close - open - 1)), included, out, lineShift)) return false;
+            snprintf(buf, sizeof(buf), "#line %d %u\n", lineNo + 1 - lineShift, (unsigned)index);
+            out += buf;
+            continue;
+        }
+        out += line;
+        out += '\n';
+    }
+    return true;
+}
 
-    const GLubyte* glver = glGetString(GL_VERSION);
-    const GLubyte* glslver = glGetString(GL_SHADING_LANGUAGE_VERSION);
-    std::cerr << "GL Version: " << (glver ? (const char*)glver : "(null)")
-              << " | GLSL Version: " << (glslver ? (const char*)glslver : "(null)") << std::endl;
+bool Shaderc::preprocess(const char* path, const ShaderDefines& defines, std::string& out, std::vector<std::string>& files) {
+    std::string body;
+    int lineShift = 1;
+    if (!expand(normalizePath(path), files, body, lineShift)) return false;
 
+    std::string defs;
+    for (size_t i = 0; i < defines.values.size(); ++i) {
+        defs += "#define " + defines.values[i].first + " " + defines.values[i].second + "\n";
+    }
 
+    // defines go right after #version, which must stay the first directive
+    out.clear();
+    size_t v = body.find("#version");
+    if (v != std::string::npos && body.find_first_not_of(" \t\r\n") == v) {
+        size_t eol = body.find('\n', v);
+        if (eol == std::string::npos) eol = body.size() - 1;
+        out = body.substr(0, eol + 1) + defs + (lineShift ? "#line 1 0\n" : "#line 2 0\n") + body.substr(eol + 1);
+    } else {
+        out = defs + "#line 0 0\n" + body;
+    }
+    return true;
+}
+
+bool Shaderc::preprocess(const char* path, const ShaderDefines& defines, std::string& out) {
+    std::vector<std::string> files;
+    return preprocess(path, defines, out, files);
+}
+
+GLuint Shaderc::loadShader(const char* vertexPath, const char* fragmentPath) {
+    return loadShader(vertexPath, fragmentPath, ShaderDefines());
+}
+
+GLuint Shaderc::loadShader(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines) {
+    GLuint program = submit(vertexPath, fragmentPath, defines);
+    if (program == 0) return 0;
+    settle(program, true);
+    if (failed(program)) {
+        releaseProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+GLuint Shaderc::submit(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines) {
+    std::vector<std::string> vFiles, fFiles;
+    std::string vCode, fCode;
+    if (!preprocess(vertexPath, defines, vCode, vFiles) || !preprocess(fragmentPath, defines, fCode, fFiles)) {
+        return 0;
+    }
     if (vCode.empty()) {
         std::cerr << "ERROR::SHADER::VERTEX::SOURCE_EMPTY: " << vertexPath << std::endl;
         return 0;
@@ -32,75 +407,123 @@ GLuint Shaderc::loadShader(const char* vertexPath, const char* fragmentPath) {
         std::cerr << "ERROR::SHADER::FRAGMENT::SOURCE_EMPTY: " << fragmentPath << std::endl;
         return 0;
     }
-    const char* vShaderCode = vCode.c_str();
-    const char* fShaderCode = fCode.c_str();
-
-    // Compile vertex shader
-    std::cerr << "[Shaderc] compiling vertex shader" << std::endl;
-    GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
-    if (vertex == 0) { std::cerr << "[Shaderc] glCreateShader returned 0 for vertex\n"; return 0; }
-    glShaderSource(vertex, 1, &vShaderCode, 0);
-    glCompileShader(vertex);
 
-    GLint success;
-    GLchar infoLog[1024];
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertex, 1024, 0, infoLog);
-        std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-        std::cerr << "--- Vertex shader source (" << vertexPath << ") ---\n" << vCode << std::endl;
-        GLenum err = glGetError();
-        std::cerr << "glGetError after vertex compile: " << err << std::endl;
-    }
-    else {
-        std::cerr << "[Shaderc] vertex compiled successfully (id=" << vertex << ")" << std::endl;
+    // The expanded text already contains the defines, so it alone identifies the permutation.
+    CacheState& c = cache();
+    const uint64_t key = fnv1a(fCode, fnv1a(std::string(1, '\0'), fnv1a(vCode)));
+    std::unordered_map<uint64_t, GLuint>::const_iterator hit = c.byKey.find(key);
+    if (hit != c.byKey.end()) {
+        ++c.programs[hit->second].refs;
+        ++c.stats.memoryHits;
+        return hit->second;
     }
 
-    // Compile fragment shader
-    std::cerr << "[Shaderc] compiling fragment shader" << std::endl;
-    GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    if (fragment == 0) { std::cerr << "[Shaderc] glCreateShader returned 0 for fragment\n"; return 0; }
-    glShaderSource(fragment, 1, &fShaderCode, 0);
-    glCompileShader(fragment);
-
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragment, 1024, 0, infoLog);
-        std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-        std::cerr << "--- Fragment shader source (" << fragmentPath << ") ---\n" << fCode << std::endl;
-        GLenum err = glGetError();
-        std::cerr << "glGetError after fragment compile: " << err << std::endl;
+    GLuint program = loadBinary(key);
+    if (program != 0) {
+        CachedProgram entry = { key, 1, READY };
+        c.programs[program] = entry;
+        c.byKey[key] = program;
+        ++c.stats.diskHits;
+        return program;
     }
-    else {
-        std::cerr << "[Shaderc] fragment compiled successfully (id=" << fragment << ")" << std::endl;
+
+    enableParallelCompile();
+    PendingLink p;
+    p.start = std::chrono::steady_clock::now();
+    p.vertex = submitStage(GL_VERTEX_SHADER, vCode);
+    p.fragment = submitStage(GL_FRAGMENT_SHADER, fCode);
+    if (p.vertex == 0 || p.fragment == 0) {
+        std::cerr << "[Shaderc] glCreateShader failed for " << vertexPath << " + " << fragmentPath << std::endl;
+        if (p.vertex) glDeleteShader(p.vertex);
+        if (p.fragment) glDeleteShader(p.fragment);
+        return 0;
     }
 
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertex);
-    glAttachShader(program, fragment);
+    program = glCreateProgram();
+    glAttachShader(program, p.vertex);
+    glAttachShader(program, p.fragment);
 
 	glBindAttribLocation(program, 0, "aPos");
 	glBindAttribLocation(program, 1, "aColor");
 	glBindAttribLocation(program, 2, "aNormal");
 	glBindAttribLocation(program, 3, "aTexCoord");
 
-    std::cerr << "[Shaderc] linking program (id=" << program << ")" << std::endl;
+    if (binariesSupported()) c.programParameteri(program, PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    // No status queries here: those would wait for the compiler. poll()/ready() pick the result up.
     glLinkProgram(program);
 
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(program, 1024, 0, infoLog);
-        std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-        GLenum err = glGetError();
-        std::cerr << "glGetError after program link: " << err << std::endl;
-        glDeleteProgram(program);
-        return 0;
+    std::string variant = defines.key();
+    p.program = program;
+    p.label = std::string(vertexPath) + " + " + fragmentPath + (variant.empty() ? "" : " [" + variant + "]");
+    p.vFiles.swap(vFiles);
+    p.fFiles.swap(fFiles);
+    c.pending.push_back(p);
+
+    CachedProgram entry = { key, 1, LINKING };
+    c.programs[program] = entry;
+    c.byKey[key] = program;
+    return program;
+}
+
+void Shaderc::poll() {
+    std::vector<PendingLink>& pending = cache().pending;
+    for (size_t i = 0; i < pending.size();) {
+        if (linkDone(pending[i])) {
+            finishLink(pending[i]);
+            pending.erase(pending.begin() + i);
+        } else {
+            ++i;
+        }
     }
-    std::cerr << "[Shaderc] program linked successfully (id=" << program << ")" << std::endl;
+}
 
-    // Cleanup
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+bool Shaderc::ready(GLuint program) {
+    CacheState& c = cache();
+    std::unordered_map<GLuint, CachedProgram>::iterator it = c.programs.find(program);
+    if (it == c.programs.end()) return false;
+    if (it->second.status == LINKING) settle(program, false);
+    return it->second.status == READY;
+}
 
-    return program;
-}
\ No newline at end of file
+bool Shaderc::failed(GLuint program) {
+    CacheState& c = cache();
+    std::unordered_map<GLuint, CachedProgram>::const_iterator it = c.programs.find(program);
+    return it == c.programs.end() || it->second.status == FAILED;
+}
+
+void Shaderc::finish(GLuint program) {
+    settle(program, true);
+}
+
+size_t Shaderc::pendingCount() {
+    return cache().pending.size();
+}
+
+void Shaderc::releaseProgram(GLuint program) {
+    if (program == 0) return;
+    CacheState& c = cache();
+    std::unordered_map<GLuint, CachedProgram>::iterator it = c.programs.find(program);
+    if (it != c.programs.end()) {
+        if (--it->second.refs > 0) return;
+        std::vector<PendingLink>& pending = c.pending;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if (pending[i].program != program) continue;
+            glDeleteShader(pending[i].vertex);
+            glDeleteShader(pending[i].fragment);
+            pending.erase(pending.begin() + i);
+            break;
+        }
+        std::unordered_map<uint64_t, GLuint>::iterator k = c.byKey.find(it->second.key);
+        if (k != c.byKey.end() && k->second == program) c.byKey.erase(k);
+        c.programs.erase(it);
+    }
+    glDeleteProgram(program);
+}
+
+void Shaderc::setCacheDirectory(const std::string& dir) {
+    cache().directory = dir;
+}
+
+const Shaderc::Stats& Shaderc::stats() {
+    return cache().stats;
+}
@@ -0,0 +1,38 @@
+#include "Engine/util/stringTable.hpp"
+
+StringTable::StringTable() {
+    strings.push_back(std::string());
+    ids[strings.back()] = NONE;
+}
+
+StringTable& StringTable::global() {
+    static StringTable table;
+    return table;
+}
+
+StringId StringTable::intern(const std::string& s) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, StringId>::const_iterator it = ids.find(s);
+    if (it != ids.end()) return it->second;
+
+    StringId id = (StringId)strings.size();
+    strings.push_back(s);
+    ids[s] = id;
+    return id;
+}
+
+StringId StringTable::find(const std::string& s) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<std::string, StringId>::const_iterator it = ids.find(s);
+    return it != ids.end() ? it->second : NOT_FOUND;
+}
+
+const std::string& StringTable::str(StringId id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return id < strings.size() ? strings[id] : strings[NONE];
+}
+
+size_t StringTable::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return strings.size();
+}
@@ -0,0 +1,71 @@
+#include "Engine/util/threadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : jobHead(0), jobCount(0), pending(0), stopping(false)
+{
+    if (threadCount == 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        threadCount = (hw > 1) ? hw - 1 : 1;
+    }
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (size_t i = 0; i < workers.size(); ++i) workers[i].join();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::submit(const std::function<void()>& job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobCount == jobs.size()) {
+            // full: unroll into a bigger ring, oldest job first
+            std::vector<std::function<void()>> grown(jobs.empty() ? 64 : jobs.size() * 2);
+            for (size_t i = 0; i < jobCount; ++i) grown[i].swap(jobs[(jobHead + i) % jobs.size()]);
+            jobs.swap(grown);
+            jobHead = 0;
+        }
+        jobs[(jobHead + jobCount) % jobs.size()] = job;
+        ++jobCount;
+        ++pending;
+    }
+    jobAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (pending != 0) jobsDone.wait(lock);
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!stopping && jobCount == 0) jobAvailable.wait(lock);
+            if (stopping && jobCount == 0) return;
+            job.swap(jobs[jobHead]);
+            jobHead = (jobHead + 1) % jobs.size();
+            --jobCount;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --pending;
+            if (pending == 0) jobsDone.notify_all();
+        }
+    }
+}
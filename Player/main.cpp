@@ -9,6 +9,8 @@
 
 #include "GameMain.hpp"
 #include "Engine/util/shaderc.hpp"
+#include "Engine/util/frameArena.hpp"
+#include "Engine/util/profiler.hpp"
 #include "math/math.hpp"
 #include "filesystem/filesystem.hpp"
 
@@ -17,11 +19,18 @@ using namespace NMATH;
 int main(int argc, char* argv[])
 {
     std::string scenePath;
+    std::string tracePath;
+    bool dumpRenderStats = false;
     for (int i = 1; i < argc; ++i) {
         std::string a = argv[i];
         const std::string key = "--scene=";
+        const std::string traceKey = "--trace=";
         if (a == "--scene" && i + 1 < argc) { scenePath = argv[++i]; continue; }
         if (a.compare(0, key.size(), key) == 0) { scenePath = a.substr(key.size()); continue; }
+        if (a == "--trace" && i + 1 < argc) { tracePath = argv[++i]; continue; }
+        if (a.compare(0, traceKey.size(), traceKey) == 0) { tracePath = a.substr(traceKey.size()); continue; }
+        // --render-stats: print the per-pass render counts once a second (F2 prints them once)
+        if (a == "--render-stats") { dumpRenderStats = true; continue; }
     }
 
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
@@ -59,12 +68,15 @@ int main(int argc, char* argv[])
         return -1;
     }
 
+    RenderStats::install();
+
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
 
+    // Compiles while the scene loads below; the loading screen needs no shader.
     Shaderc shaderCompiler;
-    GLuint program = shaderCompiler.loadShader("shaders/vertex.glsl", "shaders/fragment.glsl");
+    GLuint program = shaderCompiler.submit("shaders/vertex.glsl", "shaders/fragment.glsl");
     if (program == 0) {
         std::cerr << "Failed to load shader program" << std::endl;
         SDL_GL_DeleteContext(glContext);
@@ -73,20 +85,49 @@ int main(int argc, char* argv[])
         return -1;
     }
 
+    // Loading screen: a progress bar drawn with scissored clears, so no shader is needed.
+    // Events are pumped each update so the window stays responsive during big loads.
+    SceneLoadProgress showLoadProgress = [window](const char* stage, float progress) {
+        SDL_PumpEvents();
+
+        int w, h;
+        SDL_GetWindowSize(window, &w, &h);
+        int barW = w / 2, barH = 12;
+        int barX = (w - barW) / 2, barY = h / 2 - barH / 2;
+
+        glViewport(0, 0, w, h);
+        glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(barX - 2, barY - 2, barW + 4, barH + 4);
+        glClearColor(0.25f, 0.25f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glScissor(barX, barY, (int)(barW * progress), barH);
+        glClearColor(0.9f, 0.6f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glDisable(GL_SCISSOR_TEST);
+
+        std::string title = std::string("GENGINE_PLAYER - ") + stage + " " + std::to_string((int)(progress * 100.0f)) + "%";
+        SDL_SetWindowTitle(window, title.c_str());
+        SDL_GL_SwapWindow(window);
+    };
+
     // Create and initialize the game
     GameMain game;
     if (!scenePath.empty()) {
         // Try absolute/relative locations; use fs helper to check existence
         if (fs::exists(scenePath)) {
-            game.scene->loadScene(scenePath);
+            game.scene->loadScene(scenePath, showLoadProgress);
         } else {
             char* base = SDL_GetBasePath();
             if (base) {
                 std::string candidate = std::string(base) + scenePath;
-                if (fs::exists(candidate)) game.scene->loadScene(candidate);
+                if (fs::exists(candidate)) game.scene->loadScene(candidate, showLoadProgress);
                 SDL_free(base);
             }
         }
+        SDL_SetWindowTitle(window, "GENGINE_PLAYER");
     }
     game.Start();
 
@@ -96,25 +137,40 @@ int main(int argc, char* argv[])
     Uint64 LAST = NOW;
     float deltaTime = 0.016f;
 
+    if (!tracePath.empty()) Profiler::startTrace(tracePath);
+
     while (running) {
+        Profiler::beginFrame();
         LAST = NOW;
         NOW = SDL_GetTicks();
         deltaTime = (NOW - LAST) / 1000.0f;
 
+        Shaderc::poll();
+        if (Shaderc::failed(program)) {
+            std::cerr << "Failed to load shader program" << std::endl;
+            break;
+        }
+
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) running = false;
             if (event.type == SDL_KEYDOWN) {
                 if (event.key.keysym.sym == SDLK_ESCAPE) running = false;
+                if (event.key.keysym.sym == SDLK_F2) RenderStats::dump(stderr);
             }
         }
 
         // Update game logic
-        game.Update(deltaTime);
+        {
+            PROFILE_SCOPE("Game update");
+            FrameAllocationScope countAllocations;
+            game.Update(deltaTime);
+        }
 
         // Simple camera (follow player if present)
         Mat4 view;
-        if (game.player && game.player->playerObject) {
-            Vec3d target = game.player->playerObject->position;
+        Object* followed = game.player ? game.player->getObject() : nullptr;
+        if (followed) {
+            Vec3d target = followed->position;
             Vec3d camPos = target + Vec3d(0.0f, 2.0f, 6.0f);
             view = lookAt(camPos, target, Vec3d(0.0f, 1.0f, 0.0f));
         } else {
@@ -130,14 +186,25 @@ int main(int argc, char* argv[])
         glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glUseProgram(program);
-        glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, view.value_ptr());
-        glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, projection.value_ptr());
+        if (Shaderc::ready(program)) {
+            glUseProgram(program);
+            glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, view.value_ptr());
+            glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, projection.value_ptr());
 
-        game.scene->render(program, view, projection);
+            FrameAllocationScope countAllocations;
+            game.scene->render(program, view, projection);
+        }
 
-        SDL_GL_SwapWindow(window);
+        {
+            PROFILE_SCOPE("Swap");
+            SDL_GL_SwapWindow(window);
+        }
+        FrameAllocator::endFrame();
+        Profiler::endFrame();
+        RenderStats::endFrame();
+        if (dumpRenderStats && NOW / 1000 != LAST / 1000) RenderStats::dump(stderr);
     }
+    Profiler::stopTrace();
 
     SDL_GL_DeleteContext(glContext);
     SDL_DestroyWindow(window);
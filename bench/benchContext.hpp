@@ -0,0 +1,46 @@
+#ifndef BENCHCONTEXT_HPP
+#define BENCHCONTEXT_HPP
+
+// GL 3.3 core context on a hidden window for the benchmarks. With 'offscreen' SDL's EGL
+// offscreen driver is used instead, which needs no display (Mesa llvmpipe on build machines).
+
+#include <cstdio>
+
+#include "SDL2/SDL.h"
+
+inline bool createBenchContext(const char* title, bool offscreen, int width, int height,
+                               SDL_Window*& window, SDL_GLContext& context) {
+    if (offscreen) SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        fprintf(stderr, "[Bench] SDL init failed: %s\n", SDL_GetError());
+        return false;
+    }
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
+    SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+
+    window = SDL_CreateWindow(title, 0, 0, width, height, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    context = window ? SDL_GL_CreateContext(window) : NULL;
+    if (!context) {
+        fprintf(stderr, "[Bench] No GL 3.3 context on the '%s' video driver: %s\n",
+                SDL_GetCurrentVideoDriver() ? SDL_GetCurrentVideoDriver() : "none", SDL_GetError());
+        if (window) SDL_DestroyWindow(window);
+        window = NULL;
+        SDL_Quit();
+        return false;
+    }
+    SDL_GL_MakeCurrent(window, context);
+    SDL_GL_SetSwapInterval(0);
+    return true;
+}
+
+// Tries a hidden window first and falls back to the offscreen driver.
+inline bool createBenchContextAnyDriver(const char* title, bool offscreen, int width, int height,
+                                        SDL_Window*& window, SDL_GLContext& context) {
+    if (createBenchContext(title, offscreen, width, height, window, context)) return true;
+    return !offscreen && createBenchContext(title, true, width, height, window, context);
+}
+
+#endif
@@ -0,0 +1,181 @@
+// Batch math benchmark: SimdMath kernels vs the NMATH scalar code they replace.
+//
+// Runs each per-frame loop (compose TRS, matrix * viewProj, sphere culling, ray vs triangles)
+// over N elements both ways, prints the median time of each and checks the results agree.
+//
+// usage: GENGINE_MATH_BENCH [--count N] [--reps N]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "Engine/math/quat.hpp"
+#include "Engine/math/simdMath.hpp"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static float randf(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    return v.empty() ? 0.0 : v[v.size() / 2];
+}
+
+template <typename Fn>
+static double timeMs(Fn fn, int reps) {
+    std::vector<double> samples;
+    for (int r = 0; r < reps; ++r) {
+        Clock::time_point t0 = Clock::now();
+        fn();
+        samples.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+    return median(samples);
+}
+
+static float maxDiff(const float* a, const float* b, size_t n) {
+    float d = 0.0f;
+    for (size_t i = 0; i < n; ++i) d = std::max(d, std::fabs(a[i] - b[i]));
+    return d;
+}
+
+static bool report(const char* name, double scalarMs, double simdMs, bool agree) {
+    printf("%-12s %12.3f %12.3f %9.1fx %8s\n", name, scalarMs, simdMs,
+           simdMs > 0.0 ? scalarMs / simdMs : 0.0, agree ? "yes" : "NO");
+    return agree;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = 100000;
+    int reps = 9;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--count" && i + 1 < argc) { count = std::max<size_t>(1, (size_t)atol(argv[++i])); continue; }
+        if (a == "--reps" && i + 1 < argc) { reps = std::max(1, atoi(argv[++i])); continue; }
+    }
+    srand(12345);
+    bool ok = true;
+
+    // --- inputs: one transform, bounding sphere and triangle per element
+    std::vector<Vec3d> positions(count), rotations(count), scales(count);
+    std::vector<float> pos(count * 3), quats(count * 4), scl(count * 3);
+    std::vector<float> cx(count), cy(count), cz(count), radii(count);
+    std::vector<Vec3d> triVerts(count * 3);
+    std::vector<unsigned int> triIndices(count * 3);
+    for (size_t i = 0; i < count; ++i) {
+        positions[i] = Vec3d(randf(-100, 100), randf(-100, 100), randf(-100, 100));
+        rotations[i] = Vec3d(randf(0, 360), randf(0, 360), randf(0, 360));
+        scales[i] = Vec3d(randf(0.5f, 2), randf(0.5f, 2), randf(0.5f, 2));
+        Quat q = Quat::fromEulerDegrees(rotations[i]);
+        pos[i * 3 + 0] = positions[i].x; pos[i * 3 + 1] = positions[i].y; pos[i * 3 + 2] = positions[i].z;
+        scl[i * 3 + 0] = scales[i].x;    scl[i * 3 + 1] = scales[i].y;    scl[i * 3 + 2] = scales[i].z;
+        quats[i * 4 + 0] = q.x; quats[i * 4 + 1] = q.y; quats[i * 4 + 2] = q.z; quats[i * 4 + 3] = q.w;
+
+        cx[i] = positions[i].x; cy[i] = positions[i].y; cz[i] = positions[i].z;
+        radii[i] = randf(0.5f, 5);
+
+        // small triangles scattered in front of the ray origin
+        Vec3d c(randf(-5, 5), randf(-5, 5), randf(5, 200));
+        for (int k = 0; k < 3; ++k) {
+            triVerts[i * 3 + k] = c + Vec3d(randf(-1, 1), randf(-1, 1), randf(-0.2f, 0.2f));
+            triIndices[i * 3 + k] = (unsigned int)(i * 3 + k);
+        }
+    }
+
+    Mat4 projection = perspective(radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    Mat4 view = lookAt(Vec3d(0, 20, 80), Vec3d(0, 0, 0), Vec3d(0, 1, 0));
+    Mat4 viewProj = projection * view;
+
+    printf("count=%zu reps=%d backend=%s\n", count, reps, SimdMath::backend());
+    printf("%-12s %12s %12s %10s %8s\n", "kernel", "nmath_ms", "simd_ms", "speedup", "agree");
+
+    // --- compose TRS: translate * rotate(x) * rotate(y) * rotate(z) * scale per object
+    std::vector<Mat4> scalarModels(count);
+    std::vector<float> simdModels(count * 16);
+    double scalarMs = timeMs([&]() {
+        for (size_t i = 0; i < count; ++i) {
+            Mat4 model(1.0f);
+            model = translate(model, positions[i]);
+            model = rotate(model, radians(rotations[i].x), Vec3d(1, 0, 0));
+            model = rotate(model, radians(rotations[i].y), Vec3d(0, 1, 0));
+            model = rotate(model, radians(rotations[i].z), Vec3d(0, 0, 1));
+            scalarModels[i] = NMATH::scale(model, scales[i]);
+        }
+    }, reps);
+    double simdMs = timeMs([&]() {
+        SimdMath::composeTRS(&pos[0], &quats[0], &scl[0], &simdModels[0], count);
+    }, reps);
+    float diff = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+        diff = std::max(diff, maxDiff(scalarModels[i].value_ptr(), &simdModels[i * 16], 16));
+    ok = report("composeTRS", scalarMs, simdMs, diff < 1e-3f) && ok;
+
+    // --- viewProj * model, scalar side reuses the SIMD-composed models so only the multiply is timed
+    std::vector<Mat4> scalarMvp(count);
+    std::vector<float> simdMvp(count * 16);
+    for (size_t i = 0; i < count; ++i) std::copy(&simdModels[i * 16], &simdModels[i * 16] + 16, &scalarModels[i].m[0][0]);
+    scalarMs = timeMs([&]() {
+        for (size_t i = 0; i < count; ++i) scalarMvp[i] = viewProj * scalarModels[i];
+    }, reps);
+    simdMs = timeMs([&]() {
+        SimdMath::multiplyMatrices(viewProj.value_ptr(), &simdModels[0], &simdMvp[0], count);
+    }, reps);
+    diff = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+        diff = std::max(diff, maxDiff(scalarMvp[i].value_ptr(), &simdMvp[i * 16], 16));
+    ok = report("multiply", scalarMs, simdMs, diff < 1e-2f) && ok;
+
+    // --- bounding spheres vs the six frustum planes
+    float planes[24];
+    SimdMath::extractFrustumPlanes(viewProj.value_ptr(), planes);
+    Vec3d normals[6];
+    for (int p = 0; p < 6; ++p) normals[p] = Vec3d(planes[p * 4 + 0], planes[p * 4 + 1], planes[p * 4 + 2]);
+    std::vector<uint8_t> scalarVisible(count), simdVisible(count);
+    scalarMs = timeMs([&]() {
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t inside = 1;
+            for (int p = 0; p < 6 && inside; ++p)
+                if (normals[p].dot(positions[i]) + planes[p * 4 + 3] < -radii[i]) inside = 0;
+            scalarVisible[i] = inside;
+        }
+    }, reps);
+    simdMs = timeMs([&]() {
+        SimdMath::cullSpheres(planes, &cx[0], &cy[0], &cz[0], &radii[0], &simdVisible[0], count);
+    }, reps);
+    size_t visible = 0, mismatched = 0;
+    for (size_t i = 0; i < count; ++i) {
+        visible += simdVisible[i];
+        if (scalarVisible[i] != simdVisible[i]) ++mismatched;
+    }
+    // spheres touching a plane can flip either way on rounding
+    ok = report("cullSpheres", scalarMs, simdMs, mismatched <= count / 10000) && ok;
+
+    // --- one ray against every triangle, closest hit
+    Vec3d origin(0.0f, 0.0f, 0.0f), dir(0.0f, 0.0f, 1.0f);
+    long scalarHit = -1, simdHit = -1;
+    float scalarT = 0.0f, simdT = 0.0f;
+    scalarMs = timeMs([&]() {
+        scalarHit = -1;
+        scalarT = 1e30f;
+        for (size_t i = 0; i < count; ++i) {
+            float t;
+            if (IntersectRayTriangle(origin, dir, triVerts[i * 3], triVerts[i * 3 + 1], triVerts[i * 3 + 2], t) && t < scalarT) {
+                scalarT = t;
+                scalarHit = (long)i;
+            }
+        }
+    }, reps);
+    simdMs = timeMs([&]() {
+        simdHit = SimdMath::intersectRayTriangles(&origin.x, &dir.x, &triVerts[0], sizeof(Vec3d),
+                                                  &triIndices[0], count, simdT);
+    }, reps);
+    ok = report("rayTriangles", scalarMs, simdMs, scalarHit == simdHit) && ok;
+
+    printf("visible spheres: %zu/%zu, ray hit: %ld (t=%.3f)\n", visible, count, simdHit, simdT);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,305 @@
+// Microbenchmarks of engine hot spots, see microbench.hpp for the harness.
+//
+// Cases: ShapeGenerator sphere/cylinder generation over tessellation levels, Object model
+// matrices (cached, recomputed, through a parent chain), NMATH Mat4::inverse,
+// SceneManager::pickObject over scenes of growing size and saveScene/loadScene of a large
+// generated scene in both scene formats. The SceneManager cases need a GL context (meshes are
+// uploaded); without one they are skipped and the rest still run. Run it from the build
+// directory, next to the copied shaders and textures.
+//
+// Keep a run as a baseline and compare an optimization against it:
+//
+//   GENGINE_MICROBENCH --out before.txt
+//   ... change ...
+//   GENGINE_MICROBENCH --baseline before.txt --out after.txt
+//
+// usage: GENGINE_MICROBENCH [--filter substring] [--samples N] [--min-sample-ms F]
+//                           [--warmup-ms F] [--out file] [--baseline file] [--threshold pct]
+//                           [--scene-objects N] [--no-gl] [--offscreen]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "SDL2/SDL.h"
+#include "glad/glad.h"
+
+#include "Engine/sceneManager.hpp"
+#include "Engine/objects/object.hpp"
+#include "Engine/objects/shapegen.hpp"
+#include "Engine/scene/sceneGenerator.hpp"
+#include "Engine/util/shaderc.hpp"
+#include "math/math.hpp"
+
+#include "benchContext.hpp"
+#include "microbench.hpp"
+
+using namespace NMATH;
+using microbench::doNotOptimize;
+
+// Same sequence everywhere, so every run measures the same inputs.
+static uint32_t s_rng = 12345u;
+static float randf(float lo, float hi) {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(s_rng >> 8) / (float)(1u << 24);
+}
+
+static std::string caseName(const char* name, const char* param, long long value) {
+    char buf[160];
+    snprintf(buf, sizeof(buf), "%s/%s:%lld", name, param, value);
+    return buf;
+}
+
+static void shapeCases(microbench::Runner& runner) {
+    // The output vectors keep their capacity between calls: this measures generation, not
+    // the allocator.
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+
+    const int sphereSegments[] = { 8, 16, 32, 64, 128 };
+    for (size_t i = 0; i < sizeof(sphereSegments) / sizeof(sphereSegments[0]); ++i) {
+        const int segments = sphereSegments[i];
+        runner.run(caseName("ShapeGenerator::createSphere", "segments", segments), [&](uint64_t n) {
+            for (uint64_t it = 0; it < n; ++it) {
+                vertices.clear();
+                indices.clear();
+                ShapeGenerator::createSphere(1.0f, segments, segments / 2, vertices, indices);
+                doNotOptimize(vertices.data());
+                doNotOptimize(indices.data());
+            }
+        });
+    }
+
+    const int cylinderSegments[] = { 8, 32, 128, 512 };
+    for (size_t i = 0; i < sizeof(cylinderSegments) / sizeof(cylinderSegments[0]); ++i) {
+        const int segments = cylinderSegments[i];
+        const Vec3d start(0.0f, 0.0f, 0.0f), end(0.3f, 2.0f, -0.2f);
+        runner.run(caseName("ShapeGenerator::createCylinder", "segments", segments), [&](uint64_t n) {
+            for (uint64_t it = 0; it < n; ++it) {
+                vertices.clear();
+                indices.clear();
+                ShapeGenerator::createCylinder(start, end, 0.5f, segments, vertices, indices);
+                doNotOptimize(vertices.data());
+                doNotOptimize(indices.data());
+            }
+        });
+    }
+}
+
+static void transformCases(microbench::Runner& runner) {
+    Object obj;
+    obj.position = Vec3d(1.0f, 2.0f, 3.0f);
+    obj.rotation = Vec3d(10.0f, 20.0f, 30.0f);
+    obj.scale = Vec3d(1.5f);
+
+    runner.run("Object::getModelMatrix/cached", [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) doNotOptimize(obj.getModelMatrix());
+    });
+
+    // a moved object: change detection plus recomposing the matrix
+    runner.run("Object::getModelMatrix/moved", [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            obj.position.x = (float)(it & 255);
+            obj.markDirty();
+            doNotOptimize(obj.getModelMatrix());
+        }
+    });
+
+    // moving the root of a four level chain invalidates the leaf
+    Object chain[4];
+    for (int i = 1; i < 4; ++i) {
+        chain[i].position = Vec3d(0.0f, 1.0f, 0.0f);
+        chain[i].rotation = Vec3d(0.0f, 15.0f * i, 0.0f);
+        chain[i].setParent(&chain[i - 1]);
+    }
+    runner.run("Object::getModelMatrix/moved_parent_depth:4", [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) {
+            chain[0].position.x = (float)(it & 255);
+            chain[0].markDirty();
+            doNotOptimize(chain[3].getModelMatrix());
+        }
+    });
+    for (int i = 3; i > 0; --i) chain[i].setParent(nullptr);
+}
+
+static void mathCases(microbench::Runner& runner) {
+    // a pool of inputs larger than one matrix, so the result is not folded into a constant
+    const size_t POOL = 1024;
+    std::vector<Mat4> affine(POOL), viewProj(POOL);
+    const Mat4 projection = perspective(radians(45.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    for (size_t i = 0; i < POOL; ++i) {
+        Mat4 m = translate(Mat4(1.0f), Vec3d(randf(-50, 50), randf(-5, 5), randf(-50, 50)));
+        m = rotate(m, radians(randf(0, 360)), Vec3d(0.0f, 1.0f, 0.0f));
+        affine[i] = scale(m, Vec3d(randf(0.5f, 2.0f)));
+        Vec3d eye(randf(-20, 20), randf(2, 10), randf(-20, 20));
+        viewProj[i] = projection * lookAt(eye, Vec3d(0.0f), Vec3d(0.0f, 1.0f, 0.0f));
+    }
+
+    runner.run("Mat4::inverse/affine", [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) doNotOptimize(affine[it & (POOL - 1)].inverse());
+    });
+    runner.run("Mat4::inverse/view_projection", [&](uint64_t n) {
+        for (uint64_t it = 0; it < n; ++it) doNotOptimize(viewProj[it & (POOL - 1)].inverse());
+    });
+}
+
+// SceneManager submits its shaders to the compiler threads; let them finish before the
+// scene is timed or deleted.
+static void waitForShaders() {
+    while (Shaderc::pendingCount() > 0) {
+        Shaderc::poll();
+        SDL_Delay(1);
+    }
+}
+
+static void pickCases(microbench::Runner& runner) {
+    const size_t counts[] = { 100, 1000, 10000 };
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+        const std::string name = caseName("SceneManager::pickObject", "objects", (long long)counts[c]);
+        if (!runner.selected(name)) continue;
+
+        SceneGenSettings settings;
+        settings.setObjectCount(counts[c]);
+        settings.pointLights = 0;
+        settings.texturedFraction = 0.0f;
+        SceneManager* scene = new SceneManager();
+        scene->generateScene(settings);
+        waitForShaders();
+
+        // rays from above the scene towards random points on the ground, most of them hit
+        const float extent = std::max(10.0f, std::sqrt((float)counts[c]));
+        const size_t RAYS = 256;
+        std::vector<Vec3d> origins(RAYS), dirs(RAYS);
+        for (size_t i = 0; i < RAYS; ++i) {
+            origins[i] = Vec3d(randf(-extent, extent) * 0.5f, 30.0f, extent * 1.2f);
+            Vec3d target(randf(-extent, extent), 0.5f, randf(-extent, extent));
+            dirs[i] = (target - origins[i]).normalized();
+        }
+        runner.run(name, [&](uint64_t n) {
+            for (uint64_t it = 0; it < n; ++it) {
+                doNotOptimize(scene->pickObject(origins[it & (RAYS - 1)], dirs[it & (RAYS - 1)]));
+            }
+        });
+        delete scene;
+    }
+}
+
+static long long fileSize(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return -1;
+    fseek(f, 0, SEEK_END);
+    long long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+static void sceneIoCases(microbench::Runner& runner, size_t objectCount, FILE* out) {
+    const char* const formats[] = { "json", "binary" };
+    const char* const paths[] = { "microbench_scene.gscene", "microbench_scene.gsceneb" };
+    SceneGenSettings settings;
+    settings.setObjectCount(objectCount);
+    settings.pointLights = 16;
+
+    SceneManager* scene = new SceneManager();
+    scene->generateScene(settings);
+    waitForShaders();
+    for (int f = 0; f < 2; ++f) {
+        const std::string saveName = std::string("SceneManager::saveScene/") + formats[f] +
+                                     caseName("", "objects", (long long)objectCount);
+        const std::string loadName = std::string("SceneManager::loadScene/") + formats[f] +
+                                     caseName("", "objects", (long long)objectCount);
+        if (!runner.selected(saveName) && !runner.selected(loadName)) continue;
+
+        // large files: a few samples of one call each are enough
+        runner.run(saveName, [&](uint64_t n) {
+            for (uint64_t it = 0; it < n; ++it) scene->saveScene(paths[f]);
+        }, 7);
+        if (runner.selected(loadName)) {
+            if (!runner.selected(saveName)) scene->saveScene(paths[f]);
+            fprintf(out, "# %s: %lld bytes\n", paths[f], fileSize(paths[f]));
+            // each load also tears down the previous one, as reloading a scene in the editor does
+            SceneManager* loaded = new SceneManager();
+            waitForShaders();
+            runner.run(loadName, [&](uint64_t n) {
+                for (uint64_t it = 0; it < n; ++it) loaded->loadScene(paths[f]);
+                doNotOptimize(loaded->objects.size());
+            }, 7);
+            delete loaded;
+        }
+        remove(paths[f]);
+    }
+    delete scene;
+}
+
+int main(int argc, char* argv[]) {
+    microbench::Options options;
+    std::string outPath, baselinePath;
+    double threshold = 5.0;
+    size_t sceneObjects = 20000;
+    bool useGl = true, offscreen = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (a == "--filter" && hasValue) { options.filter = argv[++i]; continue; }
+        if (a == "--samples" && hasValue) { options.samples = std::max(3, atoi(argv[++i])); continue; }
+        if (a == "--min-sample-ms" && hasValue) { options.minSampleMs = std::max(0.1, atof(argv[++i])); continue; }
+        if (a == "--warmup-ms" && hasValue) { options.warmupMs = std::max(0.0, atof(argv[++i])); continue; }
+        if (a == "--out" && hasValue) { outPath = argv[++i]; continue; }
+        if (a == "--baseline" && hasValue) { baselinePath = argv[++i]; continue; }
+        if (a == "--threshold" && hasValue) { threshold = std::max(0.0, atof(argv[++i])); continue; }
+        if (a == "--scene-objects" && hasValue) { sceneObjects = (size_t)std::max(1LL, atoll(argv[++i])); continue; }
+        if (a == "--no-gl") { useGl = false; continue; }
+        if (a == "--offscreen") { offscreen = true; continue; }
+        fprintf(stderr, "[Microbench] unknown argument '%s'\n", a.c_str());
+        return 2;
+    }
+
+    std::map<std::string, double> baseline;
+    if (!baselinePath.empty() && !microbench::Runner::readBaseline(baselinePath, baseline)) {
+        fprintf(stderr, "[Microbench] cannot read baseline '%s'\n", baselinePath.c_str());
+        return 2;
+    }
+    FILE* out = outPath.empty() ? stdout : fopen(outPath.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "[Microbench] cannot write '%s'\n", outPath.c_str());
+        return 1;
+    }
+
+    microbench::Runner runner(options);
+    shapeCases(runner);
+    transformCases(runner);
+    mathCases(runner);
+
+    SDL_Window* window = NULL;
+    SDL_GLContext context = NULL;
+    if (useGl && createBenchContextAnyDriver("GENGINE_MICROBENCH", offscreen, 64, 64, window, context)) {
+        if (gladLoadGL()) {
+            // results are only comparable on the same renderer
+            fprintf(out, "# renderer: %s / %s\n", (const char*)glGetString(GL_RENDERER),
+                    (const char*)glGetString(GL_VERSION));
+            pickCases(runner);
+            sceneIoCases(runner, sceneObjects, out);
+        } else {
+            fprintf(stderr, "[Microbench] gladLoadGL failed, SceneManager cases skipped\n");
+        }
+        SDL_GL_DeleteContext(context);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+    } else {
+        fprintf(out, "# no GL context: SceneManager cases skipped\n");
+    }
+
+    runner.write(out);
+    if (out != stdout) fclose(out);
+
+    if (!baseline.empty()) {
+        int regressions = runner.compare(baseline, threshold, stdout);
+        if (regressions) fprintf(stderr, "[Microbench] %d case(s) slower than the baseline by more than %.1f%%\n",
+                                 regressions, threshold);
+    }
+    return 0;
+}
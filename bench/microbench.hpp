@@ -0,0 +1,190 @@
+#ifndef MICROBENCH_HPP
+#define MICROBENCH_HPP
+
+// Minimal microbenchmark harness for GENGINE_MICROBENCH.
+//
+// A case is a function taking an iteration count and running its body that many times.
+// Each case is warmed up, then the iteration count is raised until one sample takes at
+// least Options::minSampleMs, and Options::samples samples are timed. Results are per
+// iteration in nanoseconds: median, mean, standard deviation, min and p95 of the samples.
+//
+// Output is one line per case in a fixed order and a fixed column layout, so two runs can be
+// diffed, and --baseline reads such a file back to print the change of each median.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace microbench {
+
+// Makes the compiler assume 'value' is read, so the work producing it is not optimized away.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    // no inline asm on MSVC x64: publish the address through a volatile
+    static const void* volatile sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#endif
+}
+
+// Makes the compiler assume all memory is read and written here.
+inline void clobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    _ReadWriteBarrier();
+#endif
+}
+
+struct Options {
+    double warmupMs = 50.0;         // per case, at least one call
+    double minSampleMs = 5.0;       // iterations per sample are raised until a sample is this long
+    int samples = 25;
+    std::string filter;             // substring of the case name, empty runs everything
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations;            // per sample
+    int samples;
+    double medianNs, meanNs, stddevNs, minNs, p95Ns;
+};
+
+class Runner {
+public:
+    typedef std::chrono::high_resolution_clock Clock;
+
+    explicit Runner(const Options& options) : options(options) {}
+
+    bool selected(const std::string& name) const {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    // 'samples' overrides Options::samples for slow cases, 0 keeps it.
+    template <typename Fn>
+    void run(const std::string& name, Fn fn, int samples = 0) {
+        if (!selected(name)) return;
+        if (samples <= 0) samples = options.samples;
+
+        // warmup, also a first estimate of the cost of one iteration
+        uint64_t iterations = 1;
+        double elapsedMs = 0.0, lastMs = 0.0;
+        do {
+            lastMs = time(fn, iterations);
+            elapsedMs += lastMs;
+            if (lastMs < options.minSampleMs) iterations *= 2;
+        } while (elapsedMs < options.warmupMs);
+        if (lastMs > 0.0 && lastMs < options.minSampleMs) {
+            iterations = (uint64_t)std::ceil(iterations * 0.5 * options.minSampleMs / lastMs);
+        }
+        iterations = std::max<uint64_t>(iterations, 1);
+
+        std::vector<double> perIteration(samples);
+        for (int s = 0; s < samples; ++s) perIteration[s] = time(fn, iterations) * 1e6 / (double)iterations;
+
+        Result r;
+        r.name = name;
+        r.iterations = iterations;
+        r.samples = samples;
+        summarize(perIteration, r);
+        results.push_back(r);
+        fprintf(stderr, "[Microbench] %s: %.1f ns\n", name.c_str(), r.medianNs);
+    }
+
+    const std::vector<Result>& getResults() const { return results; }
+
+    static void writeHeader(FILE* out) {
+        fprintf(out, "# %-54s %12s %12s %8s %12s %12s %10s\n",
+                "case", "median_ns", "mean_ns", "stddev%", "min_ns", "p95_ns", "iterations");
+    }
+
+    void write(FILE* out) const {
+        writeHeader(out);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            fprintf(out, "%-56s %12.1f %12.1f %8.2f %12.1f %12.1f %10llu\n",
+                    r.name.c_str(), r.medianNs, r.meanNs, r.meanNs > 0.0 ? 100.0 * r.stddevNs / r.meanNs : 0.0,
+                    r.minNs, r.p95Ns, (unsigned long long)r.iterations);
+        }
+    }
+
+    // Medians of a file written by write(), by case name. Lines starting with '#' are skipped.
+    static bool readBaseline(const std::string& path, std::map<std::string, double>& medians) {
+        FILE* in = fopen(path.c_str(), "r");
+        if (!in) return false;
+        char line[512], name[256];
+        double median = 0.0;
+        while (fgets(line, sizeof(line), in)) {
+            if (line[0] == '#') continue;
+            if (sscanf(line, "%255s %lf", name, &median) == 2) medians[name] = median;
+        }
+        fclose(in);
+        return true;
+    }
+
+    // Change of each median against the baseline; a change smaller than 'threshold' percent is
+    // reported as noise. Returns the number of cases that got slower by more than that.
+    int compare(const std::map<std::string, double>& baseline, double threshold, FILE* out) const {
+        int regressions = 0;
+        fprintf(out, "# %-54s %12s %12s %9s\n", "case", "base_ns", "now_ns", "change");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::map<std::string, double>::const_iterator it = baseline.find(r.name);
+            if (it == baseline.end() || it->second <= 0.0) {
+                fprintf(out, "%-56s %12s %12.1f %9s\n", r.name.c_str(), "-", r.medianNs, "new");
+                continue;
+            }
+            const double change = 100.0 * (r.medianNs - it->second) / it->second;
+            const char* verdict = "";
+            if (change > threshold) { verdict = "  slower"; ++regressions; }
+            else if (change < -threshold) verdict = "  faster";
+            fprintf(out, "%-56s %12.1f %12.1f %+8.1f%%%s\n", r.name.c_str(), it->second, r.medianNs, change, verdict);
+        }
+        return regressions;
+    }
+
+private:
+    template <typename Fn>
+    static double time(Fn& fn, uint64_t iterations) {
+        clobberMemory();
+        Clock::time_point t0 = Clock::now();
+        fn(iterations);
+        clobberMemory();
+        return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    }
+
+    // Nearest-rank p95.
+    static void summarize(std::vector<double> v, Result& r) {
+        std::sort(v.begin(), v.end());
+        const size_t n = v.size();
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i) sum += v[i];
+        r.meanNs = sum / n;
+        double var = 0.0;
+        for (size_t i = 0; i < n; ++i) var += (v[i] - r.meanNs) * (v[i] - r.meanNs);
+        r.stddevNs = n > 1 ? std::sqrt(var / (n - 1)) : 0.0;
+        r.medianNs = n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+        r.minNs = v.front();
+        r.p95Ns = v[std::min(n - 1, (size_t)std::ceil(0.95 * n) - 1)];
+    }
+
+    Options options;
+    std::vector<Result> results;
+};
+
+} // namespace microbench
+
+#endif
@@ -0,0 +1,270 @@
+// Headless render benchmark: CPU and GPU frame times of SceneManager::render.
+//
+// Creates a hidden window (or, when no display is available, uses SDL's offscreen EGL
+// driver, so it runs under Mesa llvmpipe on machines without a GPU), loads a scene or
+// generates one, and renders it into an offscreen framebuffer along a fixed camera orbit.
+// CPU time is the time spent in render(), GPU time comes from timestamp queries around the
+// same work and is read back after the run, so measuring never stalls a frame.
+//
+// Prints a JSON summary (mean/median/p95/p99/min/max) to stdout or --json, and per-frame
+// samples to --csv. Run it from the build directory, next to the copied shaders.
+//
+// usage: GENGINE_BENCH [--scene file | --objects N --lights N --distribution D --seed N]
+//                      [--frames N] [--warmup N] [--width W] [--height H] [--json file]
+//                      [--csv file] [--trace file] [--offscreen]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "SDL2/SDL.h"
+#include "glad/glad.h"
+
+#include "Engine/sceneManager.hpp"
+#include "Engine/scene/sceneGenerator.hpp"
+#include "Engine/util/shaderc.hpp"
+#include "Engine/util/profiler.hpp"
+#include "Engine/util/renderStats.hpp"
+#include "math/math.hpp"
+
+#include "benchContext.hpp"
+
+using namespace NMATH;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+struct Summary {
+    double mean, median, p95, p99, min, max;
+};
+
+// Nearest-rank percentiles.
+static Summary summarize(std::vector<double> v) {
+    Summary s = { 0, 0, 0, 0, 0, 0 };
+    if (v.empty()) return s;
+    std::sort(v.begin(), v.end());
+    double sum = 0.0;
+    for (size_t i = 0; i < v.size(); ++i) sum += v[i];
+    const size_t n = v.size();
+    s.mean = sum / n;
+    s.median = v[n / 2];
+    s.p95 = v[std::min(n - 1, (size_t)std::ceil(0.95 * n) - 1)];
+    s.p99 = v[std::min(n - 1, (size_t)std::ceil(0.99 * n) - 1)];
+    s.min = v.front();
+    s.max = v.back();
+    return s;
+}
+
+static void printSummary(FILE* out, const char* name, const Summary& s, bool last) {
+    fprintf(out, "  \"%s\": {\"mean\": %.4f, \"median\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"min\": %.4f, \"max\": %.4f}%s\n",
+            name, s.mean, s.median, s.p95, s.p99, s.min, s.max, last ? "" : ",");
+}
+
+int main(int argc, char* argv[]) {
+    std::string scenePath, jsonPath, csvPath, tracePath;
+    SceneGenSettings generated;
+    generated.setObjectCount(2000);
+    generated.directionalLights = 1;
+    generated.pointLights = 3;
+    int frames = 300;
+    int warmup = 30;
+    int width = 1280, height = 720;
+    bool offscreen = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--scene" && i + 1 < argc) { scenePath = argv[++i]; continue; }
+        if (a == "--objects" && i + 1 < argc) { generated.setObjectCount((size_t)atol(argv[++i])); continue; }
+        // one directional light, the rest point lights
+        if (a == "--lights" && i + 1 < argc) {
+            size_t lights = (size_t)atol(argv[++i]);
+            generated.directionalLights = std::min<size_t>(lights, 1);
+            generated.pointLights = lights - generated.directionalLights;
+            continue;
+        }
+        if (a == "--distribution" && i + 1 < argc) {
+            if (!SceneGenSettings::parseDistribution(argv[++i], generated.distribution)) {
+                fprintf(stderr, "[Bench] unknown distribution '%s'\n", argv[i]);
+                return 2;
+            }
+            continue;
+        }
+        if (a == "--seed" && i + 1 < argc) { generated.seed = (uint32_t)strtoul(argv[++i], NULL, 10); continue; }
+        if (a == "--frames" && i + 1 < argc) { frames = std::max(1, atoi(argv[++i])); continue; }
+        if (a == "--warmup" && i + 1 < argc) { warmup = std::max(0, atoi(argv[++i])); continue; }
+        if (a == "--width" && i + 1 < argc) { width = std::max(16, atoi(argv[++i])); continue; }
+        if (a == "--height" && i + 1 < argc) { height = std::max(16, atoi(argv[++i])); continue; }
+        if (a == "--json" && i + 1 < argc) { jsonPath = argv[++i]; continue; }
+        if (a == "--csv" && i + 1 < argc) { csvPath = argv[++i]; continue; }
+        if (a == "--trace" && i + 1 < argc) { tracePath = argv[++i]; continue; }
+        if (a == "--offscreen") { offscreen = true; continue; }
+        fprintf(stderr, "[Bench] unknown argument '%s'\n", a.c_str());
+        return 2;
+    }
+
+    SDL_Window* window = NULL;
+    SDL_GLContext context = NULL;
+    // no display (build machines): fall back to the EGL offscreen driver
+    if (!createBenchContextAnyDriver("GENGINE_BENCH", offscreen, width, height, window, context)) return 1;
+    if (!gladLoadGL()) {
+        fprintf(stderr, "[Bench] gladLoadGL failed\n");
+        return 1;
+    }
+    RenderStats::install();
+    const std::string renderer = std::string((const char*)glGetString(GL_RENDERER)) + " / " +
+                                 (const char*)glGetString(GL_VERSION);
+    fprintf(stderr, "[Bench] %s on '%s'\n", renderer.c_str(), SDL_GetCurrentVideoDriver());
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);
+
+    // the frame is rendered into its own target, the hidden window's backbuffer may not exist
+    GLuint fbo = 0, color = 0, depth = 0;
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "[Bench] offscreen framebuffer incomplete\n");
+        return 1;
+    }
+
+    Shaderc compiler;
+    GLuint program = compiler.loadShader("shaders/vertex.glsl", "shaders/fragment.glsl");
+    if (program == 0) {
+        fprintf(stderr, "[Bench] failed to build the lit shader (run from the build directory)\n");
+        return 1;
+    }
+
+    SceneManager* scene = new SceneManager();
+    if (!scenePath.empty()) {
+        scene->loadScene(scenePath);
+    } else {
+        scene->generateScene(generated);
+        scenePath = std::string("generated:") + SceneGenSettings::distributionName(generated.distribution);
+    }
+    if (scene->objects.empty()) {
+        fprintf(stderr, "[Bench] scene '%s' has no objects\n", scenePath.c_str());
+        return 1;
+    }
+    // every pass should be ready before the first measured frame
+    while (Shaderc::pendingCount() > 0) {
+        Shaderc::poll();
+        SDL_Delay(1);
+    }
+
+    // orbit around the scene's bounds
+    Vec3d lo(1e30f), hi(-1e30f);
+    for (size_t i = 0; i < scene->objects.size(); ++i) {
+        const Vec3d& p = scene->objects[i]->position;
+        lo = Vec3d(std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z));
+        hi = Vec3d(std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z));
+    }
+    const Vec3d center = (lo + hi) * 0.5f;
+    const float radius = std::max((hi - lo).length() * 0.5f, 2.0f);
+    const Mat4 projection = perspective(radians(45.0f), (float)width / (float)height, 0.1f, radius * 4.0f);
+
+    if (!tracePath.empty()) Profiler::startTrace(tracePath);
+
+    const int total = warmup + frames;
+    std::vector<GLuint> queries(2 * frames);
+    glGenQueries((GLsizei)queries.size(), &queries[0]);
+    std::vector<double> cpuMs, frameMs, gpuMs;
+    cpuMs.reserve(frames);
+    frameMs.reserve(frames);
+
+    for (int f = 0; f < total; ++f) {
+        const bool measured = f >= warmup;
+        const int m = f - warmup;
+        Profiler::beginFrame();
+        Clock::time_point frameStart = Clock::now();
+        Shaderc::poll();
+
+        // warmup frames stay at the start of the path
+        float angle = measured ? 6.2831853f * (float)m / (float)frames : 0.0f;
+        Vec3d eye = center + Vec3d(std::cos(angle) * radius * 1.5f, radius * 0.6f, std::sin(angle) * radius * 1.5f);
+        Mat4 view = lookAt(eye, center, Vec3d(0.0f, 1.0f, 0.0f));
+
+        if (measured) glQueryCounter(queries[2 * m], GL_TIMESTAMP);
+        Clock::time_point cpuStart = Clock::now();
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+        glClearColor(0.1f, 0.1f, 0.12f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glUseProgram(program);
+        scene->render(program, view, projection);
+        Clock::time_point cpuEnd = Clock::now();
+        if (measured) glQueryCounter(queries[2 * m + 1], GL_TIMESTAMP);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        SDL_GL_SwapWindow(window);
+        Profiler::endFrame();
+        RenderStats::endFrame();
+
+        if (measured) {
+            cpuMs.push_back(std::chrono::duration<double, std::milli>(cpuEnd - cpuStart).count());
+            frameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count());
+        }
+    }
+
+    glFinish();
+    gpuMs.reserve(frames);
+    for (int m = 0; m < frames; ++m) {
+        GLuint64 t0 = 0, t1 = 0;
+        glGetQueryObjectui64v(queries[2 * m], GL_QUERY_RESULT, &t0);
+        glGetQueryObjectui64v(queries[2 * m + 1], GL_QUERY_RESULT, &t1);
+        gpuMs.push_back(t1 > t0 ? (t1 - t0) / 1e6 : 0.0);
+    }
+    Profiler::stopTrace();
+
+    const RenderStats::Counters& counts = RenderStats::lastFrame().total;
+    FILE* out = jsonPath.empty() ? stdout : fopen(jsonPath.c_str(), "w");
+    if (!out) {
+        fprintf(stderr, "[Bench] cannot write '%s'\n", jsonPath.c_str());
+        return 1;
+    }
+    fprintf(out, "{\n");
+    fprintf(out, "  \"renderer\": \"%s\",\n", renderer.c_str());
+    fprintf(out, "  \"scene\": \"%s\",\n", scenePath.c_str());
+    fprintf(out, "  \"objects\": %zu,\n", scene->objects.size());
+    fprintf(out, "  \"lights\": %zu,\n", scene->lights.size());
+    fprintf(out, "  \"width\": %d,\n  \"height\": %d,\n", width, height);
+    fprintf(out, "  \"frames\": %d,\n  \"warmup\": %d,\n", frames, warmup);
+    fprintf(out, "  \"draw_calls\": %u,\n  \"triangles\": %llu,\n", counts.drawCalls, (unsigned long long)counts.triangles);
+    printSummary(out, "cpu_ms", summarize(cpuMs), false);
+    printSummary(out, "gpu_ms", summarize(gpuMs), false);
+    printSummary(out, "frame_ms", summarize(frameMs), true);
+    fprintf(out, "}\n");
+    if (out != stdout) fclose(out);
+
+    if (!csvPath.empty()) {
+        FILE* csv = fopen(csvPath.c_str(), "w");
+        if (!csv) {
+            fprintf(stderr, "[Bench] cannot write '%s'\n", csvPath.c_str());
+            return 1;
+        }
+        fprintf(csv, "frame,cpu_ms,gpu_ms,frame_ms\n");
+        for (int m = 0; m < frames; ++m) fprintf(csv, "%d,%.4f,%.4f,%.4f\n", m, cpuMs[m], gpuMs[m], frameMs[m]);
+        fclose(csv);
+    }
+
+    glDeleteQueries((GLsizei)queries.size(), &queries[0]);
+    delete scene;
+    Shaderc::releaseProgram(program);
+    glDeleteRenderbuffers(1, &color);
+    glDeleteRenderbuffers(1, &depth);
+    glDeleteFramebuffers(1, &fbo);
+    SDL_GL_DeleteContext(context);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Procedural stress-scene generator, the command line side of SceneGenerator.
+//
+// Writes a .gscene (JSON) or .gsceneb (binary) file, chosen by the extension of --out, so
+// benchmarks can sweep scene sizes without building scenes by hand, e.g.
+//
+//   for n in 1000 10000 100000 1000000; do
+//       GENGINE_SCENEGEN --out stress_$n.gsceneb --objects $n --point-lights $((n / 1000))
+//   done
+//
+// usage: GENGINE_SCENEGEN --out file [--objects N] [--cubes N] [--spheres N] [--cylinders N]
+//                         [--pyramids N] [--planes N] [--dir-lights N] [--point-lights N]
+//                         [--distribution uniform|clustered|grid] [--extent F] [--clusters N]
+//                         [--cluster-radius F] [--textures N] [--textured F] [--texture path]...
+//                         [--no-ground] [--seed N]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "Engine/scene/sceneData.hpp"
+#include "Engine/scene/sceneGenerator.hpp"
+#include "Engine/scene/sceneSerializer.hpp"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+int main(int argc, char* argv[]) {
+    SceneGenSettings settings;
+    std::string outPath;
+    bool customTextures = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (a == "--out" && hasValue) { outPath = argv[++i]; continue; }
+        if (a == "--objects" && hasValue) { settings.setObjectCount((size_t)atoll(argv[++i])); continue; }
+        if (a == "--cubes" && hasValue) { settings.cubes = (size_t)atoll(argv[++i]); continue; }
+        if (a == "--spheres" && hasValue) { settings.spheres = (size_t)atoll(argv[++i]); continue; }
+        if (a == "--cylinders" && hasValue) { settings.cylinders = (size_t)atoll(argv[++i]); continue; }
+        if (a == "--pyramids" && hasValue) { settings.pyramids = (size_t)atoll(argv[++i]); continue; }
+        if (a == "--planes" && hasValue) { settings.planes = (size_t)atoll(argv[++i]); continue; }
+        if (a == "--dir-lights" && hasValue) { settings.directionalLights = (size_t)atoll(argv[++i]); continue; }
+        if (a == "--point-lights" && hasValue) { settings.pointLights = (size_t)atoll(argv[++i]); continue; }
+        if (a == "--extent" && hasValue) { settings.extent = (float)atof(argv[++i]); continue; }
+        if (a == "--clusters" && hasValue) { settings.clusters = (size_t)atoll(argv[++i]); continue; }
+        if (a == "--cluster-radius" && hasValue) { settings.clusterRadius = (float)atof(argv[++i]); continue; }
+        if (a == "--textures" && hasValue) { settings.textureVariety = (size_t)atoll(argv[++i]); continue; }
+        if (a == "--textured" && hasValue) { settings.texturedFraction = (float)atof(argv[++i]); continue; }
+        if (a == "--seed" && hasValue) { settings.seed = (uint32_t)strtoul(argv[++i], NULL, 10); continue; }
+        if (a == "--no-ground") { settings.ground = false; continue; }
+        if (a == "--texture" && hasValue) {
+            // the first --texture replaces the default set
+            if (!customTextures) settings.textures.clear();
+            customTextures = true;
+            settings.textures.push_back(argv[++i]);
+            continue;
+        }
+        if (a == "--distribution" && hasValue) {
+            if (!SceneGenSettings::parseDistribution(argv[++i], settings.distribution)) {
+                fprintf(stderr, "[SceneGen] unknown distribution '%s' (uniform, clustered, grid)\n", argv[i]);
+                return 2;
+            }
+            continue;
+        }
+        fprintf(stderr, "[SceneGen] unknown argument '%s'\n", a.c_str());
+        return 2;
+    }
+    if (outPath.empty()) {
+        fprintf(stderr, "usage: GENGINE_SCENEGEN --out scene.gscene|scene.gsceneb [options], see bench/scenegen.cpp\n");
+        return 2;
+    }
+
+    Clock::time_point t0 = Clock::now();
+    SceneData data;
+    SceneGenerator::generate(settings, data);
+    Clock::time_point t1 = Clock::now();
+    if (!SceneSerializer::save(outPath, data)) {
+        fprintf(stderr, "[SceneGen] failed to write '%s'\n", outPath.c_str());
+        return 1;
+    }
+    Clock::time_point t2 = Clock::now();
+
+    printf("%s: objects=%zu lights=%zu distribution=%s textures=%zu seed=%u\n", outPath.c_str(),
+           data.objectCount(), data.lightCount(), SceneGenSettings::distributionName(settings.distribution),
+           std::min(settings.textureVariety, settings.textures.size()), settings.seed);
+    printf("generate %.1f ms, write %.1f ms\n", std::chrono::duration<double, std::milli>(t1 - t0).count(),
+           std::chrono::duration<double, std::milli>(t2 - t1).count());
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Scene load-time benchmark: JSON (.gscene) vs binary (.gsceneb).
+//
+// Generates a synthetic scene, writes it in both formats, then times reading each back
+// into SceneData and checks that the binary round trip is lossless.
+//
+// usage: GENGINE_SCENE_BENCH [--objects N] [--lights N] [--reps N] [--dir path]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "Engine/scene/sceneData.hpp"
+#include "Engine/scene/sceneSerializer.hpp"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static void makeScene(SceneData& data, size_t objectCount, size_t lightCount) {
+    static const char* types[] = { "Cube", "Sphere", "Cylinder", "Plane", "Pyramid" };
+    static const char* textures[] = { "", "textures/peppa.png", "textures/yoda.png", "textures/yoda2.png" };
+
+    data.clear();
+    data.reserve(objectCount, lightCount, objectCount * 16);
+    char name[64];
+    for (size_t i = 0; i < objectCount; ++i) {
+        snprintf(name, sizeof(name), "Object_%zu", i);
+        float f = (float)i;
+        data.addObject(data.addString(name),
+                       data.addSharedString(types[i % 5]),
+                       data.addSharedString(textures[i % 4]),
+                       Vec3d(f * 0.25f, (float)(i % 7), -f * 0.5f),
+                       Vec3d((float)(i % 360), 15.5f, 0.125f),
+                       Vec3d(1.0f, 1.0f + (float)(i % 3), 1.0f));
+    }
+    for (size_t i = 0; i < lightCount; ++i) {
+        data.addLight((i % 2) ? LightType::Point : LightType::Directional,
+                      Vec3d((float)i, 5.0f, 0.0f), Vec3d(-0.2f, -1.0f, -0.3f),
+                      Vec3d(1.0f, 0.9f, 0.8f), 1.0f + (float)i);
+    }
+}
+
+template <typename T>
+static bool sameArray(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && (a.empty() || std::memcmp(&a[0], &b[0], a.size() * sizeof(T)) == 0);
+}
+
+static bool sameScene(const SceneData& a, const SceneData& b) {
+    if (a.objectCount() != b.objectCount() || a.lightCount() != b.lightCount()) return false;
+    if (!sameArray(a.positions, b.positions) || !sameArray(a.rotations, b.rotations) || !sameArray(a.scales, b.scales)) return false;
+    if (!sameArray(a.lightTypes, b.lightTypes) || !sameArray(a.lightPositions, b.lightPositions) ||
+        !sameArray(a.lightDirections, b.lightDirections) || !sameArray(a.lightColors, b.lightColors) ||
+        !sameArray(a.lightIntensities, b.lightIntensities)) return false;
+    // string tables may be laid out differently (shared strings), compare contents
+    for (size_t i = 0; i < a.objectCount(); ++i) {
+        if (std::strcmp(a.str(a.names[i]), b.str(b.names[i])) != 0) return false;
+        if (std::strcmp(a.str(a.types[i]), b.str(b.types[i])) != 0) return false;
+        if (std::strcmp(a.str(a.texturePaths[i]), b.str(b.texturePaths[i])) != 0) return false;
+    }
+    return true;
+}
+
+static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    return v.empty() ? 0.0 : v[v.size() / 2];
+}
+
+template <typename Fn>
+static double timeMs(Fn fn, int reps, bool& ok) {
+    std::vector<double> samples;
+    for (int r = 0; r < reps; ++r) {
+        Clock::time_point t0 = Clock::now();
+        ok = fn() && ok;
+        samples.push_back(std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+    return median(samples);
+}
+
+int main(int argc, char* argv[]) {
+    size_t objectCount = 100000;
+    size_t lightCount = 8;
+    int reps = 5;
+    std::string dir = ".";
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--objects" && i + 1 < argc) { objectCount = (size_t)atol(argv[++i]); continue; }
+        if (a == "--lights" && i + 1 < argc) { lightCount = (size_t)atol(argv[++i]); continue; }
+        if (a == "--reps" && i + 1 < argc) { reps = std::max(1, atoi(argv[++i])); continue; }
+        if (a == "--dir" && i + 1 < argc) { dir = argv[++i]; continue; }
+    }
+
+    std::string jsonPath = dir + "/sceneio_bench.gscene";
+    std::string binPath = dir + "/sceneio_bench.gsceneb";
+
+    SceneData scene;
+    makeScene(scene, objectCount, lightCount);
+
+    bool ok = true;
+    double writeJsonMs = timeMs([&]() { return SceneSerializer::save(jsonPath, scene); }, 1, ok);
+    double writeBinMs = timeMs([&]() { return SceneSerializer::save(binPath, scene); }, 1, ok);
+    if (!ok) {
+        fprintf(stderr, "[SceneBench] failed to write scene files to '%s'\n", dir.c_str());
+        return 1;
+    }
+
+    SceneData fromJson, fromBin;
+    double readJsonMs = timeMs([&]() { return SceneSerializer::load(jsonPath, fromJson); }, reps, ok);
+    double readBinMs = timeMs([&]() { return SceneSerializer::load(binPath, fromBin); }, reps, ok);
+
+    bool jsonLossless = ok && sameScene(scene, fromJson);
+    bool binLossless = ok && sameScene(scene, fromBin);
+
+    printf("objects=%zu lights=%zu reps=%d\n", objectCount, lightCount, reps);
+    printf("%-8s %12s %12s %10s\n", "format", "write_ms", "read_ms", "lossless");
+    printf("%-8s %12.2f %12.2f %10s\n", "json", writeJsonMs, readJsonMs, jsonLossless ? "yes" : "NO");
+    printf("%-8s %12.2f %12.2f %10s\n", "binary", writeBinMs, readBinMs, binLossless ? "yes" : "NO");
+    if (readBinMs > 0.0) printf("binary read speedup: %.1fx\n", readJsonMs / readBinMs);
+
+    remove(jsonPath.c_str());
+    remove(binPath.c_str());
+    return (jsonLossless && binLossless) ? 0 : 1;
+}
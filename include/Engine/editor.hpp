@@ -37,6 +37,9 @@ private:
 
     void SaveScene();
     void LoadScene();
+    void Autosave();
+
+    static const Uint32 AUTOSAVE_INTERVAL_MS = 30000;
 
     SDL_Window* window;
     GameMain* game;
@@ -71,8 +74,13 @@ private:
     std::string buildMessage;              // status / feedback for build operations
     bool invokeCMakeBuild;                 // whether to call cmake --build for GENGINE_PLAYER
 
+    bool showProfiler;
+    bool showRenderStats;
+
     // Project browser state
     std::string selectedFolder;            // moved into class to avoid globals
+
+    Uint32 lastAutosaveTicks;
 };
 
 #endif
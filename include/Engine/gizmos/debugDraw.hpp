@@ -0,0 +1,43 @@
+#ifndef DEBUGDRAW_HPP
+#define DEBUGDRAW_HPP
+
+#include <cstddef>
+
+#include "math/math.hpp"
+#include <glad/glad.h>
+
+using namespace NMATH;
+
+// Immediate-mode debug drawing with retained GL buffers. The calls below only append
+// world-space vertices to CPU arrays; flush() uploads them into one streaming vertex buffer
+// and draws everything with one draw per primitive type (plus one per distinct point size).
+//
+// The buffer and VAO are created on the first flush and kept, so a frame of debug geometry
+// costs no GL object creation and, once the arrays have grown, no heap allocation either.
+// Main thread only.
+class DebugDraw {
+public:
+    static void line(const Vec3d& a, const Vec3d& b, const Vec3d& color);
+    // Line with a small four-fin head at 'to'; headSize is in world units.
+    static void arrow(const Vec3d& from, const Vec3d& to, const Vec3d& color, float headSize = 0.1f);
+    // Flat quad of the given width along start->end (see Billboard::DrawBillboard).
+    static void billboard(const Vec3d& start, const Vec3d& end, float thickness, const Vec3d& color);
+    // size is in pixels, as glPointSize.
+    static void point(const Vec3d& p, const Vec3d& color, float size = 10.0f);
+    static void wireBox(const Vec3d& min, const Vec3d& max, const Vec3d& color);
+
+    // Draws and clears everything queued so far with the given program (which must have the
+    // aPos/aColor attributes and the model/view/projection uniforms). Depth state is left to
+    // the caller.
+    static void flush(GLuint shaderProgram, const Mat4& view, const Mat4& projection);
+    // Drops queued geometry without drawing it.
+    static void clear();
+
+    static size_t queuedVertices();
+
+    // Creates the GL buffer up front; flush() does it lazily otherwise.
+    static void init();
+    static void shutdown();
+};
+
+#endif
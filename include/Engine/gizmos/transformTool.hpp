@@ -39,6 +39,10 @@ public:
 
 	// Draw the gizmo at the given position with the given view/projection matrices
 	static void drawGizmo(const Vec3d& objPosition, int grabbedAxisIndex, GLuint shaderProgram, const Mat4& view, const Mat4& projection);
+
+	// Draws the cached arrow mesh of one axis (0=X,1=Y,2=Z) at the origin with whatever program
+	// and model matrix are bound; used by drawGizmo and the ID picking pass.
+	static void drawAxisMesh(int axis);
 };
 
 #endif
\ No newline at end of file
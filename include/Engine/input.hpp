@@ -5,6 +5,7 @@
 #include <SDL2/SDL_mouse.h>
 
 #include "math/math.hpp"
+#include "Engine/scene/idPicker.hpp"
 
 #include "imgui.h"
 
@@ -43,6 +44,13 @@ public:
 
     // Internal state used for edge detection when processing viewport mouse
     bool prevViewportMouseDown;
+
+    // GPU picking for clicks and hover; NULL keeps the CPU ray tests. A click is resolved when
+    // its readback arrives, against the ray it was made with.
+    IdPicker* picker;
+    bool clickPending;
+    Vec3d clickRayOrigin, clickRayDir;
+    IdPicker::Result pickResult;
 };
 
 #endif
\ No newline at end of file
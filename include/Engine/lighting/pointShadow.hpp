@@ -0,0 +1,72 @@
+#ifndef POINTSHADOW_HPP
+#define POINTSHADOW_HPP
+
+#include "math/math.hpp"
+using namespace NMATH;
+
+#include "glad/glad.h"
+
+#include <cstdint>
+#include <vector>
+
+class SceneManager;
+
+// Omnidirectional shadow for a point light: a depth cube map holding, per texel, the distance
+// to the closest caster divided by the light's range (shaders/shadows/point_depth_*.glsl).
+//
+// Each face is culled against its own 90 degree frustum, which ends at the light's range, and
+// remembers a signature of the casters it last drew (which objects, their transformVersion and
+// mesh). A face is only re-rendered when that signature changes or the light moves, so a static
+// scene costs nothing after the first six faces.
+//
+// A moved light gets its new cube map built in a second texture, a few faces per frame under
+// the face budget, while shading keeps sampling the last complete one. A build keeps the
+// position it started at, so a light that never stops still completes maps (each one a few
+// frames behind) instead of restarting forever.
+class PointShadow {
+public:
+	static const int FACES = 6;
+
+	PointShadow();
+	~PointShadow();
+
+	int SHADOW_SIZE;
+
+	// Range a light of this intensity reaches before its 1/d^2 falloff drops below 1%.
+	static float rangeFor(float intensity);
+
+	// Re-renders the stale faces for a light at lightPos, at most faceBudget of them; the rest
+	// stay stale until a later call. Returns the number of faces rendered.
+	int update(SceneManager* scene, GLuint depthProg, const Vec3d& lightPos, float range, int faceBudget);
+	// Drops both maps, for a map handed to another light.
+	void invalidate();
+	// True once a complete cube map exists, possibly for an earlier light position.
+	bool ready() const { return hasFront; }
+
+	// The complete map, and the position and range it was rendered for.
+	GLuint getDepthTexture() const { return cubeTex[front]; }
+	float getFarPlane() const { return frontFar; }
+	const Vec3d& getOrigin() const { return frontPos; }
+
+private:
+	uint64_t faceSignature(SceneManager* scene, int face, const Mat4& viewProj);
+	void createTexture(int map);
+	// Renders the faces of map 'map' that are missing or whose casters changed.
+	int renderFaces(SceneManager* scene, GLuint depthProgram, int map, const Vec3d& pos, float far, int faceBudget);
+
+	GLuint fbo;
+	GLuint cubeTex[2];			// the second one is created when the light first moves
+	int front;					// map the shader samples
+	bool hasFront;
+	Vec3d frontPos;
+	float frontFar;
+	bool building;				// the other map is being rendered for buildPos/buildFar
+	Vec3d buildPos;
+	float buildFar;
+	float nearP;
+	bool faceValid[2][FACES];
+	uint64_t signatures[2][FACES];
+	std::vector<uint8_t> faceVisible;	// scratch, per entity
+};
+
+#endif
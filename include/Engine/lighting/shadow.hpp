@@ -6,29 +6,51 @@ using namespace NMATH;
 
 #include "glad/glad.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 class SceneManager;
 
 class Shadow {
 public:
+	// PCF kernel used when sampling the maps (uShadowKernel in shaders/fragment.glsl). Every
+	// tap is already a hardware-filtered 2x2 compare.
+	enum Quality {
+		HARD = 0,			// 1 tap
+		POISSON_4 = 1,		// 4-tap Poisson disk
+		PCF_9 = 2,			// 3x3 grid
+		POISSON_ROTATED = 3	// 8-tap Poisson disk, rotated per pixel
+	};
+	static const char* qualityName(Quality q);
+
 	Shadow();
 	~Shadow();
 
 	Vec3d lightPos;
 	Vec3d lightDir;
-	float sz;				// orthographic half-size for directional light
+	float sz;				// orthographic half-size of the box used when nothing casts
 	float nearP;
 	float farP;
 	int SHADOW_SIZE;
 
-	Mat4 renderDepth(SceneManager* scene, GLuint depthProg);
+	// receivers[i] flags the entities the camera can see (null: all of them). Only casters
+	// that can shadow one of those are rendered, into a box fitted around them.
+	Mat4 renderDepth(SceneManager* scene, GLuint depthProg, const uint8_t* receivers = NULL);
 
 	GLuint getDepthTexture() const { return depthMapTex; }
 	const Mat4& getLightSpaceMatrix() const { return lastLightSpace; }
+	// What the last renderDepth worked with.
+	size_t getCasterCount() const { return casterCount; }
+	size_t getReceiverCount() const { return receiverCount; }
 
 private:
 	GLuint depthMapFBO;
 	GLuint depthMapTex;
 	Mat4 lastLightSpace;
+	size_t casterCount;
+	size_t receiverCount;
+	std::vector<Vec3d> lightSpaceCenters;	// scratch, per entity
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef QUAT_HPP
+#define QUAT_HPP
+
+#include <cmath>
+
+#include "math/math.hpp"
+using namespace NMATH;
+
+// Unit quaternion for rotations (x, y, z vector part, w scalar part).
+struct Quat {
+    float x, y, z, w;
+
+    Quat() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+    Quat(float qx, float qy, float qz, float qw) : x(qx), y(qy), z(qz), w(qw) {}
+
+    static Quat fromAxisAngle(const Vec3d& axis, float radians) {
+        float s = std::sin(radians * 0.5f);
+        return Quat(axis.x * s, axis.y * s, axis.z * s, std::cos(radians * 0.5f));
+    }
+
+    // Same convention as the editor's Euler angles: rotate(X) * rotate(Y) * rotate(Z), in degrees.
+    static Quat fromEulerDegrees(const Vec3d& euler) {
+        return fromAxisAngle(Vec3d(1.0f, 0.0f, 0.0f), radians(euler.x)) *
+               fromAxisAngle(Vec3d(0.0f, 1.0f, 0.0f), radians(euler.y)) *
+               fromAxisAngle(Vec3d(0.0f, 0.0f, 1.0f), radians(euler.z));
+    }
+
+    Quat operator*(const Quat& q) const {
+        return Quat(w * q.x + x * q.w + y * q.z - z * q.y,
+                    w * q.y - x * q.z + y * q.w + z * q.x,
+                    w * q.z + x * q.y - y * q.x + z * q.w,
+                    w * q.w - x * q.x - y * q.y - z * q.z);
+    }
+
+    Quat conjugate() const { return Quat(-x, -y, -z, w); }
+
+    Quat normalized() const {
+        float len = std::sqrt(x * x + y * y + z * z + w * w);
+        if (len <= 0.0f) return Quat();
+        float inv = 1.0f / len;
+        return Quat(x * inv, y * inv, z * inv, w * inv);
+    }
+
+    Vec3d rotate(const Vec3d& v) const {
+        // v + 2w(q x v) + 2(q x (q x v))
+        Vec3d q(x, y, z);
+        Vec3d t = q.cross(v) * 2.0f;
+        return v + t * w + q.cross(t);
+    }
+};
+
+// translate(position) * rotation * scale, built directly instead of through three
+// matrix products. Column-major like the rest of the engine (m[column][row]).
+inline Mat4 composeTRS(const Vec3d& position, const Quat& q, const Vec3d& scale) {
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    Mat4 m(1.0f);
+    m.m[0][0] = (1.0f - 2.0f * (yy + zz)) * scale.x;
+    m.m[0][1] = (2.0f * (xy + wz)) * scale.x;
+    m.m[0][2] = (2.0f * (xz - wy)) * scale.x;
+
+    m.m[1][0] = (2.0f * (xy - wz)) * scale.y;
+    m.m[1][1] = (1.0f - 2.0f * (xx + zz)) * scale.y;
+    m.m[1][2] = (2.0f * (yz + wx)) * scale.y;
+
+    m.m[2][0] = (2.0f * (xz + wy)) * scale.z;
+    m.m[2][1] = (2.0f * (yz - wx)) * scale.z;
+    m.m[2][2] = (1.0f - 2.0f * (xx + yy)) * scale.z;
+
+    m.m[3][0] = position.x;
+    m.m[3][1] = position.y;
+    m.m[3][2] = position.z;
+    return m;
+}
+
+#endif
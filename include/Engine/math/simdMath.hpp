@@ -0,0 +1,43 @@
+#ifndef SIMDMATH_HPP
+#define SIMDMATH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Batch math kernels for the per-frame loops. Each call processes N elements with AVX2 or
+// SSE4.1 when Engine/math/simdMath.cpp is built for them (see GENGINE_SIMD in CMakeLists.txt),
+// and with plain scalar code otherwise; results match the scalar path to float precision.
+//
+// Matrices are 16 floats, column-major, same layout as Mat4::value_ptr(). Vectors are packed
+// 3 floats per element unless noted. Nothing here allocates.
+class SimdMath {
+public:
+    // "AVX2", "SSE4.1" or "scalar"
+    static const char* backend();
+
+    // out[i] = translate(positions[i]) * rotation(quats[i]) * scale(scales[i]).
+    // quats are 4 floats per element (x, y, z, w), unit length.
+    static void composeTRS(const float* positions, const float* quats, const float* scales,
+                           float* outMatrices, size_t count);
+
+    // out[i] = lhs * matrices[i], e.g. lhs = projection * view. out must not alias matrices.
+    static void multiplyMatrices(const float* lhs, const float* matrices, float* outMatrices, size_t count);
+
+    // Six inward-facing planes (a, b, c, d), normalized, from a view-projection matrix:
+    // left, right, bottom, top, near, far.
+    static void extractFrustumPlanes(const float* viewProj, float* outPlanes24);
+
+    // visible[i] = 1 unless sphere i lies entirely outside one of the planes.
+    // Centers are split into x/y/z arrays so the kernel can load them directly.
+    static void cullSpheres(const float* planes24, const float* centerX, const float* centerY,
+                            const float* centerZ, const float* radii, uint8_t* visible, size_t count);
+
+    // Closest two-sided hit of one ray with an indexed triangle list. Vertex positions are
+    // read as 3 floats at 'positions + stride * index' (stride in bytes, so a Vertex array can
+    // be passed as is). Returns the triangle number or -1; tOut is the distance along dir.
+    static long intersectRayTriangles(const float* origin, const float* dir,
+                                      const void* positions, size_t stride,
+                                      const unsigned int* indices, size_t triangleCount, float& tOut);
+};
+
+#endif
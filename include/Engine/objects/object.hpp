@@ -4,6 +4,8 @@
 #include <vector>
 #include "glad/glad.h"
 #include "Engine/objects/shapegen.hpp"
+#include "Engine/scene/entityStore.hpp"
+#include "Engine/math/quat.hpp"
 
 #include "math/math.hpp"
 using namespace NMATH;
@@ -15,14 +17,37 @@ public:
     std::string type;
     Vec3d scale;
     std::string name;
+    unsigned int id;            // unique within a session, assigned by SceneManager (0 = none yet)
+    EntityHandle entity;        // this object's slot in SceneManager::entities
+    // Interned copies used by the scene's lookup index. Change the name and tags through
+    // SceneManager::renameObject/setTags so the index follows.
+    StringId nameId;
+    StringId typeId;
+    uint32_t tags;              // bit per tag, see SceneManager::tagMask
+
+    // position/rotation/scale are relative to the parent, if any.
+    Object* parent;
+    std::vector<Object*> children;
+    // Static objects skip change detection; call markDirty() after moving one or after
+    // changing isStatic.
+    bool isStatic;
 
     unsigned int VAO, VBO, EBO;
     unsigned int textureID;
+    bool sharedTexture;         // textureID belongs to a prefab or the loaded scene, never deleted here
     std::string texturePath;
 
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
 
+    // Pooled objects (see ObjectPool) and objects loaded by SceneManager::applySceneData share
+    // a template's mesh and texture and leave vertices/indices empty; read the mesh through
+    // meshVertices()/meshIndices().
+    int prefab;                 // -1 if not pooled
+    const Object* meshSource;
+    const std::vector<Vertex>& meshVertices() const { return meshSource ? meshSource->vertices : vertices; }
+    const std::vector<unsigned int>& meshIndices() const { return meshSource ? meshSource->indices : indices; }
+
     Object();
     void initCube(float size);
     void initCylinder(float radius, float height, int segments);
@@ -31,11 +56,56 @@ public:
     void initPyramid(float size, float height);
 
     void setupMesh();
-    Mat4 getModelMatrix() const;
 
+    // Keeps the local transform, so the object moves with its new parent. Refuses cycles.
+    bool setParent(Object* newParent);
+    void markDirty() { transformDirty = true; queueTransform(); }
+
+    // Set by SceneManager while the object is in its scene. markDirty and setParent (and
+    // setupMesh/uploadTexture, for the draw handles) queue the object there once, so
+    // SceneManager::updateTransforms visits only queued and non-static objects and an
+    // unchanged static object costs nothing per frame.
+    std::vector<Object*>* transformQueue;
+    int transformQueueIndex;    // slot in *transformQueue, -1 if not queued
+    int dynamicIndex;           // slot in SceneManager's list of non-static objects, -1 if none
+
+    // Brings the cached matrices up to date; returns true if the world matrix changed.
+    // SceneManager::updateTransforms calls this top-down once per frame, passing
+    // parentCurrent so parents are not re-checked for every child.
+    bool refreshTransform(bool parentCurrent = false) const;
+    // World matrix (parent chain included), cached.
+    const Mat4& getModelMatrix() const;
+    const Mat4& getLocalMatrix() const;
+    const Mat4& getInverseModelMatrix() const;
+    Quat getOrientation() const { return Quat::fromEulerDegrees(rotation); }
+    // Bumped whenever the world matrix changes.
+    unsigned int transformVersion() const { return worldVersion; }
+
+    // Decodes and uploads in one go. uploadTexture only does the GL part, for callers that
+    // decoded the image elsewhere (e.g. on a loader thread).
     void texture(const std::string& path);
+    void uploadTexture(const std::string& path, const unsigned char* pixels, int width, int height, int channels);
+    // The GL part of uploadTexture: a new mipmapped texture holding the pixels.
+    static GLuint createTexture(const unsigned char* pixels, int width, int height, int channels);
     void draw() const;
     float boundingRadius() const;
+
+private:
+    void queueTransform() {
+        if (transformQueue && transformQueueIndex < 0) {
+            transformQueueIndex = (int)transformQueue->size();
+            transformQueue->push_back(this);
+        }
+    }
+
+    mutable Mat4 localMatrix;
+    mutable Mat4 worldMatrix;
+    mutable Mat4 inverseWorldMatrix;
+    mutable float cachedTRS[9];         // position, rotation, scale behind localMatrix
+    mutable unsigned int worldVersion;
+    mutable unsigned int parentVersionSeen;
+    mutable bool transformDirty;
+    mutable bool inverseDirty;
 };
 
 #endif
@@ -8,6 +8,9 @@
 #include <stb_image.h>
 
 #include <iostream>
+#include <string>
+
+#include "Engine/util/stringTable.hpp"
 
 #include "math/math.hpp"
 
@@ -34,6 +37,15 @@ public:
     static void createPyramid(float size, float height, std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices);
     static void createSphere(float radius, int segments, int rings, std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices);
 
+    // Builds the default mesh for a scene object type ("Cube", "Sphere", ...; unknown types get a cube).
+    // Returns the canonical type name. GL-free, safe to call from worker threads.
+    static const char* createPrimitive(const std::string& type, std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices);
+    // Same, keyed by the interned type name (see primitiveType); returns the interned canonical type.
+    static StringId createPrimitive(StringId type, std::vector<Vertex>& outVertices, std::vector<unsigned int>& outIndices);
+
+    // Interned canonical type for a type name; unknown names map to "Cube".
+    static StringId primitiveType(const std::string& type);
+
     unsigned int loadTexture(const char* path);
 };
 
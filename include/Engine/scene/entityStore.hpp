@@ -0,0 +1,91 @@
+#ifndef ENTITYSTORE_HPP
+#define ENTITYSTORE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "glad/glad.h"
+
+#include "math/math.hpp"
+using namespace NMATH;
+
+class Object;
+
+// Generational handle to an entity. A handle stays valid until its entity is destroyed;
+// the slot's generation moves on at that point, so a stale handle never aliases a newer one.
+struct EntityHandle {
+    static const uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    uint32_t index;
+    uint32_t generation;
+
+    EntityHandle() : index(INVALID_INDEX), generation(0) {}
+    EntityHandle(uint32_t i, uint32_t g) : index(i), generation(g) {}
+
+    bool operator==(const EntityHandle& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const EntityHandle& o) const { return !(*this == o); }
+};
+
+// Dense structure-of-arrays copy of the state the per-frame loops need: world matrices,
+// bounding spheres and draw handles. Entity i sits at index i of every public array, so
+// render, shadow and picking passes are linear scans with no pointer chasing.
+//
+// Object stays the editable facade. Changes are pushed in per object: SceneManager refreshes
+// an entity when updateTransforms visits its object (queued by markDirty/setParent, or
+// non-static), so nothing walks the whole object list per frame.
+class EntityStore {
+public:
+    EntityStore();
+
+    EntityHandle create(Object* owner);
+    // Preallocates room for 'count' entities so create() does not reallocate.
+    void reserve(size_t count);
+    // Swap-removes the entity; the last entity moves into its place.
+    void destroy(EntityHandle handle);
+    void clear();
+
+    bool valid(EntityHandle handle) const;
+    Object* object(EntityHandle handle) const;
+    // Dense index of a valid handle.
+    size_t indexOf(EntityHandle handle) const { return slotToDense[handle.index]; }
+    size_t size() const { return owners.size(); }
+    Object* owner(size_t i) const { return owners[i]; }
+    // Slot index of entity i, stable for as long as the entity lives (unlike the dense index).
+    uint32_t slotOf(size_t i) const { return denseToSlot[i]; }
+    // Handle of whatever currently lives in 'slot', or an invalid handle if the slot is free.
+    EntityHandle slotHandle(uint32_t slot) const;
+
+    // Copies the owner's draw handles into its entity, and its world matrix and bounds if its
+    // transform version moved. Stale handles are ignored. Different entities may be refreshed
+    // from several threads at once.
+    void refresh(EntityHandle handle);
+    // Owner's transformVersion() when entity i was last refreshed.
+    unsigned int version(size_t i) const { return versions[i]; }
+
+    // Recreates every entity from 'objects', in vector order, for when objects were dropped
+    // from the scene's vector directly. The new entities are refreshed on their next refresh().
+    void rebuild(const std::vector<Object*>& objects);
+
+    std::vector<Mat4> world;
+    std::vector<float> boundsX;         // bounding sphere centre, world space
+    std::vector<float> boundsY;
+    std::vector<float> boundsZ;
+    std::vector<float> boundsRadius;
+    std::vector<GLuint> vaos;
+    std::vector<GLsizei> indexCounts;
+    std::vector<GLuint> textures;
+    std::vector<Object*> owners;
+
+private:
+    void refresh(size_t i);
+
+    std::vector<unsigned int> versions; // owner's transformVersion() at last refresh
+    std::vector<float> localRadius;     // mesh radius before scaling
+    std::vector<uint32_t> denseToSlot;
+
+    std::vector<uint32_t> slotToDense;
+    std::vector<uint32_t> slotGeneration;
+    std::vector<uint32_t> freeSlots;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef IDPICKER_HPP
+#define IDPICKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glad/glad.h"
+
+// GPU picking through an ID buffer. When a pick is requested, the next frame renders every
+// pickable thing with its 32-bit ID into an R32UI attachment of the viewport FBO. A small
+// region around the cursor is then copied into a pixel pack buffer, guarded by a fence, and
+// picked up by poll() once the GPU is done, usually a frame or two later. Nothing on the CPU
+// waits for the GPU, and the cost doesn't depend on how many triangles the meshes have.
+//
+// IDs are (kind << 30) | payload. 0 means nothing was drawn there.
+class IdPicker {
+public:
+    enum Kind { NONE = 0, OBJECT = 1, LIGHT = 2, GIZMO_AXIS = 3 };
+    static const uint32_t PAYLOAD_MASK = 0x3FFFFFFFu;
+
+    static uint32_t encode(Kind kind, uint32_t payload) { return ((uint32_t)kind << 30) | (payload & PAYLOAD_MASK); }
+    static Kind kindOf(uint32_t id) { return (Kind)(id >> 30); }
+    static uint32_t payloadOf(uint32_t id) { return id & PAYLOAD_MASK; }
+
+    // What the caller asked for; returned with the result so clicks and hovers can share one picker.
+    enum Purpose { CLICK, HOVER, MARQUEE };
+
+    struct Result {
+        Purpose purpose;
+        int x, y, width, height;        // region read, in ID-buffer pixels (origin bottom-left)
+        int centerX, centerY;           // requested pixel
+        std::vector<uint32_t> ids;      // width * height, row by row from the bottom
+
+        // ID at the requested pixel, or the closest non-zero one in the region.
+        uint32_t nearest() const;
+        // Every distinct non-zero ID in the region.
+        void unique(std::vector<uint32_t>& out) const;
+    };
+
+    IdPicker();
+
+    // Loads the ID shader and creates the buffers. Returns false if they are not available,
+    // in which case callers should keep picking on the CPU.
+    bool init();
+    bool ready() const { return program != 0; }
+    // Frees the GL objects; call while the context is still current.
+    void shutdown();
+
+    // (Re)allocates the R32UI texture and attaches it to 'fbo' as GL_COLOR_ATTACHMENT1.
+    void resize(GLuint fbo, int width, int height);
+
+    // u, v in [0, 1] across the viewport, v up. A new request replaces a queued one with the same
+    // purpose; clicks are served before hovers.
+    void requestPoint(Purpose purpose, float u, float v, int radius = 2);
+    void requestRect(Purpose purpose, float u0, float v0, float u1, float v1);
+
+    // True when a request is queued and a readback buffer is free; render the ID pass then.
+    bool wantsPass() const;
+
+    // Bracket the ID pass. begin() binds 'fbo' with only the ID attachment enabled, clears it and
+    // binds the ID program (model/view/projection uniforms, see setId). end() starts the readback
+    // and restores GL_COLOR_ATTACHMENT0 as the draw buffer.
+    GLuint beginPass(GLuint fbo);
+    void setId(uint32_t id);
+    void endPass();
+
+    // Pops the oldest finished readback. Never blocks.
+    bool poll(Result& out);
+
+    // One vertex at the origin, for drawing point-like things (lights) as GL_POINTS.
+    GLuint pointVAO() const { return pointVao; }
+
+private:
+    struct Request {
+        bool queued;
+        int x, y, width, height;
+        int centerX, centerY;
+    };
+
+    struct Readback {
+        GLuint pbo;
+        size_t capacity;        // bytes
+        GLsync fence;
+        Purpose purpose;
+        Request region;
+    };
+
+    void queue(Purpose purpose, int x0, int y0, int x1, int y1, int cx, int cy);
+
+    static const int READBACKS = 2;
+
+    GLuint program;
+    GLint idLoc;
+    GLuint texture;
+    GLuint pointVao, pointVbo;
+    int width, height;
+
+    Request queued[3];          // indexed by Purpose
+    Readback readbacks[READBACKS];
+    int readHead, readCount;    // FIFO of readbacks in flight
+    int passPurpose;            // request being rendered between beginPass/endPass
+    GLint prevFbo;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef OBJECTINDEX_HPP
+#define OBJECTINDEX_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/scene/entityStore.hpp"
+#include "Engine/util/stringTable.hpp"
+
+// Name and tag lookup for scene objects: interned name -> handles, tag bit -> handles.
+// Queries cost the number of matches, not the scene size.
+//
+// Removal is lazy so despawning stays O(1): the entry is left in place and skipped (and
+// eventually compacted away) once its handle no longer resolves in the entity store.
+class ObjectIndex {
+public:
+    static const int MAX_TAGS = 32;
+
+    explicit ObjectIndex(const EntityStore& entities);
+
+    void add(EntityHandle handle, StringId name, uint32_t tags);
+    // Call after the entity has been destroyed.
+    void remove(StringId name, uint32_t tags);
+    void rename(EntityHandle handle, StringId oldName, StringId newName);
+    void retag(EntityHandle handle, uint32_t oldTags, uint32_t newTags);
+    void clear();
+    // Room for 'count' more objects with this name, e.g. before spawning pooled instances.
+    void reserveName(StringId name, size_t count);
+
+    // Invalid handle if nothing by that name is alive.
+    EntityHandle findFirst(StringId name);
+    void findAll(StringId name, std::vector<EntityHandle>& out);
+    // Objects carrying every bit of mask.
+    void findTagged(uint32_t mask, std::vector<EntityHandle>& out);
+
+private:
+    struct Bucket {
+        std::vector<EntityHandle> handles;
+        size_t stale;                   // entries whose object is gone, not yet compacted
+        Bucket() : stale(0) {}
+    };
+
+    void compact(Bucket& bucket);
+    void markStale(Bucket& bucket);
+    static void erase(Bucket& bucket, EntityHandle handle);
+
+    const EntityStore& entities;
+    std::unordered_map<StringId, Bucket> byName;
+    Bucket byTag[MAX_TAGS];
+};
+
+#endif
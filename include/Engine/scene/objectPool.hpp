@@ -0,0 +1,61 @@
+#ifndef OBJECTPOOL_HPP
+#define OBJECTPOOL_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Engine/util/stringTable.hpp"
+
+class Object;
+
+// Pooled objects for things spawned and despawned at runtime (projectiles, debris).
+//
+// A prefab's mesh and texture are built once, on a template object; every instance shares
+// its GL handles and mesh data instead of owning a copy. Instances come from preallocated
+// slabs and go back to their prefab's free list, so acquire/release do no heap or GL work
+// while the pool has room. SceneManager::spawnPrefab/removeObject drive this class.
+class ObjectPool {
+public:
+    typedef int PrefabId;
+    static const PrefabId INVALID_PREFAB = -1;
+
+    ObjectPool();
+    ~ObjectPool();
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Needs the GL context. Registering an existing name returns the existing prefab.
+    PrefabId registerPrefab(const std::string& name, const std::string& type, const std::string& texturePath);
+    PrefabId findPrefab(const std::string& name) const;
+
+    // Makes sure at least 'count' instances of the prefab are free.
+    void prewarm(PrefabId prefab, size_t count);
+
+    // A free instance with every per-instance field (transform, hierarchy, name, tags, texture)
+    // reset to the prefab's defaults. Allocates a new slab if none is free.
+    Object* acquire(PrefabId prefab);
+    // The object must have come from acquire() and already be out of the scene. It is detached
+    // from its parent and children.
+    void release(Object* obj);
+
+    size_t freeCount(PrefabId prefab) const;
+    StringId prefabName(PrefabId prefab) const;
+    size_t prefabCount() const { return prefabs.size(); }
+
+private:
+    struct Prefab {
+        StringId name;
+        Object* templ;                  // owns the mesh and texture; never in the scene
+        std::vector<Object*> freeList;
+        size_t capacity;                // instances allocated so far
+    };
+
+    void grow(Prefab& prefab, PrefabId id, size_t count);
+
+    std::vector<Prefab> prefabs;
+    std::vector<Object*> slabs;         // new Object[] blocks, deleted with the pool
+};
+
+#endif
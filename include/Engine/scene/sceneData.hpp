@@ -0,0 +1,82 @@
+#ifndef SCENEDATA_HPP
+#define SCENEDATA_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "Engine/lighting/light.hpp"
+
+#include "math/math.hpp"
+using namespace NMATH;
+
+// Plain, GL-free description of a scene. Every scene format (JSON, binary) is read into
+// and written from this, so conversions between formats are lossless by construction.
+//
+// Objects and lights are stored as structure-of-arrays: vector attributes are packed as
+// 3 floats per element, strings are offsets into a single null-terminated string table.
+class SceneData {
+public:
+    // Offset 0 in the string table is always the empty string.
+    static const uint32_t EMPTY_STRING = 0;
+
+    SceneData();
+
+    // objects
+    std::vector<float> positions;       // 3 per object
+    std::vector<float> rotations;       // 3 per object, Euler degrees
+    std::vector<float> scales;          // 3 per object
+    std::vector<uint32_t> names;        // string table offsets
+    std::vector<uint32_t> types;
+    std::vector<uint32_t> texturePaths;
+
+    // lights
+    std::vector<uint32_t> lightTypes;   // LightType as integer
+    std::vector<float> lightPositions;  // 3 per light
+    std::vector<float> lightDirections; // 3 per light
+    std::vector<float> lightColors;     // 3 per light
+    std::vector<float> lightIntensities;
+
+    std::vector<char> strings;
+
+    size_t objectCount() const { return names.size(); }
+    size_t lightCount() const { return lightTypes.size(); }
+
+    void clear();
+    void reserve(size_t objectCount, size_t lightCount, size_t stringBytes);
+
+    // Appends a string to the table and returns its offset.
+    uint32_t addString(const char* s, size_t len);
+    uint32_t addString(const std::string& s) { return addString(s.c_str(), s.size()); }
+    // Like addString, but reuses an existing entry added through this call (types, texture paths).
+    uint32_t addSharedString(const std::string& s);
+
+    const char* str(uint32_t offset) const { return &strings[offset]; }
+
+    void addObject(uint32_t name, uint32_t type, uint32_t texturePath,
+                   const Vec3d& position, const Vec3d& rotation, const Vec3d& scale);
+    void addLight(LightType type, const Vec3d& position, const Vec3d& direction,
+                  const Vec3d& color, float intensity);
+
+    Vec3d position(size_t i) const { return read3(positions, i); }
+    Vec3d rotation(size_t i) const { return read3(rotations, i); }
+    Vec3d scale(size_t i) const { return read3(scales, i); }
+
+    LightType lightType(size_t i) const { return (LightType)lightTypes[i]; }
+    Vec3d lightPosition(size_t i) const { return read3(lightPositions, i); }
+    Vec3d lightDirection(size_t i) const { return read3(lightDirections, i); }
+    Vec3d lightColor(size_t i) const { return read3(lightColors, i); }
+
+private:
+    static Vec3d read3(const std::vector<float>& v, size_t i) {
+        return Vec3d(v[i * 3 + 0], v[i * 3 + 1], v[i * 3 + 2]);
+    }
+    static void push3(std::vector<float>& v, const Vec3d& p) {
+        v.push_back(p.x); v.push_back(p.y); v.push_back(p.z);
+    }
+
+    std::unordered_map<std::string, uint32_t> sharedStrings;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef SCENEGENERATOR_HPP
+#define SCENEGENERATOR_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Engine/scene/sceneData.hpp"
+
+// What SceneGenerator builds. Defaults give a small textured scene with one sun.
+struct SceneGenSettings {
+    enum Distribution { UNIFORM, CLUSTERED, GRID };
+
+    // objects per primitive type
+    size_t cubes = 200;
+    size_t spheres = 200;
+    size_t cylinders = 200;
+    size_t pyramids = 200;
+    size_t planes = 0;
+
+    // Textures are picked from the first textureVariety entries of 'textures'; an object is
+    // textured with probability texturedFraction.
+    std::vector<std::string> textures;
+    size_t textureVariety = 3;
+    float texturedFraction = 0.5f;
+
+    size_t directionalLights = 1;
+    size_t pointLights = 4;
+
+    Distribution distribution = UNIFORM;
+    float extent = 0.0f;            // half-width of the square area; 0 picks one from the count
+    size_t clusters = 16;           // CLUSTERED only
+    float clusterRadius = 0.0f;     // CLUSTERED only; 0 picks one from the extent
+    bool ground = true;             // a plane under everything, not counted above
+
+    uint32_t seed = 1;
+
+    SceneGenSettings();
+
+    // Splits 'total' evenly over cubes, spheres, cylinders and pyramids.
+    SceneGenSettings& setObjectCount(size_t total);
+    size_t objectCount() const { return cubes + spheres + cylinders + pyramids + planes; }
+
+    static bool parseDistribution(const std::string& name, Distribution& out);
+    static const char* distributionName(Distribution d);
+};
+
+// Procedural stress scenes for scaling tests. GL-free: the result is a SceneData, which
+// SceneSerializer writes as .gscene/.gsceneb and SceneManager::applySceneData loads. The
+// same settings and seed give the same scene on every platform.
+class SceneGenerator {
+public:
+    static void generate(const SceneGenSettings& settings, SceneData& out);
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef SCENEJSONREADER_HPP
+#define SCENEJSONREADER_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "Engine/scene/sceneData.hpp"
+
+// Streaming reader for .gscene JSON. Walks the text once with a schema-aware tokenizer and
+// writes object/light records straight into SceneData; no DOM is built. Strings are decoded
+// into one reused scratch buffer and then appended to SceneData's string table.
+//
+// Unknown keys are skipped. Errors are reported with the byte offset they were found at.
+class SceneJsonReader {
+public:
+    SceneJsonReader();
+
+    bool read(const char* text, size_t size, SceneData& out);
+
+    const std::string& error() const { return errorMessage; }
+    size_t errorOffset() const { return errorPos; }
+    // 1-based line of errorOffset(), computed on demand.
+    size_t errorLine() const;
+
+private:
+    bool parseScene();
+    bool parseObjects();
+    bool parseLights();
+    bool parseObjectRecord();
+    bool parseLightRecord();
+
+    bool parseString(std::string& out);
+    bool parseNumber(float& out);
+    bool parseVec3(Vec3d& out);
+    bool skipValue(int depth = 0);
+    bool skipLiteral(const char* literal);
+
+    void skipWhitespace();
+    bool expect(char c);
+    bool peek(char c);
+    bool fail(const char* message);
+
+    const char* text;
+    size_t size;
+    size_t pos;
+    SceneData* data;
+
+    std::string scratch;
+    std::string key;
+
+    std::string errorMessage;
+    size_t errorPos;
+};
+
+#endif
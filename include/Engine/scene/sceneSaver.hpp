@@ -0,0 +1,84 @@
+#ifndef SCENESAVER_HPP
+#define SCENESAVER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/scene/sceneData.hpp"
+
+// Writes scenes on a background thread. Callers take a SceneData snapshot on the main
+// thread and hand it over; serialization and disk I/O run on the saver's own thread, in
+// request order, so the editor never waits on the disk.
+//
+// Autosaves go to a journal: a text file of one JSON record per line. The first autosave of
+// a session writes every object, later ones only append records for objects that changed,
+// were added or were removed since the previous autosave. The journal is compacted (rewritten
+// in full) once the appended records outnumber the objects in the scene.
+class SceneSaver {
+public:
+    SceneSaver();
+    ~SceneSaver(); // finishes everything still queued
+
+    SceneSaver(const SceneSaver&) = delete;
+    SceneSaver& operator=(const SceneSaver&) = delete;
+
+    // Full save, see SceneSerializer::save. 'snapshot' is moved from.
+    void save(const std::string& path, SceneData& snapshot);
+
+    // Incremental save to the journal at 'path'. ids[i] identifies snapshot object i across
+    // autosaves; both arguments are moved from. A queued autosave that has not started yet is
+    // replaced by the newer one.
+    void autosave(const std::string& path, SceneData& snapshot, std::vector<uint32_t>& ids);
+
+    bool busy() const;
+    void wait();
+
+    // Outcome of the most recently finished request.
+    bool lastSucceeded() const;
+    // When the most recent full save finished writing, successful or not.
+    std::chrono::steady_clock::time_point lastSaveFinished() const;
+
+    // Rebuilds the scene recorded in an autosave journal.
+    static bool loadJournal(const std::string& path, SceneData& out);
+
+private:
+    struct Request {
+        std::string path;
+        bool incremental;
+        SceneData data;
+        std::vector<uint32_t> ids;
+    };
+
+    // Last autosave written to a journal, diffed against by the next one.
+    struct JournalState {
+        SceneData data;
+        std::unordered_map<uint32_t, uint32_t> indexOfId;
+        size_t appendedRecords;
+    };
+
+    void enqueue(Request& request);
+    void workerLoop();
+    bool writeJournal(Request& request);
+
+    std::thread worker;
+    std::deque<Request> queue;
+    mutable std::mutex mutex;
+    std::condition_variable requestAvailable;
+    std::condition_variable idle;
+    bool writing;
+    bool stopping;
+    bool lastOk;
+    std::chrono::steady_clock::time_point lastSaveEnd;
+
+    // only touched by the worker thread
+    std::unordered_map<std::string, JournalState> journals;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef SCENESERIALIZER_HPP
+#define SCENESERIALIZER_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "Engine/scene/sceneData.hpp"
+
+// Binary scene format (.gsceneb), version 1. Little-endian, every section 16-byte aligned:
+//
+//   SceneBinaryHeader
+//   object positions/rotations/scales   float[3 * objectCount] each
+//   object name/type/texture            uint32[objectCount] each, string table offsets
+//   light types                         uint32[lightCount]
+//   light positions/directions/colors   float[3 * lightCount] each
+//   light intensities                   float[lightCount]
+//   string table                        char[stringBytes], null-terminated strings
+//
+// Loading maps the file and bulk-copies each section; nothing is parsed per field.
+struct SceneBinaryHeader {
+    enum Section {
+        OBJ_POSITIONS, OBJ_ROTATIONS, OBJ_SCALES,
+        OBJ_NAMES, OBJ_TYPES, OBJ_TEXTURES,
+        LIGHT_TYPES, LIGHT_POSITIONS, LIGHT_DIRECTIONS, LIGHT_COLORS, LIGHT_INTENSITIES,
+        STRINGS,
+        SECTION_COUNT
+    };
+
+    static const uint32_t VERSION = 1;
+
+    char magic[4];          // "GSCB"
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t flags;
+    uint32_t objectCount;
+    uint32_t lightCount;
+    uint32_t stringBytes;
+    uint32_t reserved;
+    uint64_t sectionOffsets[SECTION_COUNT];
+    uint64_t sectionSizes[SECTION_COUNT];
+};
+
+class SceneSerializer {
+public:
+    // Format is chosen by sniffing the file contents (binary magic vs JSON).
+    static bool load(const std::string& path, SceneData& out);
+    // Format is chosen by extension: ".gsceneb" writes binary, anything else writes JSON.
+    // The file is replaced atomically (written to "<path>.tmp", then renamed).
+    static bool save(const std::string& path, const SceneData& data);
+    // Lossless conversion between any two supported formats.
+    static bool convert(const std::string& srcPath, const std::string& dstPath);
+
+    static bool isBinaryPath(const std::string& path);
+    // Renames 'from' over 'to', replacing it if it exists.
+    static bool replaceFile(const std::string& from, const std::string& to);
+
+    static bool readJson(const std::string& path, SceneData& out);
+    static bool writeJson(const std::string& path, const SceneData& data);
+
+    static bool readBinary(const std::string& path, SceneData& out);
+    static bool readBinary(const unsigned char* bytes, size_t size, SceneData& out);
+    static bool writeBinary(const std::string& path, const SceneData& data);
+};
+
+#endif
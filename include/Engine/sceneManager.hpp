@@ -4,12 +4,22 @@
 #include "Engine/objects/object.hpp"
 #include "Engine/lighting/light.hpp"
 #include "Engine/lighting/shadow.hpp"
+#include "Engine/lighting/pointShadow.hpp"
 #include "Engine/gizmos/transformTool.hpp"
+#include "Engine/scene/sceneData.hpp"
+#include "Engine/scene/objectIndex.hpp"
+#include "Engine/scene/objectPool.hpp"
+#include "Engine/scene/idPicker.hpp"
+#include "Engine/scene/sceneSaver.hpp"
+#include "Engine/scene/sceneGenerator.hpp"
+#include "Engine/util/fileWatcher.hpp"
 
 #include "glad/glad.h"
 #include "nlohmann/json.hpp"
 
 #include <cfloat>
+#include <chrono>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -38,16 +48,46 @@ struct GizmoAxis {
     Vec3d initialObjPos = Vec3d(0.0f);
 };
 
+// Progress reports while a scene loads; always called on the thread that owns the GL context.
+// progress goes from 0 to 1 across all stages ("Parsing", "Decoding", "Uploading", "Done").
+typedef std::function<void(const char* stage, float progress)> SceneLoadProgress;
+
+// Generational reference to a scene object. Unlike an Object*, a handle is safe to keep after
+// the object is removed or the scene is cleared: SceneManager::get() then returns null.
+typedef EntityHandle ObjectHandle;
+
 class SceneManager {
 public:
     SceneManager();
+    // Frees the objects, shadow maps and depth programs.
+    ~SceneManager();
+
+    SceneManager(const SceneManager&) = delete;
+    SceneManager& operator=(const SceneManager&) = delete;
+
+    // Appending here directly is supported for older code. Entries dropped or replaced directly
+    // are only noticed by the next render or pickObject, and until then their handles still
+    // resolve to the old objects; use removeObject.
     std::vector<Object*> objects;
+    // Dense per-frame copy of the objects' transforms, bounds and draw handles.
+    EntityStore entities;
     std::vector<Light> lights;
-    std::vector<Shadow*> lightShadows;
+    std::vector<Shadow*> lightShadows;      // per light; null for point lights, see pointShadows
 
     GLuint shadowDepthProgram = 0;
+    GLuint pointShadowDepthProgram = 0;
+    GLuint shadowDepthPending = 0;          // resubmitted by onAssetChanged, swapped in by render
+    GLuint pointShadowDepthPending = 0;
 
     static const int MAX_DIR_SHADOWS = 4;
+    static const int MAX_POINT_SHADOWS = 4; // MAX_POINT_LIGHTS in shaders/fragment.glsl
+
+    // Point-light shadow budget. Each frame the on-screen point lights are ranked by intensity
+    // over squared distance to the camera; the first pointShadowBudget get a cube map, and at
+    // most pointShadowFaceBudget cube faces are re-rendered in that order. A moving light keeps
+    // its last complete map until the next one is built (see PointShadow).
+    int pointShadowBudget = 2;
+    int pointShadowFaceBudget = 12;
 
     Object* selectedObject;
     
@@ -63,40 +103,154 @@ public:
     // Width in pixels for gizmo axis lines
     float gizmoLineWidth;
 
+    // Shadow filtering kernel for every directional shadow map.
+    Shadow::Quality shadowQuality = Shadow::POISSON_4;
+
     GLuint axisVAO, axisVBO;
-    GLuint lightVAO, lightVBO;
     int selectedLightIndex;
 
-    int objCounter;
+    int objCounter;             // last object id handed out
 
     void clearScene();
 
     void initLightGizmo();
     void drawGizmo(GLuint shaderProgram, const Mat4& view, const Mat4& projection);
     bool pickGizmoAxis(const Vec3d& rayOrigin, const Vec3d& rayDir, GizmoAxis& outAxis);
+    // Grabs a known axis of the selected object's gizmo at the point the ray passes closest to.
+    bool grabGizmoAxis(int axisIndex, const Vec3d& rayOrigin, const Vec3d& rayDir, GizmoAxis& outAxis);
     bool pickLight(const Vec3d& rayOrigin, const Vec3d& rayDir, int& outIndex, float radius = 0.5f);
     void dragSelectedObject(const Vec3d& rayOrigin, const Vec3d& rayDir);
 
     Object* addObject(const std::string& type, const std::string& name);
+    ObjectHandle spawnObject(const std::string& type, const std::string& name);
+    ObjectHandle handleOf(Object* obj);
+    Object* get(ObjectHandle handle) const { return entities.object(handle); }
+    bool isAlive(ObjectHandle handle) const { return entities.valid(handle); }
+    // O(1): the last object is swapped into the removed one's place in 'objects'.
+    // Pooled objects go back to their pool instead of being deleted.
     void removeObject(Object* objPtr);
+    void removeObject(ObjectHandle handle);
+
+    // Pooled spawning for short-lived objects, see ObjectPool. With enough instances
+    // prewarmed, spawnPrefab and removeObject do no heap allocation and no GL calls.
+    ObjectPool::PrefabId registerPrefab(const std::string& name, const std::string& type,
+                                        const std::string& texturePath = "", size_t prewarmCount = 0);
+    ObjectPool::PrefabId findPrefab(const std::string& name) const { return pool.findPrefab(name); }
+    void prewarmPrefab(ObjectPool::PrefabId prefab, size_t count);
+    ObjectHandle spawnPrefab(ObjectPool::PrefabId prefab, const Vec3d& position, const Vec3d& rotation = Vec3d(0.0f));
+    void despawn(ObjectHandle handle) { removeObject(handle); }
+
+    // Name and tag lookups go through an index, so they do not scan the scene.
+    void renameObject(Object* obj, const std::string& name);
+    ObjectHandle findByName(const std::string& name);
+    void findAllByName(const std::string& name, std::vector<ObjectHandle>& out);
+    // Bit for a tag name, registered on first use; 0 once all ObjectIndex::MAX_TAGS are taken.
+    uint32_t tagMask(const std::string& tag);
+    void setTags(Object* obj, uint32_t tags);
+    void addTag(Object* obj, const std::string& tag) { setTags(obj, obj->tags | tagMask(tag)); }
+    void removeTag(Object* obj, const std::string& tag) { setTags(obj, obj->tags & ~tagMask(tag)); }
+    void findByTag(const std::string& tag, std::vector<ObjectHandle>& out);
+    // Objects carrying every tag in mask.
+    void findByTags(uint32_t mask, std::vector<ObjectHandle>& out) { objectIndex.findTagged(mask, out); }
     void removeLight(int index);
     void addLight(const Light& light);
 
     void update(float deltaTime);
+    // Refreshes cached object matrices, parents before children (see Object::refreshTransform).
+    // Visits the objects queued by markDirty/setParent and the non-static ones, with their
+    // subtrees; other static objects are not touched.
+    void updateTransforms();
     void render(GLuint shaderProgram, const Mat4& view, const Mat4& projection);
     Object* pickObject(const Vec3d& rayOrigin, const Vec3d& rayDir);
 
+    // GPU picking, see IdPicker. renderIds draws objects, lights and the selected object's gizmo
+    // with their IDs; run it after render() so the entity store is current. applyPick makes the
+    // same selection the CPU path would for a click that hit 'id' (0 clears the selection).
+    void renderIds(IdPicker& picker, GLuint fbo, const Mat4& view, const Mat4& projection);
+    void applyPick(uint32_t id, const Vec3d& rayOrigin, const Vec3d& rayDir);
+    Object* objectFromPickId(uint32_t id) const;
+    // Hover feedback: the hovered object gets a wire box in render().
+    void setHovered(uint32_t id);
+    ObjectHandle hoveredObject;
+    int hoveredLightIndex;
+
     GLuint getActiveProgram() const { return lastActiveProgram; }
 
-    void initGrid(int gridSize = 20, float spacing = 1.0f);
-    void drawGrid(GLuint shaderProgram, const Mat4& view, const Mat4& projection);
+    // Infinite ground grid drawn by its own shader as one full-screen pass; spacing is the
+    // finest cell size, coarser levels take over as cells shrink on screen.
+    void initGrid(float spacing = 1.0f);
+    void drawGrid(const Mat4& view, const Mat4& projection);
 
+    // Scene files: JSON (.gscene) or binary (.gsceneb), see SceneSerializer.
     void saveScene(const std::string& path);
-    void loadScene(const std::string& path);
+    // Snapshot on this thread, serialize and write on the saver thread.
+    void saveSceneAsync(const std::string& path);
+    // Appends only what changed since the last autosave to a journal, see SceneSaver.
+    void autosaveScene(const std::string& journalPath);
+    bool recoverAutosave(const std::string& journalPath);
+    bool isSaving() const { return saver.busy(); }
+    void loadScene(const std::string& path, const SceneLoadProgress& progress = SceneLoadProgress());
+
+    // Hot reload, fed from a FileWatcher on the GL thread. Shaders resubmit the unlit program,
+    // textures are re-uploaded into the objects that use them, and the scene file last loaded
+    // with loadScene is reloaded unless this process just saved it.
+    void onAssetChanged(const FileWatcher::Change& change);
+    const std::string& getLoadedScenePath() const { return loadedScenePath; }
+
+    // Replaces the scene with a procedural one, see SceneGenerator.
+    void generateScene(const SceneGenSettings& settings, const SceneLoadProgress& progress = SceneLoadProgress());
+
+    // GL-free snapshot of the scene / rebuild the scene from one.
+    void buildSceneData(SceneData& out) const;
+    void applySceneData(const SceneData& data, const SceneLoadProgress& progress = SceneLoadProgress());
 
 private:
-    GLuint gridVAO = 0, gridVBO = 0;
-    int gridVertexCount = 0;
+    // Gives objects pushed into 'objects' directly their entity, keeping objects[i] and
+    // entity i the same object. Entries dropped directly are caught when the vector shrinks;
+    // checkSlots (once per frame) compares every slot and also catches replaced entries.
+    void registerPendingObjects(bool checkSlots = false);
+    // Entity, transform queue and non-static list membership of an object entering or leaving
+    // the scene.
+    void attachObject(Object* obj);
+    void detachObject(Object* obj);
+    void setDynamic(Object* obj, bool dynamic);
+    void indexObject(Object* obj);
+    void queueLightGizmos(float pointSize, float selectedPointSize);
+    void reloadTexture(const std::string& path);
+    // Picks the shadowed point lights, refreshes their cube maps and binds them from texBase on.
+    void updatePointShadows(GLuint activeProgram, const float* cameraPlanes, const Vec3d& cameraPos, int texBase);
+
+    ObjectIndex objectIndex;
+    ObjectPool pool;
+    // One mesh template per object type and one texture per path of the last applySceneData,
+    // shared by the objects it created (Object::meshSource, sharedTexture). Freed by clearScene.
+    std::vector<Object*> sceneMeshes;
+    std::vector<GLuint> sceneTextures;
+    std::vector<StringId> tagNames;         // tagNames[bit]
+
+    SceneSaver saver;
+    std::string loadedScenePath;            // normalized, for onAssetChanged
+    std::chrono::steady_clock::time_point lastOwnSave;      // when our last save finished writing
+
+    std::vector<Object*> transformQueue;    // changed since the last updateTransforms, see Object::markDirty
+    std::vector<Object*> dynamicObjects;    // non-static objects, change-detected every frame
+    std::vector<Object*> transformRoots;    // scratch for updateTransforms
+    std::vector<Object*> transformStack;
+    std::vector<std::vector<Object*> > transformJobStacks;   // one per pool job
+    std::vector<uint8_t> cullVisible;       // per-entity frustum test result, scratch for depth passes
+    std::vector<uint8_t> cameraVisible;     // same for the camera, kept for the rest of the frame
+
+    PointShadow* pointShadows[MAX_POINT_SHADOWS] = {};     // created on first use, freed by clearScene
+    int pointShadowOwner[MAX_POINT_SHADOWS] = { -1, -1, -1, -1 };  // light index each map holds
+    std::vector<std::pair<float, int> > pointShadowOrder;  // scratch: (importance, light index)
+
+    GLuint gridVAO = 0;                     // empty, the grid shader needs no vertex data
+    GLuint gridProgram = 0;
+    GLuint gridPending = 0;                 // resubmitted by onAssetChanged, swapped in by drawGrid
+    float gridSpacing = 1.0f;
+    GLint gridInvViewProjLoc = -1, gridViewProjLoc = -1, gridCameraLoc = -1;
+    GLint gridSpacingLoc = -1, gridFadeLoc = -1;
+    bool gridLocationsFetched = false;
     GLuint lastActiveProgram = 0;
 };
 
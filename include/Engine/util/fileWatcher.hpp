@@ -0,0 +1,79 @@
+#ifndef FILEWATCHER_HPP
+#define FILEWATCHER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Watches asset directories on a background thread and hands the main thread a list of files
+// that changed. On Linux this is inotify, so nothing runs until the kernel reports a write;
+// elsewhere (or if inotify is unavailable) the thread re-stats the watched trees twice a second.
+//
+// Editors and exporters often write a file in several steps (truncate, write, rename), so
+// events are coalesced: a path is reported once, after it has been quiet for a short while.
+// Only files whose extension maps to a Kind other than OTHER are reported.
+class FileWatcher {
+public:
+    enum Kind { SHADER, TEXTURE, SCENE, OTHER };
+
+    struct Change {
+        std::string path;       // normalized, see normalize()
+        Kind kind;
+    };
+
+    FileWatcher();
+    ~FileWatcher(); // stops the thread
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Watches 'dir' and everything below it, including directories created later. Can be
+    // called before or after start(); watching a directory twice is a no-op.
+    void watchDirectory(const std::string& dir);
+
+    void start();
+    void stop();
+    bool usingInotify() const { return inotifyFd >= 0; }
+
+    // Main thread: appends the changes that have settled since the last call. Never blocks on
+    // the watcher thread for longer than a queue swap.
+    void poll(std::vector<Change>& out);
+
+    static Kind kindOf(const std::string& path);
+    // Folds "./", "dir/../" and backslashes so paths from different sources compare equal.
+    static std::string normalize(const std::string& path);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    void workerLoop();
+    void addWatches(const std::string& dir);    // dir and its subdirectories; needs 'mutex'
+    void readInotify();
+    void scanForChanges();
+    void note(const std::string& path);         // needs 'mutex'
+    void settle();                              // needs 'mutex'
+
+    struct Snapshot {
+        long long mtime;
+        long long size;
+    };
+
+    int inotifyFd;
+    std::unordered_map<int, std::string> watchDirs;         // inotify wd -> directory
+    std::vector<std::string> roots;
+    std::unordered_map<std::string, Snapshot> snapshots;    // polling fallback, worker only
+    std::vector<std::string> scannedRoots;                  // same
+    std::unordered_map<std::string, Clock::time_point> unsettled;   // path -> last event
+    std::vector<Change> settled;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+    bool running;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef FRAMEARENA_HPP
+#define FRAMEARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Bump allocator for data that lives no longer than a frame. allocate() is a pointer bump;
+// nothing is freed individually, reset() drops everything at once.
+//
+// If a frame needs more than the capacity, the extra comes from the heap and is counted as
+// an overflow. The next reset() grows the arena to the frame's high-water mark, so overflows
+// stop once the working set is known.
+class FrameArena {
+public:
+    static const size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocate(size_t count) { return static_cast<T*>(allocate(count * sizeof(T), alignof(T))); }
+
+    void reset();
+
+    size_t used() const { return offset + overflowBytes; }
+    size_t capacity() const { return size; }
+    size_t overflowCount() const { return overflows.size(); }
+
+private:
+    char* base;
+    size_t size;
+    size_t offset;
+    size_t overflowBytes;
+    size_t highWater;
+    std::vector<void*> overflows;
+};
+
+// Two FrameArenas used in turn. Memory taken from current() during frame N stays valid until
+// the end of frame N+1, so data built on the game thread can be read by a render thread one
+// frame behind. Main thread only, apart from reading the previous frame's data.
+class FrameAllocator {
+public:
+    static FrameArena& current();
+    static FrameArena& previous();
+
+    // Call once per frame, after the last use of current(). Also closes the frame's
+    // heap allocation count, see FrameAllocationScope.
+    static void endFrame();
+
+    // Marks the current frame as one that allocates on purpose (loading, pool growth, shader
+    // reload) so the steady-state check skips it.
+    static void expectAllocations();
+
+    // Heap allocations counted by FrameAllocationScopes during the last completed frame.
+    static size_t lastFrameHeapAllocations();
+    static void addHeapAllocations(size_t count);
+
+    // Heap allocations made by the calling thread so far. Only counted in builds with
+    // GENGINE_TRACK_ALLOCATIONS, 0 otherwise.
+    static size_t threadHeapAllocations();
+    static bool trackingAllocations();
+
+    // Frames allowed to allocate before the steady-state check kicks in (caches warming up).
+    static const unsigned int WARMUP_FRAMES = 120;
+};
+
+// Counts the heap allocations the current thread makes during the scope towards the frame
+// total. With GENGINE_TRACK_ALLOCATIONS, a steady-state frame whose scopes allocated asserts
+// in FrameAllocator::endFrame. Wrap the per-frame engine work (update, render), not editor UI.
+class FrameAllocationScope {
+public:
+    FrameAllocationScope() : start(FrameAllocator::threadHeapAllocations()) {}
+    ~FrameAllocationScope() { FrameAllocator::addHeapAllocations(FrameAllocator::threadHeapAllocations() - start); }
+
+private:
+    size_t start;
+};
+
+// STL allocator over a FrameArena, e.g. std::vector<float, FrameStlAllocator<float> >.
+// deallocate is a no-op; containers using it must not outlive the arena's frame.
+template <typename T>
+class FrameStlAllocator {
+public:
+    typedef T value_type;
+
+    FrameStlAllocator() : arena(&FrameAllocator::current()) {}
+    explicit FrameStlAllocator(FrameArena& a) : arena(&a) {}
+    template <typename U>
+    FrameStlAllocator(const FrameStlAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return arena->allocate<T>(n); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const FrameStlAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const FrameStlAllocator<U>& other) const { return arena != other.arena; }
+
+    FrameArena* arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T> >;
+
+#endif
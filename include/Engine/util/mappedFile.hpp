@@ -0,0 +1,33 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file (mmap on POSIX, file mapping objects on Windows).
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return ptr != nullptr || (opened && length == 0); }
+    const unsigned char* data() const { return (const unsigned char*)ptr; }
+    size_t size() const { return length; }
+
+private:
+    void* ptr;
+    size_t length;
+    bool opened;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include "Engine/util/renderStats.hpp"
+
+#include <cstdint>
+#include <string>
+
+// Frame profiler: CPU scopes on the main thread, GPU pass timings from GL_TIME_ELAPSED
+// queries, an ImGui window to look at them and an optional Chrome trace file.
+//
+// CPU scopes nest and are recorded into fixed per-frame arrays, so profiling never allocates.
+// Scopes opened on other threads are ignored. GPU scopes do not nest (GL allows one
+// TIME_ELAPSED query at a time); one opened inside another is ignored too. Their queries are
+// read back GPU_LATENCY frames later, and only if the result is already there: a frame never
+// waits on the GPU, a late result is dropped instead.
+//
+// Scope names must outlive the profiler (string literals).
+class Profiler {
+public:
+    static const int MAX_SCOPES = 512;          // CPU scopes per frame, the rest are dropped
+    static const int MAX_GPU_SCOPES = 32;       // GPU scopes per frame
+    static const int GPU_LATENCY = 3;           // frames in flight before queries are read
+    static const int HISTORY = 240;             // frames kept for the frame-time graph
+
+    struct Scope {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+        int depth;
+    };
+
+    struct GpuScope {
+        const char* name;
+        uint64_t cpuStartNs;                    // when the pass was issued
+        uint64_t gpuNs;
+    };
+
+    struct Frame {
+        uint64_t index;
+        uint64_t startNs;
+        uint64_t endNs;
+        Scope scopes[MAX_SCOPES];
+        int scopeCount;
+        int droppedScopes;
+    };
+
+    // Main thread, around everything a frame does (including the buffer swap).
+    static void beginFrame();
+    static void endFrame();
+
+    static void setEnabled(bool enabled);
+    static bool enabled();
+
+    // Index into the current frame, -1 if nothing was recorded.
+    static int beginScope(const char* name);
+    static void endScope(int scope);
+    static int beginGpuScope(const char* name);
+    static void endGpuScope(int scope);
+
+    // Streams every frame's scopes to 'path' in Chrome trace event format (chrome://tracing,
+    // Perfetto) until stopTrace, which also runs at exit.
+    static bool startTrace(const std::string& path);
+    static void stopTrace();
+
+    // Last completed frame, and the GPU scopes of the last frame whose queries came back.
+    static const Frame& lastFrame();
+    static int lastGpuScopes(const GpuScope*& scopes);
+    static float frameMs(int framesAgo);        // CPU frame time, 0 past the history
+    static float gpuMs(int framesAgo);          // sum of the GPU scopes, 0 if not resolved
+
+    // Timeline and flame graph of the last frame plus the frame-time history.
+    static void drawWindow(bool* open);
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : index(Profiler::beginScope(name)) {}
+    ~ProfileScope() { Profiler::endScope(index); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    int index;
+};
+
+// One render pass: timed on the GPU and the RenderStats pass its GL calls are counted in.
+// A NULL name records nothing, for passes that are only timed some of the time. A scope the
+// profiler does not time (nested in another, or past the frame's query budget) opens no
+// RenderStats pass either, so its calls count towards the enclosing pass.
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name)
+        : index(name ? Profiler::beginGpuScope(name) : -1), pass(index >= 0 ? RenderStats::beginPass(name) : -1) {}
+    ~GpuProfileScope() { end(); }
+
+    // Closes the pass before the end of the enclosing block.
+    void end() {
+        Profiler::endGpuScope(index);
+        RenderStats::endPass(pass);
+        index = pass = -1;
+    }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    int index;
+    int pass;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope_, __LINE__)(name)
+
+#endif
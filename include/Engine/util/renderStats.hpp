@@ -0,0 +1,69 @@
+#ifndef RENDERSTATS_HPP
+#define RENDERSTATS_HPP
+
+#include <cstdint>
+#include <cstdio>
+
+// Per-frame, per-pass counts of what the renderer submits to GL.
+//
+// In builds with GENGINE_RENDER_STATS (Debug and RelWithDebInfo, or the CMake option),
+// install() swaps the glad entry points for draws, binds, uniform and buffer uploads with
+// counting wrappers that forward to the driver. Without it install() does nothing and only
+// the object counts that SceneManager reports are collected.
+//
+// Counts go to the open pass, or to "Other" outside of any. Passes are opened by GpuProfileScope
+// (see profiler.hpp) only when it starts a GPU query, so they match the profiler's GPU passes.
+// Main thread only, like the GL context. Pass names must outlive the frame (string literals).
+class RenderStats {
+public:
+    static const int MAX_PASSES = 16;
+
+    struct Counters {
+        uint32_t drawCalls;
+        uint64_t triangles;
+        uint32_t instances;         // 1 per plain draw, the instance count for instanced ones
+        uint32_t programBinds;
+        uint32_t vaoBinds;
+        uint32_t textureBinds;
+        uint32_t fboBinds;
+        uint32_t uniformUploads;
+        uint64_t bufferBytes;       // glBufferData + glBufferSubData
+        uint32_t objectsDrawn;
+        uint32_t objectsCulled;
+
+        void add(const Counters& other);
+    };
+
+    struct Pass {
+        const char* name;
+        Counters counters;
+    };
+
+    struct Frame {
+        uint64_t index;
+        Counters total;
+        Pass passes[MAX_PASSES];    // passes[0] is "Other"
+        int passCount;
+    };
+
+    // After gladLoadGL. True if GL calls are being counted.
+    static bool install();
+    static void uninstall();
+    static bool installed();
+
+    // Index for endPass, -1 if there was no room.
+    static int beginPass(const char* name);
+    static void endPass(int pass);
+
+    static void countObjects(uint32_t drawn, uint32_t culled);
+
+    // Main thread, once per frame after the last GL call.
+    static void endFrame();
+    static const Frame& lastFrame();
+
+    // Table of the last frame's passes.
+    static void dump(FILE* out);
+    static void drawWindow(bool* open);
+};
+
+#endif
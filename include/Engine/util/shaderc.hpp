@@ -1,17 +1,82 @@
 #ifndef SHADERC_H
 #define SHADERC_H
 
+#include <cstdint>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <utility>
+#include <vector>
 #include "glad/glad.h"
 
+// #define NAME VALUE lines for one shader variant. The order they are set in does not matter.
+struct ShaderDefines {
+    std::vector<std::pair<std::string, std::string> > values;
+
+    ShaderDefines& set(const std::string& name, const std::string& value = "1");
+    ShaderDefines& set(const std::string& name, int value);
+    // "A=1;B=4", sorted by name; part of the permutation key.
+    std::string key() const;
+};
+
+// Shader loading with a preprocessor and two program caches.
+//
+// Sources go through preprocess(): #include "file" is expanded (paths relative to the including
+// file, every file at most once) and the variant's defines are inserted after #version. The
+// expanded vertex + fragment text is hashed; that hash is the permutation key.
+//
+// Programs are shared through an in-memory cache keyed by that hash, so loading the same
+// variant twice links once. Programs whose driver supports glGetProgramBinary are also written
+// to the disk cache, keyed by the hash and the GL vendor/renderer/version string, and later runs
+// load the blob instead of compiling.
+//
+// Compiles are asynchronous underneath (see submit) and use the driver's compiler threads when
+// it offers KHR_parallel_shader_compile. Programs are reference counted: free every program from
+// loadShader or submit with releaseProgram, not glDeleteProgram, so the cache never hands out a
+// deleted name.
 class Shaderc {
 
 public:
+    struct Stats {
+        unsigned compiled;      // compiled and linked from source
+        unsigned memoryHits;    // served from the in-memory cache
+        unsigned diskHits;      // loaded from a program binary
+    };
+
     std::string loadShaderSource(const char* filepath);
+    // Expanded source of 'path' for the given defines; false if a file is missing.
+    bool preprocess(const char* path, const ShaderDefines& defines, std::string& out);
+
+    // Compiles and links now; 0 on failure.
     GLuint loadShader(const char* vertexPath, const char* fragmentPath);
+    GLuint loadShader(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines);
+
+    // Issues the compile and link and returns the program name right away, without asking for
+    // the result. 0 only if a source file is missing. Submit everything known up front, then
+    // check ready() (or pick a fallback with readyOr) before drawing with it.
+    GLuint submit(const char* vertexPath, const char* fragmentPath, const ShaderDefines& defines = ShaderDefines());
+    // Collects finished links; call once per frame. Never blocks when the driver has
+    // KHR_parallel_shader_compile, otherwise waits for whatever is pending.
+    static void poll();
+    // Linked and usable. Never blocks with parallel compile.
+    static bool ready(GLuint program);
+    // Compile or link failed (the log has been printed), or not a Shaderc program.
+    static bool failed(GLuint program);
+    static GLuint readyOr(GLuint wanted, GLuint fallback) { return ready(wanted) ? wanted : fallback; }
+    // Waits for one program's link.
+    static void finish(GLuint program);
+    static size_t pendingCount();
+
+    static void releaseProgram(GLuint program);
+
+    // Directory for program binaries ("shadercache" by default); empty turns the disk cache off.
+    static void setCacheDirectory(const std::string& dir);
+    static const Stats& stats();
+
+private:
+    bool preprocess(const char* path, const ShaderDefines& defines, std::string& out, std::vector<std::string>& files);
+    bool expand(const std::string& path, std::vector<std::string>& included, std::string& out, int& lineShift);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,42 @@
+#ifndef STRINGTABLE_HPP
+#define STRINGTABLE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Interned string id. Equal strings get the same id, so comparing or hashing one is an
+// integer operation. 0 is always the empty string.
+typedef uint32_t StringId;
+
+// Process-wide string interner for object names, types and tags. Strings are never freed,
+// so intern only names that are reused (not per-frame generated text). Thread-safe.
+class StringTable {
+public:
+    static const StringId NONE = 0;
+    static const StringId NOT_FOUND = 0xFFFFFFFFu;
+
+    StringTable();
+
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+
+    StringId intern(const std::string& s);
+    // Lookup without inserting; NOT_FOUND if s was never interned.
+    StringId find(const std::string& s) const;
+    // The returned reference stays valid for the life of the table.
+    const std::string& str(StringId id) const;
+
+    size_t size() const;
+
+    static StringTable& global();
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, StringId> ids;
+    std::deque<std::string> strings;    // deque: push_back keeps references stable
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads for CPU-only work (mesh generation, image decoding,
+// serialization). Jobs must not touch GL; the context stays on the main thread.
+class ThreadPool {
+public:
+    // threadCount 0 = one worker per hardware thread, leaving one for the main thread.
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue slots are reused, so submitting allocates nothing once the queue has grown to
+    // its working size, provided the job fits std::function's small buffer (capture no more
+    // than two pointers).
+    void submit(const std::function<void()>& job);
+
+    // Blocks until every submitted job has finished.
+    void wait();
+
+    unsigned int size() const { return (unsigned int)workers.size(); }
+
+    // Process-wide pool shared by engine systems.
+    static ThreadPool& shared();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::vector<std::function<void()>> jobs;  // ring buffer, grows when full
+    size_t jobHead;
+    size_t jobCount;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable jobsDone;
+    unsigned int pending; // queued + running
+    bool stopping;
+};
+
+#endif
@@ -0,0 +1,16 @@
+uniform sampler2D uTexture;
+uniform bool useTexture;
+uniform vec3 overrideColor;
+uniform int useOverrideColor;
+
+// Vertex color, or the texture when one is bound; an override color wins over both.
+vec3 baseColor(vec3 vertexColor, vec2 uv) {
+    vec3 color = vertexColor;
+    if (useTexture) {
+        color = texture2D(uTexture, uv).rgb;
+    }
+    if (useOverrideColor == 1) {
+        color = overrideColor;
+    }
+    return color;
+}
@@ -5,13 +5,15 @@ varying vec3 Color;
 varying vec3 Normal;
 varying vec2 TexCoord;
 
-uniform sampler2D uTexture;
-uniform bool useTexture;
-uniform vec3 overrideColor;
-uniform int useOverrideColor;
+#include "common/base_color.glsl"
 
-const int MAX_DIR_LIGHTS = 4;
-const int MAX_POINT_LIGHTS = 4;
+// Variants can override these with Shaderc defines.
+#ifndef MAX_DIR_LIGHTS
+#define MAX_DIR_LIGHTS 4
+#endif
+#ifndef MAX_POINT_LIGHTS
+#define MAX_POINT_LIGHTS 4
+#endif
 
 uniform int uNumDirLights;
 uniform vec3 dirLightDirs[MAX_DIR_LIGHTS];
@@ -23,15 +25,38 @@ uniform vec3 pointLightPositions[MAX_POINT_LIGHTS];
 uniform vec3 pointLightColors[MAX_POINT_LIGHTS];
 uniform float pointLightIntensities[MAX_POINT_LIGHTS];
 
-const int MAX_DIR_SHADOWS = 4;
-uniform sampler2D shadowMap[MAX_DIR_SHADOWS];
+#ifndef MAX_DIR_SHADOWS
+#define MAX_DIR_SHADOWS 4
+#endif
+// depth textures with GL_TEXTURE_COMPARE_MODE: each shadow2D tap is a bilinear 2x2 PCF
+uniform sampler2DShadow shadowMap[MAX_DIR_SHADOWS];
 uniform mat4 lightSpaceMatrix[MAX_DIR_SHADOWS];
 uniform float uShadowMapSize; // e.g. 2048.0
+// Shadow::Quality: 0 = 1 tap, 1 = 4-tap Poisson, 2 = 3x3, 3 = rotated 8-tap Poisson.
+// A SHADOW_KERNEL define bakes it in and drops the untaken branches.
+#ifdef SHADOW_KERNEL
+#define uShadowKernel SHADOW_KERNEL
+#else
+uniform int uShadowKernel;
+#endif
 uniform float uShadowCullHeight[MAX_DIR_SHADOWS]; // added: per-shadow cull height
 
+// point light i: cube map of distance / pointShadowFar[i] to the closest caster; far 0 = no shadow
+uniform samplerCube pointShadowMap[MAX_POINT_LIGHTS];
+uniform float pointShadowFar[MAX_POINT_LIGHTS];
+// where the map was rendered from; trails a moving light while its next map is built
+uniform vec3 pointShadowPos[MAX_POINT_LIGHTS];
+
 varying vec3 FragPosWorld;
 varying vec3 NormalWorld;
 
+const vec2 POISSON[8] = vec2[8](
+    vec2(-0.94201624, -0.39906216), vec2( 0.94558609, -0.76890725),
+    vec2(-0.09418410, -0.92938870), vec2( 0.34495938,  0.29387760),
+    vec2(-0.91588581,  0.45771432), vec2(-0.81544232, -0.87912464),
+    vec2(-0.38277543,  0.27676845), vec2( 0.97484398,  0.75648379)
+);
+
 float sampleShadow(int idx, vec3 normal, vec4 worldPosLightSpace) {
     // Cull shadow sampling for fragments above configured height for this shadow (e.g. very high objects)
     if (idx >= 0 && idx < MAX_DIR_SHADOWS) {
@@ -43,35 +68,61 @@ float sampleShadow(int idx, vec3 normal, vec4 worldPosLightSpace) {
     vec3 proj = worldPosLightSpace.xyz / worldPosLightSpace.w;
     proj = proj * 0.5 + 0.5;
     if (proj.x < 0.0 || proj.x > 1.0 || proj.y < 0.0 || proj.y > 1.0) return 0.0;
-    float currentDepth = proj.z;
     float bias = max(0.005 * (1.0 - dot(normalize(normal), vec3(0,0,1))), 0.0005);
-    float shadow = 0.0;
+    float ref = proj.z - bias;
     float texel = 1.0 / uShadowMapSize;
-    for (int x=-1; x<=1; ++x) {
-        for (int y=-1; y<=1; ++y) {
-            vec2 offs = vec2(float(x), float(y)) * texel;
-            float depth = texture2D(shadowMap[idx], proj.xy + offs).r;
-            if (currentDepth - bias > depth) shadow += 1.0;
+    float lit = 0.0;
+
+    if (uShadowKernel == 0) {
+        lit = shadow2D(shadowMap[idx], vec3(proj.xy, ref)).r;
+    } else if (uShadowKernel == 2) {
+        for (int x=-1; x<=1; ++x) {
+            for (int y=-1; y<=1; ++y) {
+                vec2 offs = vec2(float(x), float(y)) * texel;
+                lit += shadow2D(shadowMap[idx], vec3(proj.xy + offs, ref)).r;
+            }
+        }
+        lit /= 9.0;
+    } else {
+        // Poisson disk; the rotated variant turns it per pixel, trading banding for noise
+        int taps = 4;
+        float radius = 1.5 * texel;
+        mat2 rot = mat2(1.0);
+        if (uShadowKernel == 3) {
+            taps = 8;
+            radius = 2.0 * texel;
+            float a = 6.2831853 * fract(sin(dot(gl_FragCoord.xy, vec2(12.9898, 78.233))) * 43758.5453);
+            float c = cos(a);
+            float s = sin(a);
+            rot = mat2(c, s, -s, c);
+        }
+        for (int i = 0; i < 8; ++i) {
+            if (i >= taps) break;
+            vec2 offs = rot * POISSON[i] * radius;
+            lit += shadow2D(shadowMap[idx], vec3(proj.xy + offs, ref)).r;
         }
+        lit /= float(taps);
     }
-    shadow /= 9.0;
-    return shadow;
+    return 1.0 - lit;
+}
+
+float samplePointShadow(int idx, vec3 normal) {
+    float far = pointShadowFar[idx];
+    if (far <= 0.0) return 0.0;
+    vec3 toFrag = FragPosWorld - pointShadowPos[idx];
+    float current = length(toFrag);
+    if (current >= far) return 0.0;
+    float closest = textureCube(pointShadowMap[idx], toFrag).r * far;
+    // slope-scaled bias, in world units
+    float bias = max(0.05 * (1.0 - dot(normalize(normal), normalize(-toFrag))), 0.01) + 0.002 * far;
+    return (current - bias > closest) ? 1.0 : 0.0;
 }
 
 void main() {
     vec3 norm = normalize(Normal);
     vec3 result = vec3(0.0);
 
-    // Get base color (from texture OR from vertex color)
-    vec3 baseColor = Color;
-    if (useTexture) {
-        baseColor = texture2D(uTexture, TexCoord).rgb;
-    }
-
-    // If an override color is requested, use it as the base color (ignores textures and vertex colors)
-    if (useOverrideColor == 1) {
-        baseColor = overrideColor;
-    }
+    vec3 albedo = baseColor(Color, TexCoord);
 
     // Directional lights
     for(int i = 0; i < MAX_DIR_LIGHTS; ++i) {
@@ -84,17 +135,18 @@ void main() {
             vec4 fragLS = lightSpaceMatrix[i] * vec4(FragPosWorld, 1.0);
             sh = sampleShadow(i, NormalWorld, fragLS);
         }
-        result += (1.0 - sh) * intensity * dirLightColors[i] * baseColor;
+        result += (1.0 - sh) * intensity * dirLightColors[i] * albedo;
     }
 
-    // Point lights (no shadow sampling here)
+    // Point lights
     for(int i = 0; i < MAX_POINT_LIGHTS; ++i) {
         if (i >= uNumPointLights) break;
         vec3 lightDir = normalize(pointLightPositions[i] - FragPos);
         float diff = max(dot(norm, lightDir), 0.0);
         float distance = length(pointLightPositions[i] - FragPos);
         float attenuation = 1.0 / (distance * distance);
-        result += (0.1 + diff * pointLightIntensities[i] * attenuation) * pointLightColors[i] * baseColor;
+        float sh = samplePointShadow(i, NormalWorld);
+        result += (0.1 + (1.0 - sh) * diff * pointLightIntensities[i] * attenuation) * pointLightColors[i] * albedo;
     }
 
     gl_FragColor = vec4(result, 1.0);
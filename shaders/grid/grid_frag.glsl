@@ -0,0 +1,60 @@
+#version 330 core
+// Analytic grid on the y = 0 plane. Line width comes from screen-space derivatives, so lines
+// stay about a pixel wide at any distance; the cell size steps by 10x as cells shrink on
+// screen, cross-fading between levels, which keeps the far field from aliasing.
+in vec3 vNear;
+in vec3 vFar;
+
+uniform mat4 uViewProj;
+uniform vec3 uCameraPos;
+uniform float uSpacing;      // smallest cell, world units
+uniform float uFadeDistance; // lines are gone at this distance from the camera
+
+out vec4 FragColor;
+
+const float MIN_PIXELS = 8.0; // smallest on-screen cell before switching to the next level
+
+float gridLines(vec2 coord) {
+    vec2 d = max(fwidth(coord), vec2(1e-6));
+    vec2 g = abs(fract(coord - 0.5) - 0.5) / d;
+    return 1.0 - min(min(g.x, g.y), 1.0);
+}
+
+float axisLine(float coord) {
+    return 1.0 - min(abs(coord) / max(fwidth(coord), 1e-6), 1.0);
+}
+
+void main()
+{
+    float denom = vFar.y - vNear.y;
+    float t = abs(denom) > 1e-6 ? -vNear.y / denom : -1.0;
+    if (t <= 0.0 || t > 1.0) discard;
+    vec3 pos = vNear + t * (vFar - vNear);
+
+    vec4 clip = uViewProj * vec4(pos, 1.0);
+    gl_FragDepth = clip.z / clip.w * 0.5 + 0.5;
+
+    float pixelSize = max(length(fwidth(pos.xz)), 1e-6);
+    float lod = max(0.0, log(pixelSize * MIN_PIXELS / uSpacing) / log(10.0));
+    float lodFade = fract(lod);
+    float cell0 = uSpacing * pow(10.0, floor(lod));
+    float cell1 = cell0 * 10.0;
+    float cell2 = cell1 * 10.0;
+
+    // level 0 fades out while level 1 takes over its weight, so nothing pops between levels
+    float alpha = max(max(gridLines(pos.xz / cell0) * 0.3 * (1.0 - lodFade),
+                          gridLines(pos.xz / cell1) * mix(0.6, 0.3, lodFade)),
+                      gridLines(pos.xz / cell2) * 0.6);
+    vec3 color = vec3(0.55);
+
+    float xAxis = axisLine(pos.z);
+    float zAxis = axisLine(pos.x);
+    if (xAxis > 0.0) { color = mix(color, vec3(0.9, 0.2, 0.2), xAxis); alpha = max(alpha, xAxis); }
+    if (zAxis > 0.0) { color = mix(color, vec3(0.2, 0.3, 0.9), zAxis); alpha = max(alpha, zAxis); }
+
+    float dist = length(pos.xz - uCameraPos.xz);
+    alpha *= 1.0 - smoothstep(uFadeDistance * 0.25, uFadeDistance, dist);
+    if (alpha <= 0.001) discard;
+
+    FragColor = vec4(color, alpha);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+// One full-screen triangle, no vertex buffer. Each corner is unprojected to the near and far
+// planes so the fragment shader can intersect its view ray with the ground plane.
+uniform mat4 uInvViewProj;
+
+out vec3 vNear;
+out vec3 vFar;
+
+vec3 unproject(vec2 xy, float z) {
+    vec4 p = uInvViewProj * vec4(xy, z, 1.0);
+    return p.xyz / p.w;
+}
+
+void main()
+{
+    vec2 xy = vec2(gl_VertexID == 1 ? 3.0 : -1.0, gl_VertexID == 2 ? 3.0 : -1.0);
+    vNear = unproject(xy, -1.0);
+    vFar = unproject(xy, 1.0);
+    gl_Position = vec4(xy, 0.0, 1.0);
+}
@@ -0,0 +1,10 @@
+#version 330 core
+// Writes the pick ID of whatever is being drawn into the R32UI attachment.
+uniform uint uId;
+
+out uint FragId;
+
+void main()
+{
+    FragId = uId;
+}
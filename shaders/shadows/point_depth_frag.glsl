@@ -0,0 +1,11 @@
+#version 120
+varying vec3 WorldPos;
+
+uniform vec3 uLightPos;
+uniform float uFarPlane;
+
+void main()
+{
+    // linear distance to the light, so every cube face stores the same quantity
+    gl_FragDepth = length(WorldPos - uLightPos) / uFarPlane;
+}
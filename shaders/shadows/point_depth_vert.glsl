@@ -0,0 +1,13 @@
+#version 120
+attribute vec3 aPos;
+
+#include "../common/matrices.glsl"
+
+varying vec3 WorldPos;
+
+void main()
+{
+    vec4 world = model * vec4(aPos, 1.0);
+    WorldPos = world.xyz;
+    gl_Position = projection * view * world;
+}
@@ -1,9 +1,7 @@
 #version 120
 attribute vec3 aPos;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "../common/matrices.glsl"
 
 void main()
 {
@@ -5,20 +5,8 @@ varying vec3 Color;
 varying vec3 Normal;
 varying vec2 TexCoord;
 
-uniform sampler2D uTexture;
-uniform bool useTexture;
-uniform vec3 overrideColor;
-uniform int useOverrideColor;
+#include "../common/base_color.glsl"
 
 void main() {
-    vec3 baseColor = Color;
-    if (useTexture) {
-        baseColor = texture2D(uTexture, TexCoord).rgb;
-    }
-
-    if (useOverrideColor == 1) {
-        baseColor = overrideColor;
-    }
-
-    gl_FragColor = vec4(baseColor, 1.0);
+    gl_FragColor = vec4(baseColor(Color, TexCoord), 1.0);
 }
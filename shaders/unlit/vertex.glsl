@@ -10,9 +10,7 @@ varying vec3 Color;
 varying vec3 Normal;
 varying vec2 TexCoord;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "../common/matrices.glsl"
 
 void main() {
     FragPos = vec3(model * vec4(aPos,1.0));
@@ -12,9 +12,7 @@ varying vec3 Normal;
 varying vec3 NormalWorld;
 varying vec2 TexCoord;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "common/matrices.glsl"
 
 void main() {
     // world-space position
@@ -9,20 +9,24 @@ GameMain::GameMain() {
     dirLight.direction = Vec3d(-0.2f,-1.0f,-0.3f);
     scene->addLight(dirLight);
 
-    cube1 = scene->addObject("Player", "Cube_1");
-    cube1->position = Vec3d(-5.f, 0.f, 0.f);
-    cube1->texture("textures/peppa.png");
+    Object* cube = scene->addObject("Player", "Cube_1");
+    cube->position = Vec3d(-5.f, 0.f, 0.f);
+    cube->texture("textures/peppa.png");
+    cube1 = scene->handleOf(cube);
 
     // Two ways of adding objects to a scene from c++
-    sphere1 = scene->addObject("Sphere", "Player");
-    sphere1->position = Vec3d(-5.f, 0.f, 5.f);
-    sphere1->scale = Vec3d(1.f);
-    sphere1->texture("textures/yoda.png");
+    sphere1 = scene->spawnObject("Sphere", "Player");
+    Object* sphere = scene->get(sphere1);
+    sphere->position = Vec3d(-5.f, 0.f, 5.f);
+    sphere->scale = Vec3d(1.f);
+    sphere->texture("textures/yoda.png");
 
-    floor = scene->addObject("Plane", "Floor");
-    floor->position = Vec3d(0.f, -1.f, 0.f);
-    floor->scale = Vec3d(50.f);
-	floor->texture("textures/yoda2.png");
+    floor = scene->spawnObject("Plane", "Floor");
+    Object* plane = scene->get(floor);
+    plane->position = Vec3d(0.f, -1.f, 0.f);
+    plane->scale = Vec3d(50.f);
+    plane->isStatic = true;
+	plane->texture("textures/yoda2.png");
 
 
     Object* cylinder = new Object();
@@ -55,19 +59,14 @@ void GameMain::Start()
     int objCount = (int)scene->objects.size();
     printf("[GameMain] Scene has %d objects\n", objCount);
 
-    //for(int i = 0; i < objCount; i++) {
-    //    Object* obj = scene->objects[i];
-    //    if(obj->name == "Player") {
-    //        player->playerObject = obj;
-    //        break;
-    //    }
-    //}
-
-    player->playerObject = sphere1;
+    player->scene = scene;
+    // indexed lookup, does not scan the scene
+    player->playerObject = scene->findByName("Player");
+    if (!scene->isAlive(player->playerObject)) player->playerObject = sphere1;
 }
 
 void GameMain::Update(float dt)
 {
-    if (sphere1) sphere1->rotation.y += 30.f * dt;
+    if (Object* sphere = scene->get(sphere1)) sphere->rotation.y += 30.f * dt;
     player->Update(dt);
 }
\ No newline at end of file
@@ -15,10 +15,9 @@ public:
     SceneManager* scene;
     Player* player;
 
-    //Object* floor;
-    Object* cube1;
-    Object* sphere1;
-    Object* floor;
+    ObjectHandle cube1;
+    ObjectHandle sphere1;
+    ObjectHandle floor;
 };
 
 #endif
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 void Player::Update(float dt)
 {
+    Object* playerObject = getObject();
     if (!playerObject) return;
     const Uint8* state = SDL_GetKeyboardState(NULL);
     float speed = 5.0f * dt;
@@ -5,10 +5,16 @@
 
 class Player {
 public:
+    Player() : scene(nullptr) {}
+
     void Start();
     void Update(float dt);
 
-    Object* playerObject;
+    // The controlled object, or null if none is set or it has been removed.
+    Object* getObject() const { return scene ? scene->get(playerObject) : nullptr; }
+
+    SceneManager* scene;
+    ObjectHandle playerObject;
 
 };
 